@@ -0,0 +1,175 @@
+/*!
+ * @file acquire.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Non-blocking acquisition of Si7021 sensors spread over I2C1-I2C4.
+ *
+ * Each device walks through a measurement on its own: the no-hold measure
+ * command, the conversion wait, the humidity read, then the temperature
+ * from the same conversion. Every step is one transfer started with
+ * I2CReg_Start() and finished by the bus interrupt; Acquire_Poll() takes
+ * the completions off each bus's queue and starts the next step. Devices
+ * on different buses therefore convert and transfer side by side, and a
+ * cycle over N buses takes about as long as one device. Devices sharing a
+ * bus take turns, since a bus carries one transfer at a time.
+ *
+ * The conversion itself (up to ~23 ms for 12-bit RH plus 14-bit T) is
+ * spent in the sensor, so starting a cycle right before the blocking read
+ * of the primary sensor on I2C1 overlaps the two completely. The primary
+ * sensor stays on the App path; the devices here are the additional ones.
+ *
+ * A read NACKed while the sensor is still converting is retried every
+ * ACQUIRE_RETRY_MS. Timeouts run from the moment a step has something to
+ * wait for, not from the start of the cycle, so a caller that blocks
+ * between two polls (the primary read) only delays the steps: a transfer
+ * not completed ACQUIRE_TIMEOUT_MS after it was started, a read still
+ * NACKed ACQUIRE_TIMEOUT_MS past the conversion time, or any other bus
+ * error, ends the device's cycle with both values invalid.
+ *
+ * Each device has a circuit breaker (breaker.h). A failed cycle counts
+ * against it and a complete one closes it; while it is open the device
+ * sits its cycles out without using the bus, and once the backoff has
+ * passed its next cycle starts with an address-only probe, the async
+ * counterpart of HAL_I2C_IsDeviceReady(), before the measure command.
+ *
+ * Sensors behind TCA9548A multiplexers are added with Acquire_AddMuxed().
+ * Before a step's transfer Acquire_Poll() switches every other mux on the
+ * bus off and selects the device's channel, each as a transfer of its own
+ * and only where the cached control register (mux.h) differs. The device
+ * list is kept sorted by bus, mux and channel, and steps that need no
+ * switch are started first, so a channel once selected serves all the
+ * steps waiting on it: a sensor's humidity and temperature reads go out
+ * back to back, and a cycle over one mux costs one select per channel for
+ * the measure commands and one for the reads.
+ *
+ * The sensors on I2C2 (PF1 SCL, PF0 SDA), I2C3 (PA8 SCL, PC9 SDA) and I2C4
+ * (PF14 SCL, PF15 SDA) are found by the bus scan (scan.h), which adds them
+ * as they turn up. Its transfers share the buses' completion queues:
+ * Acquire_Poll() is the one reader and hands completions whose tag has
+ * ACQUIRE_TAG_FOREIGN set to the listener. Bench_Run() measures the
+ * sensors one after another and all at once (acquire.serial and
+ * acquire.concurrent); the ratio of the two is the speedup.
+ *
+ * Each device that ends a cycle leaves its reading, SAMPLE_INVALID for a
+ * failed one, for Acquire_Store() to append to the device's history: a
+ * tsdb.h store of ACQUIRE_STORE_BLOCKS blocks, about two days at 1 Hz by
+ * the tsdb.h figure. The first ACQUIRE_STORES devices added get one, the
+ * rest keep only their latest reading. A cycle skipped by an open breaker
+ * leaves a gap. The console dumps a history with DUMP S<n>.
+ */
+
+#ifndef ACQUIRE_H_
+#define ACQUIRE_H_
+
+#include "i2c_reg.h"
+#include "mux.h"
+#include "breaker.h"
+#include "sample.h"
+#include "tsdb.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef ACQUIRE_DEVICES
+#define ACQUIRE_DEVICES			64U
+#endif
+#ifndef ACQUIRE_MUXES
+#define ACQUIRE_MUXES			8U
+#endif
+#ifndef ACQUIRE_STORES
+#define ACQUIRE_STORES			16U		/**< Devices with a history **/
+#endif
+#ifndef ACQUIRE_STORE_BLOCKS
+#define ACQUIRE_STORE_BLOCKS	4U		/**< Blocks per history, TSDB_BLOCK_BYTES each **/
+#endif
+#define ACQUIRE_CONVERSION_MS	23U		/**< RH 12 bit + T 14 bit, datasheet maximum **/
+#define ACQUIRE_RETRY_MS		2U
+#define ACQUIRE_TIMEOUT_MS		10U		/**< Per transfer, and past the conversion time **/
+#define ACQUIRE_ALL				UINT64_MAX
+#define ACQUIRE_BIT(k)			((uint64_t)1 << (k))
+#define ACQUIRE_TAG_FOREIGN		0x80000000U	/**< Tag bit of transfers the acquisition did not start **/
+
+/*!
+ * @typedef Acquire_StateTypeDef refers to enum of device steps
+ */
+typedef enum {
+	ACQUIRE_IDLE,
+	ACQUIRE_PROBE,			/**< Address-only write of a half-open breaker **/
+	ACQUIRE_MEASURE,		/**< Measure command **/
+	ACQUIRE_CONVERTING,
+	ACQUIRE_HUMIDITY,		/**< Humidity code read **/
+	ACQUIRE_PREVIOUS,		/**< Read-previous-temperature command **/
+	ACQUIRE_TEMPERATURE		/**< Temperature code read **/
+} Acquire_StateTypeDef;
+
+/*!
+ * @typedef Acquire_DeviceTypeDef refers to one sensor and its latest reading
+ */
+typedef struct {
+	I2C_HandleTypeDef *hi2c;
+	uint8_t bus;			/**< 1-4 for I2C1-I2C4 **/
+	uint8_t address;		/**< 7-bit address in [7:1] **/
+	Mux_TypeDef *mux;		/**< 0 if on the bus directly **/
+	uint8_t channel;		/**< Mux channel, 0-7 **/
+	uint8_t state;			/**< Acquire_StateTypeDef **/
+	_Bool wire;				/**< The step's transfer is under way **/
+	Mux_TypeDef *switching;	/**< Mux the transfer under way writes to, 0 for the step's own **/
+	uint8_t control;		/**< Value of that write **/
+	uint8_t data[3];
+	uint32_t issued;		/**< Tick the transfer under way was started **/
+	uint32_t due;			/**< Tick the next read of the conversion may go out **/
+	uint32_t deadline;		/**< Tick the conversion is given up on **/
+	int16_t humidity;		/**< 0.01 %RH, SAMPLE_INVALID after a failed cycle **/
+	int16_t temperature;	/**< 0.01 C **/
+	_Bool fresh;			/**< A cycle ended since the last Acquire_Store() **/
+	Tsdb_TypeDef *store;	/**< History, 0 if the stores ran out **/
+	uint32_t reads;
+	uint32_t errors;
+	Breaker_TypeDef breaker;
+} Acquire_DeviceTypeDef;
+
+/*!
+ * @typedef Acquire_ListenerTypeDef refers to the handler of foreign completions
+ */
+typedef void (*Acquire_ListenerTypeDef)(void *context, I2C_HandleTypeDef *hi2c,
+		const I2CReg_CompletionTypeDef *completion);
+
+/*!
+ * @typedef Acquire_TypeDef refers to the set of devices
+ */
+typedef struct {
+	Acquire_DeviceTypeDef device[ACQUIRE_DEVICES];
+	uint8_t count;
+	I2C_HandleTypeDef *bus[I2C_REG_BUSES];	/**< Distinct buses of the devices **/
+	uint8_t buses;
+	Mux_TypeDef *mux[ACQUIRE_MUXES];
+	uint8_t muxes;
+	_Bool active;			/**< A cycle is running **/
+	uint64_t pending;		/**< Devices waiting to start, bit per device **/
+	uint32_t start;			/**< DWT stamp of Acquire_Start **/
+	uint32_t cycles;		/**< Length of the last cycle **/
+	Acquire_ListenerTypeDef listener;
+	void *context;
+	Tsdb_TypeDef store[ACQUIRE_STORES];
+	Tsdb_BlockTypeDef storeBlock[ACQUIRE_STORES][ACQUIRE_STORE_BLOCKS];
+	uint8_t stores;			/**< Stores handed out **/
+} Acquire_TypeDef;
+
+extern Acquire_TypeDef acquire;
+
+/*!
+ * Function prototypes
+ */
+void Acquire_Init(Acquire_TypeDef *a);
+_Bool Acquire_AddBus(Acquire_TypeDef *a, I2C_HandleTypeDef *hi2c);
+void Acquire_SetListener(Acquire_TypeDef *a, Acquire_ListenerTypeDef listener, void *context);
+_Bool Acquire_Add(Acquire_TypeDef *a, I2C_HandleTypeDef *hi2c, uint8_t address);
+_Bool Acquire_AddMuxed(Acquire_TypeDef *a, Mux_TypeDef *mux, uint8_t channel, uint8_t address);
+void Acquire_Start(Acquire_TypeDef *a, uint64_t mask);
+_Bool Acquire_Poll(Acquire_TypeDef *a);
+uint32_t Acquire_Store(Acquire_TypeDef *a, uint32_t time);
+
+#endif /* ACQUIRE_H_ */
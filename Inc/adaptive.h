@@ -0,0 +1,84 @@
+/*!
+ * @file adaptive.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Adaptive sampling period. After each sample the controller looks at how
+ * fast each channel is moving and how much it scatters, and picks the time
+ * to the next sample:
+ *
+ *  - active (rate or deviation above its threshold on either channel):
+ *    drop straight to the minimum period, so a door opening is followed
+ *    from the next sample on;
+ *  - quiet for ADAPTIVE_QUIET samples in a row: double the period, up to
+ *    the maximum.
+ *
+ * Rate is |change| / elapsed time between consecutive samples; deviation is
+ * the square root of an EMA (1/8) of squared distance from an EMA mean.
+ * Both are in the channel's 0.01 units and work best on filtered values.
+ *
+ * The scheduler (SysTick in main.c, the tick loop in the simulator) reads
+ * the period back and fires the next sample that long after the last one.
+ * Adaptive_TypeDef counts samples taken against those a fixed
+ * ADAPTIVE_REFERENCE_MS cadence would have taken over the same time; each
+ * sample is 8 I2C transfers, so the saving in bus traffic is the same
+ * fraction.
+ */
+
+#ifndef ADAPTIVE_H_
+#define ADAPTIVE_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef ADAPTIVE_MIN_MS
+#define ADAPTIVE_MIN_MS			250U
+#endif
+#ifndef ADAPTIVE_MAX_MS
+#define ADAPTIVE_MAX_MS			8000U
+#endif
+#ifndef ADAPTIVE_QUIET
+#define ADAPTIVE_QUIET			4U		/**< Quiet samples per doubling **/
+#endif
+#define ADAPTIVE_REFERENCE_MS	500U	/**< Fixed cadence being replaced **/
+
+/*!
+ * @typedef Adaptive_ConfigTypeDef refers to controller settings
+ *
+ * Thresholds are per channel, humidity first, in 0.01 units.
+ */
+typedef struct {
+	uint32_t minPeriod;			/**< ms **/
+	uint32_t maxPeriod;			/**< ms **/
+	uint16_t rate[2];			/**< Change per second that counts as active **/
+	uint16_t deviation[2];		/**< Scatter that counts as active **/
+} Adaptive_ConfigTypeDef;
+
+/*!
+ * @typedef Adaptive_TypeDef refers to the controller
+ */
+typedef struct {
+	Adaptive_ConfigTypeDef config;
+	uint32_t period;			/**< ms to the next sample **/
+	uint32_t quiet;				/**< Quiet samples since the last change **/
+	uint32_t first;				/**< ms of the first sample **/
+	uint32_t last;				/**< ms of the latest sample **/
+	uint32_t samples;
+	int16_t previous[2];
+	int32_t mean[2];			/**< 1/256 of 0.01 units **/
+	uint32_t variance[2];		/**< 0.01 units squared **/
+} Adaptive_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Adaptive_Init(Adaptive_TypeDef *a, const Adaptive_ConfigTypeDef *config);
+uint32_t Adaptive_Update(Adaptive_TypeDef *a, const Sample_TypeDef *sample, uint32_t now);
+uint32_t Adaptive_Fixed(const Adaptive_TypeDef *a);
+
+#endif /* ADAPTIVE_H_ */
@@ -0,0 +1,79 @@
+/*!
+ * @file alarm.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Threshold alarm with hysteresis, driving one GPIO line.
+ *
+ * Each channel has a low and a high threshold. A channel goes into alarm
+ * when it reaches either one and leaves it only once it is back inside by
+ * the hysteresis, so a reading sitting on a threshold does not make the
+ * line chatter. The output is high while any channel is in alarm.
+ *
+ * Alarm_Check() runs from the Si7021 conversion callback (si7021.h), right
+ * after the result bytes arrive and before anything is converted to float.
+ * Thresholds are turned into raw sensor codes once, when they are set, so
+ * the check is a few integer compares and one BSRR write. Latency is
+ * measured in DWT cycles from the last result byte arriving to the BSRR
+ * write: the stamp is taken at the last RXNE on the register path, and at
+ * the STOP that ends the read through the HAL or in the register path's DMA
+ * mode. The worst case is kept; ALARM on the console reports it.
+ */
+
+#ifndef ALARM_H_
+#define ALARM_H_
+
+#include <stdint.h>
+#include "si7021.h"
+
+#define ALARM_CHANNELS		2U		/**< Si_ChannelTypeDef values **/
+
+#define ALARM_LOW			0x01U	/**< Channel is at or below its low threshold **/
+#define ALARM_HIGH			0x02U	/**< Channel is at or above its high threshold **/
+
+/*!
+ * @typedef Alarm_ConfigTypeDef refers to one channel's thresholds
+ *
+ * Values are in 0.01 units. low == high disables the channel.
+ */
+typedef struct {
+	int16_t low;
+	int16_t high;
+	uint16_t hysteresis;
+} Alarm_ConfigTypeDef;
+
+/*!
+ * @typedef Alarm_LimitsTypeDef refers to thresholds as raw sensor codes
+ */
+typedef struct {
+	uint16_t lowOn;
+	uint16_t lowOff;
+	uint16_t highOn;
+	uint16_t highOff;
+	_Bool enabled;
+} Alarm_LimitsTypeDef;
+
+/*!
+ * @typedef Alarm_TypeDef refers to the alarm and its output line
+ */
+typedef struct {
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	Alarm_ConfigTypeDef config[ALARM_CHANNELS];
+	Alarm_LimitsTypeDef limits[ALARM_CHANNELS];
+	uint8_t state[ALARM_CHANNELS];		/**< ALARM_LOW/ALARM_HIGH bits **/
+	uint32_t raised[ALARM_CHANNELS];	/**< Times the channel went into alarm **/
+	uint32_t checks;
+	uint32_t worst;						/**< Longest data-to-pin latency, cycles **/
+} Alarm_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Alarm_Init(Alarm_TypeDef *a, GPIO_TypeDef *port, uint16_t pin);
+void Alarm_Configure(Alarm_TypeDef *a, Si_ChannelTypeDef channel, const Alarm_ConfigTypeDef *config);
+void Alarm_Check(Alarm_TypeDef *a, Si_ChannelTypeDef channel, uint16_t code, uint32_t stamp);
+
+#endif /* ALARM_H_ */
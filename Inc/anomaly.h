@@ -0,0 +1,90 @@
+/*!
+ * @file anomaly.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Online anomaly detection for one sensor channel, constant memory and a
+ * handful of integer operations per sample. Anomaly_Check() returns the
+ * SAMPLE_* status bits of each raw reading:
+ *
+ *  - SAMPLE_FAILED: the read failed (SAMPLE_INVALID).
+ *  - SAMPLE_RANGE: outside [min, max]. The Si7021 may report a little below
+ *    0 or above 100 %RH near the ends, so the default humidity range has a
+ *    margin.
+ *  - SAMPLE_SPIKE: more than spike away from the last accepted value. A
+ *    jump is taken as a real step once the next sample lands within spike
+ *    of it; otherwise it was a glitch and the old level stands.
+ *  - SAMPLE_RATE: the smoothed slope (EMA, 1/8 per sample) exceeds rate per
+ *    second. The slope is taken over the milliseconds between samples, so
+ *    it holds at any sampling period. The Si7021 response time (tau 18 s
+ *    RH, 5-10 s temperature) bounds how fast a healthy part can move.
+ *  - SAMPLE_STUCK: the same value stuck times in a row. Runs of equal codes
+ *    are normal at low resolution in a steady room; raise stuck for
+ *    RES_H8T12.
+ *  - SAMPLE_DRIFT: a fast baseline (EMA, time constant 32 s) is more than
+ *    drift away from a slow one (time constant 34 minutes). Both are
+ *    weighted by the time between samples.
+ *
+ * Bits in ANOMALY_REJECT mark readings that are not fit to keep; the
+ * application stores and reports those channels as SAMPLE_INVALID. Drift is
+ * a warning only: the value is kept and flagged.
+ *
+ * Run the detector on raw readings, before any smoothing, or the filter
+ * will hide spikes and manufacture stuck values.
+ */
+
+#ifndef ANOMALY_H_
+#define ANOMALY_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef ANOMALY_REJECT
+#define ANOMALY_REJECT	(SAMPLE_FAILED | SAMPLE_RANGE | SAMPLE_SPIKE | SAMPLE_RATE | SAMPLE_STUCK)
+#endif
+
+#define ANOMALY_KINDS	6U		/**< One counter per SAMPLE_* bit **/
+
+/*!
+ * @typedef Anomaly_ConfigTypeDef refers to the limits of one channel
+ *
+ * Values are in the channel's 0.01 units; 0 disables a check.
+ */
+typedef struct {
+	int16_t min;
+	int16_t max;
+	uint16_t spike;		/**< Largest step between two samples **/
+	uint16_t rate;		/**< Largest smoothed change per second **/
+	uint16_t drift;		/**< Largest fast/slow baseline gap **/
+	uint16_t stuck;		/**< Equal samples in a row before flagging **/
+} Anomaly_ConfigTypeDef;
+
+/*!
+ * @typedef Anomaly_TypeDef refers to one channel's detector
+ */
+typedef struct {
+	Anomaly_ConfigTypeDef config;
+	uint32_t seen;				/**< Valid samples checked **/
+	uint32_t time;				/**< HAL tick of the last accepted value, ms **/
+	int16_t last;				/**< Last accepted value **/
+	int16_t previous;			/**< Raw value of the previous sample **/
+	uint16_t repeats;			/**< Samples equal to previous **/
+	_Bool jumped;				/**< previous was a spike **/
+	int32_t slope;				/**< 0.01 units/s in 1/256 **/
+	int32_t fast;				/**< Baselines in 1/256 of 0.01 units **/
+	int32_t slow;
+	uint32_t flagged[ANOMALY_KINDS];	/**< Samples per SAMPLE_* bit **/
+} Anomaly_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Anomaly_Init(Anomaly_TypeDef *a, const Anomaly_ConfigTypeDef *config);
+uint8_t Anomaly_Check(Anomaly_TypeDef *a, uint32_t now, int16_t value);
+
+#endif /* ANOMALY_H_ */
@@ -0,0 +1,88 @@
+/*!
+ * @file app.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Application sampling loop, kept free of clock, GPIO and interrupt setup so
+ * it links unchanged against the host simulator in Sim/. main() owns the
+ * hardware and calls into here.
+ */
+
+#ifndef APP_H_
+#define APP_H_
+
+#include "main.h"
+#include "si7021.h"
+#include "sample.h"
+#include "tsdb.h"
+#include "rollup.h"
+#include "filter.h"
+#include "psychro.h"
+#include "anomaly.h"
+#include "adaptive.h"
+#include "report.h"
+#include "window.h"
+#include "quantile.h"
+#include "alarm.h"
+#include "control.h"
+
+#define APP_REPORT_MAX		288U	/**< Longest report of one sample, window summary included **/
+
+/*!
+ * @typedef App_ChannelTypeDef refers to enum of sensor channels
+ */
+typedef enum {
+	APP_HUMIDITY,
+	APP_TEMPERATURE,
+	APP_CHANNELS
+} App_ChannelTypeDef;
+
+/*!
+ * @typedef App_ConfigTypeDef refers to settings kept across resets
+ */
+typedef struct {
+	uint8_t heater;			/**< Heater status -- 0:off, 1:on **/
+	uint8_t heaterLevel;	/**< 0-15, lowest-highest **/
+	uint8_t resolution;		/**< Si_ResolutionTypeDef **/
+	uint8_t reserved;
+	Filter_ConfigTypeDef filter[APP_CHANNELS];
+	Report_ConfigTypeDef report[APP_CHANNELS];
+	uint16_t window;		/**< Summary window in seconds, 0:off **/
+	Alarm_ConfigTypeDef alarm[APP_CHANNELS];
+	Control_ConfigTypeDef control;
+} App_ConfigTypeDef;
+
+extern Si7021_TypeDef sensor;
+extern Tsdb_TypeDef history;
+extern Rollup_TypeDef rollup;
+
+/*!
+ * Function prototypes
+ */
+void App_Init(I2C_HandleTypeDef *hi2c);
+void App_Restore(const App_ConfigTypeDef *saved, uint32_t time);
+void App_Replay(const Sample_TypeDef *sample);
+void App_Sample(void);
+uint16_t App_Control(uint32_t stamp);
+uint32_t App_Time(void);
+const App_ConfigTypeDef *App_Config(void);
+const Sample_TypeDef *App_LastSample(void);
+const Psychro_TypeDef *App_LastDerived(void);
+const Anomaly_TypeDef *App_Anomaly(App_ChannelTypeDef channel);
+const Adaptive_TypeDef *App_Cadence(void);
+const Report_TypeDef *App_Report(App_ChannelTypeDef channel);
+const Window_SummaryTypeDef *App_Window(void);
+const Quantile_TypeDef *App_Quantile(App_ChannelTypeDef channel);
+const Alarm_TypeDef *App_Alarm(void);
+const Control_TypeDef *App_Controller(void);
+void App_SetReport(_Bool on);
+_Bool App_ToggleHeater(void);
+void App_SetFilter(App_ChannelTypeDef channel, const Filter_ConfigTypeDef *filter);
+void App_SetReportPolicy(App_ChannelTypeDef channel, const Report_ConfigTypeDef *policy);
+void App_SetWindow(uint16_t seconds);
+void App_SetAlarm(App_ChannelTypeDef channel, const Alarm_ConfigTypeDef *thresholds);
+void App_SetControl(const Control_ConfigTypeDef *settings);
+
+#endif /* APP_H_ */
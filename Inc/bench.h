@@ -0,0 +1,38 @@
+/*!
+ * @file bench.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * On-target benchmark battery. Built in with BENCH_AT_BOOT=1 (e.g.
+ * -DBENCH_AT_BOOT=1 in the project's preprocessor settings), main() runs it
+ * once after the sensor is up and before sampling starts. Each item is timed
+ * with the DWT cycle counter and reported over UART as cycles/op next to a
+ * stored baseline, so flash wait states, cache settings and HAL overhead on
+ * the real part show up as a percentage change.
+ *
+ * Output, one line per item:
+ *   BENCH <name> <cycles/op> base <baseline> <delta>%
+ * then one line per pair of items that do the same work two ways (HAL vs
+ * register-level I2C, sensors one after another vs all buses at once):
+ *   BENCH vs <name> <cycles/op> <name> <cycles/op> saved <cycles> <percent>%
+ * followed by a C initializer line that can be pasted into the baseline
+ * table in bench.c once a run has been accepted.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "si7021.h"
+
+#ifndef BENCH_AT_BOOT
+#define BENCH_AT_BOOT	0
+#endif
+
+/*!
+ * Function prototypes
+ */
+void Bench_Run(Si7021_TypeDef *si7021, UART_HandleTypeDef *huart);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,94 @@
+/*!
+ * @file bkp_state.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Live state kept in the 4 KB backup SRAM (0x40024000) so that a reset --
+ * watchdog, fault, NRST, software -- picks up where it left off. Only a
+ * power loss without VBAT clears it.
+ *
+ * The state is the application configuration, cumulative driver statistics
+ * and the last BKP_STATE_TAIL samples. A RAM copy (bkpState) is changed by
+ * BkpState_Sample() and BkpState_Config(); BkpState_Commit() then writes it
+ * to the older of two slots, so a reset in the middle of a write leaves the
+ * other slot intact. Commits happen only after a change, and cost a ~600
+ * byte copy plus a pass through the hardware CRC unit, a few microseconds.
+ *
+ * Slot layout (little-endian):
+ *  _____________________________________________________
+ * | Offset | Size | Field                                |
+ * |________|______|______________________________________|
+ * |   0    |  4   | magic (BKP_STATE_MAGIC)              |
+ * |   4    |  4   | CRC-32 (CRC unit) of bytes 8 .. end  |
+ * |   8    |  4   | sequence number, +1 per commit       |
+ * |  12    |  2   | version (BKP_STATE_VERSION)          |
+ * |  14    |  2   | size of the slot in bytes            |
+ * |  16    | ...  | BkpState_TypeDef from time onwards   |
+ * |________|______|______________________________________|
+ *
+ * On boot, BkpState_Init() validates both slots and loads the newer one
+ * (a few microseconds); BkpState_Restore() then hands the configuration and
+ * the sample tail back to the application once the sensor is up. Sample
+ * times carry on from the newest saved sample, so the RAM store and the
+ * rollups see one continuous time line across the reset.
+ */
+
+#ifndef BKP_STATE_H_
+#define BKP_STATE_H_
+
+#include <stdint.h>
+#include "app.h"
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef BKP_STATE_TAIL
+#define BKP_STATE_TAIL			64U		/**< Samples kept, one per second **/
+#endif
+
+#define BKP_STATE_MAGIC			0x54534B42U	/**< "BKST" little-endian **/
+#define BKP_STATE_VERSION		7U
+#define BKP_STATE_SLOTS			2U
+
+/*!
+ * @typedef BkpState_StatsTypeDef refers to counters kept across resets
+ */
+typedef struct {
+	uint32_t restores;		/**< Boots that found a valid state **/
+	uint32_t samples;		/**< Samples taken **/
+	uint32_t readErrors;	/**< Samples with a failed or rejected channel **/
+	uint32_t i2cTransfers;	/**< I2C transfers issued **/
+	uint32_t resetFlags;	/**< RCC_CSR of the latest boot **/
+} BkpState_StatsTypeDef;
+
+/*!
+ * @typedef BkpState_TypeDef refers to one slot of saved state
+ */
+typedef struct {
+	uint32_t magic;
+	uint32_t crc;
+	uint32_t seq;
+	uint16_t version;
+	uint16_t size;
+	uint32_t time;					/**< Time of the newest sample **/
+	App_ConfigTypeDef config;
+	BkpState_StatsTypeDef stats;
+	uint32_t tailCount;				/**< Samples ever added, index = count % TAIL **/
+	Sample_TypeDef tail[BKP_STATE_TAIL];
+} BkpState_TypeDef;
+
+extern BkpState_TypeDef bkpState;
+
+/*!
+ * Function prototypes
+ */
+_Bool BkpState_Init(void);
+void BkpState_Restore(void);
+void BkpState_Sample(const Sample_TypeDef *sample);
+void BkpState_Config(const App_ConfigTypeDef *config);
+void BkpState_Commit(void);
+
+#endif /* BKP_STATE_H_ */
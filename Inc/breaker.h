@@ -0,0 +1,71 @@
+/*!
+ * @file breaker.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Per-device circuit breaker for I2C sensors.
+ *
+ * A sensor that has stopped answering costs a transfer timeout on every
+ * attempt, and a bus stall up to the full timeout, which comes out of the
+ * time budget of the healthy devices. The breaker tracks each device:
+ *  - closed: transfers go ahead; BREAKER_THRESHOLD failures in a row open it;
+ *  - open: attempts are refused without touching the bus until the backoff
+ *    interval has passed, then the breaker goes half-open;
+ *  - half-open: the caller sends one cheap probe (an address-only transfer)
+ *    followed by the real transfer; success closes the breaker, failure
+ *    opens it again for twice the interval, up to BREAKER_BACKOFF_MAX_MS.
+ *
+ * The breaker does no I/O itself. Callers ask Breaker_Allow() before an
+ * attempt and report the outcome with Breaker_Success()/Breaker_Failure().
+ */
+
+#ifndef BREAKER_H_
+#define BREAKER_H_
+
+#include <stdint.h>
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef BREAKER_THRESHOLD
+#define BREAKER_THRESHOLD		3U		/**< Consecutive failures that open the breaker **/
+#endif
+#ifndef BREAKER_BACKOFF_MS
+#define BREAKER_BACKOFF_MS		1000U	/**< First open interval **/
+#endif
+#ifndef BREAKER_BACKOFF_MAX_MS
+#define BREAKER_BACKOFF_MAX_MS	64000U
+#endif
+
+/*!
+ * @typedef Breaker_StateTypeDef refers to enum of breaker states
+ */
+typedef enum {
+	BREAKER_CLOSED,
+	BREAKER_OPEN,
+	BREAKER_HALF_OPEN
+} Breaker_StateTypeDef;
+
+/*!
+ * @typedef Breaker_TypeDef refers to the health of one device
+ */
+typedef struct {
+	uint8_t state;			/**< Breaker_StateTypeDef **/
+	uint8_t failures;		/**< In a row, while closed **/
+	uint32_t backoff;		/**< Length of the current open interval, ms **/
+	uint32_t until;			/**< Tick the open interval ends **/
+	uint32_t trips;			/**< Times opened **/
+	uint32_t skipped;		/**< Attempts refused while open **/
+} Breaker_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Breaker_Init(Breaker_TypeDef *b);
+_Bool Breaker_Allow(Breaker_TypeDef *b, uint32_t now);
+void Breaker_Success(Breaker_TypeDef *b);
+void Breaker_Failure(Breaker_TypeDef *b, uint32_t now);
+
+#endif /* BREAKER_H_ */
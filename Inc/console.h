@@ -0,0 +1,56 @@
+/*!
+ * @file console.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Line-oriented command console on UART4 with non-blocking DMA output.
+ *
+ * Received bytes arrive as EVENT_UART_RX events and are fed to
+ * Console_Input() from the main loop; a CR or LF ends a line, which is split
+ * on spaces and dispatched by its first word (case-insensitive) through the
+ * command table in console.c.
+ *
+ * Output is copied into a ring and sent by DMA1 Stream 4 from
+ * Console_Poll(), one contiguous segment at a time, so writers never wait
+ * for the 9600 baud line. Console_Write() is all-or-nothing: it fails
+ * rather than emitting part of a line or frame.
+ *
+ * Commands whose reply grows with the number of devices (SENSORS, SCAN,
+ * HELP) print it as a listing: Console_Poll() adds one line at a time
+ * while the ring keeps room for it and a sample report (APP_REPORT_MAX),
+ * so a reply longer than the ring goes out in full rather than losing
+ * lines. Each line reflects the state when it is printed. A new listing
+ * replaces one still under way, and the replies of other commands may
+ * land between its lines.
+ *
+ * The sample report goes through the ring as well. A blocking
+ * HAL_UART_Transmit() elsewhere (the I2C trace dump) must not overlap a DMA
+ * transfer; call Console_Flush() first.
+ */
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include "stm32f7xx_hal.h"
+
+/*!
+ * Compile-time configuration
+ */
+#define CONSOLE_TX_SIZE		1024U	/**< Output ring bytes, power of two **/
+#define CONSOLE_LINE_SIZE	64U		/**< Longest command line **/
+#define CONSOLE_MAX_ARGS	6U
+
+/*!
+ * Function prototypes
+ */
+void Console_Init(UART_HandleTypeDef *huart);
+void Console_Input(uint8_t byte);
+void Console_Poll(void);
+_Bool Console_Flush(uint32_t timeout);
+uint32_t Console_Free(void);
+_Bool Console_Write(const void *data, uint32_t len);
+_Bool Console_Printf(const char *format, ...);
+
+#endif /* CONSOLE_H_ */
@@ -0,0 +1,99 @@
+/*!
+ * @file control.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Fixed-rate PID loop on one filtered channel, producing a PWM duty.
+ *
+ * Control_Step() is called every CONTROL_PERIOD_MS from the TIM7 update
+ * interrupt, so the loop runs on a hardware time base regardless of what
+ * the main loop is doing; the integral uses the nominal period. Samples
+ * arrive more slowly, every 0.5-8 s with the adaptive cadence (adaptive.h),
+ * so the derivative is only taken when the sample time advances, over the
+ * seconds since the previous sample, and is held in between. The actuator
+ * either raises the controlled value (humidifier, heater) or lowers it
+ * (dehumidifier, fan), set by the direction.
+ *
+ *  - derivative on measurement, so a setpoint change does not kick;
+ *  - anti-windup by conditional integration: the integral does not grow
+ *    while the output is pinned at a limit in the direction of the error,
+ *    and is itself held within the output range;
+ *  - rate limit: the duty moves by at most slew permille per second;
+ *  - an invalid reading freezes the integral and ramps the duty to 0.
+ *
+ * Control_Configure() is called from thread level and only queues the
+ * settings; the next step takes them over, so the interrupt never sees a
+ * half-written configuration. A new setpoint or gain is bumpless, a new
+ * input or direction starts the loop afresh.
+ *
+ * Each step records its DWT stamp; jitter is the deviation of the interval
+ * between steps from the nominal period, and the worst case is kept.
+ */
+
+#ifndef CONTROL_H_
+#define CONTROL_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef CONTROL_PERIOD_MS
+#define CONTROL_PERIOD_MS		1000U	/**< Must match TIM7 in tim.c **/
+#endif
+#define CONTROL_DUTY_MAX		1000U	/**< Duty is in permille **/
+
+/*!
+ * @typedef Control_InputTypeDef refers to enum of controlled channels
+ */
+typedef enum {
+	CONTROL_OFF,
+	CONTROL_HUMIDITY,
+	CONTROL_TEMPERATURE
+} Control_InputTypeDef;
+
+/*!
+ * @typedef Control_ConfigTypeDef refers to loop settings, 20 bytes
+ *
+ * Gains are in permille of duty per unit (%RH or C) of error, per unit
+ * second of error for ki and per unit/s of change for kd.
+ */
+typedef struct {
+	uint8_t input;			/**< Control_InputTypeDef **/
+	int8_t direction;		/**< 1: output raises the value, -1: lowers it **/
+	int16_t setpoint;		/**< 0.01 units **/
+	float kp;
+	float ki;
+	float kd;
+	uint16_t slew;			/**< Permille per second, 0 for no limit **/
+	uint16_t reserved;
+} Control_ConfigTypeDef;
+
+/*!
+ * @typedef Control_TypeDef refers to the loop state
+ */
+typedef struct {
+	Control_ConfigTypeDef config;
+	Control_ConfigTypeDef pending;	/**< Taken over by the next step **/
+	volatile _Bool update;
+	float integral;			/**< Permille **/
+	float duty;				/**< Permille **/
+	float derivative;		/**< D term of the newest sample, permille **/
+	int16_t previous;		/**< Last valid reading, 0.01 units **/
+	uint32_t previousTime;	/**< Its sample time, s **/
+	uint32_t steps;
+	uint32_t stamp;			/**< DWT stamp of the last step **/
+	uint32_t jitter;		/**< Worst deviation from the period, cycles **/
+} Control_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Control_Init(Control_TypeDef *c, const Control_ConfigTypeDef *config);
+void Control_Configure(Control_TypeDef *c, const Control_ConfigTypeDef *config);
+uint16_t Control_Step(Control_TypeDef *c, const Sample_TypeDef *sample, uint32_t stamp);
+
+#endif /* CONTROL_H_ */
@@ -0,0 +1,50 @@
+/*!
+ * @file cycles.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Thin wrapper around the Cortex-M7 DWT cycle counter. CYCCNT runs at HCLK
+ * (216 MHz with the clock tree in SystemClock_Config), so one count is
+ * roughly 4.6 ns and the counter wraps every ~19.9 s. Differences taken with
+ * unsigned subtraction are wrap-safe for intervals shorter than that.
+ */
+
+#ifndef CYCLES_H_
+#define CYCLES_H_
+
+#include "stm32f7xx_hal.h"
+
+#define CYCLES_DWT_UNLOCK_KEY	0xC5ACCE55U /**< DWT lock access key (CM7 only) **/
+
+/*!
+ * @brief Enables trace and starts the DWT cycle counter
+ *
+ * Safe to call more than once; the counter is reset each time.
+ */
+static inline void Cycles_Init(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = CYCLES_DWT_UNLOCK_KEY;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*!
+ * @brief Reads the current cycle count
+ * @return Free-running HCLK cycle count
+ */
+static inline uint32_t Cycles_Now(void) {
+	return DWT->CYCCNT;
+}
+
+/*!
+ * @brief Converts a cycle interval to microseconds
+ * @param cycles Interval in HCLK cycles
+ * @return Interval in microseconds (truncated)
+ */
+static inline uint32_t Cycles_ToMicros(uint32_t cycles) {
+	return cycles / (SystemCoreClock / 1000000U);
+}
+
+#endif /* CYCLES_H_ */
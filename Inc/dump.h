@@ -0,0 +1,89 @@
+/*!
+ * @file dump.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Resumable bulk export of stored samples over the console.
+ *
+ * A dump streams the samples of one source whose time is in [from, to):
+ * the 1 Hz RAM store (R, times in App_Time() seconds), the history of
+ * additional sensor n in the SENSORS listing (Sn, same times, see
+ * acquire.h) or the flash log (F, times in log time; the TIME command maps
+ * one to the other). Each
+ * sample in the range has an offset, counted from 0 at the first one.
+ *
+ * Samples go out in binary frames, interleaved with the console's text
+ * lines only between frames. All fields are little-endian:
+ *  _______________________________________________________
+ * | Offset | Size | Field                                  |
+ * |________|______|________________________________________|
+ * |   0    |  2   | sync, A5 5A                            |
+ * |   2    |  1   | type, 'D' data or 'E' end of range     |
+ * |   3    |  1   | count of samples, 0 for 'E'            |
+ * |   4    |  4   | offset of the first sample ('E': total)|
+ * |   8    | 8*n  | samples {u32 time, i16 rh, i16 temp}   |
+ * |  8+8n  |  4   | CRC-32 (zlib) of bytes 2 .. 8+8n-1     |
+ * |________|______|________________________________________|
+ *
+ * Values are in 0.01 units, -32768 for a failed read.
+ *
+ * The host acknowledges with "ACK <offset>", offset being the end of the
+ * last good frame. At most DUMP_WINDOW frames are unacknowledged at once.
+ * If no acknowledgement arrives within DUMP_ACK_TIMEOUT_MS the dump goes
+ * back to the last acknowledged offset and resends (go-back-N); after
+ * DUMP_RETRIES it pauses. "RESUME" continues a paused or broken dump from
+ * the last acknowledged offset, "RESUME <offset>" from any offset, and
+ * "DUMP ... <offset>" starts a new one part-way in.
+ *
+ * Everything runs from Dump_Poll() in the main loop with a bounded amount
+ * of decoding per call, so sampling and storage carry on during a dump.
+ * Only the text sample report is held back while frames are streaming.
+ *
+ * At 9600 baud a full frame (32 samples, 268 bytes) takes ~280 ms, so an
+ * hour of 1 Hz samples takes about 30 s; use F or the rollups for long
+ * ranges.
+ */
+
+#ifndef DUMP_H_
+#define DUMP_H_
+
+#include <stdint.h>
+#include "tsdb.h"
+
+/*!
+ * Compile-time configuration
+ */
+#define DUMP_CHUNK				32U		/**< Samples per frame **/
+#define DUMP_WINDOW				4U		/**< Unacknowledged frames in flight **/
+#define DUMP_ACK_TIMEOUT_MS		3000U
+#define DUMP_RETRIES			3U
+#define DUMP_BUDGET				256U	/**< Samples decoded per Dump_Poll **/
+
+#define DUMP_SYNC0				0xA5U
+#define DUMP_SYNC1				0x5AU
+#define DUMP_FRAME_MAX			(8U + DUMP_CHUNK * 8U + 4U)
+
+/*!
+ * @typedef Dump_SourceTypeDef refers to enum of dump sources
+ */
+typedef enum {
+	DUMP_SOURCE_RAM,
+	DUMP_SOURCE_FLASH
+} Dump_SourceTypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Dump_Init(const Tsdb_TypeDef *ram);
+void Dump_Start(Dump_SourceTypeDef source, uint32_t from, uint32_t to, uint32_t offset);
+void Dump_StartStore(const Tsdb_TypeDef *db, uint32_t from, uint32_t to, uint32_t offset);
+void Dump_Ack(uint32_t offset);
+_Bool Dump_Resume(_Bool seek, uint32_t offset);
+void Dump_Abort(void);
+_Bool Dump_Active(void);
+void Dump_Poll(void);
+uint32_t Dump_Crc32(uint32_t crc, const uint8_t *data, uint32_t len);
+
+#endif /* DUMP_H_ */
@@ -0,0 +1,65 @@
+/*!
+ * @file event_queue.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Lock-free single-producer/single-consumer ring of typed events for
+ * handing work from interrupt handlers to the main loop.
+ *
+ * Exactly one context may push to a queue and exactly one may pop from it.
+ * The producer owns head, the consumer owns tail, and each only reads the
+ * other's index, so neither side ever masks interrupts or waits. Give every
+ * interrupt source its own queue rather than sharing one between ISRs.
+ *
+ * Capacity must be a power of two. Indices run freely and are masked on
+ * access, so all capacity slots are usable. A push onto a full queue fails
+ * and is counted in dropped; the producer never blocks.
+ */
+
+#ifndef EVENT_QUEUE_H_
+#define EVENT_QUEUE_H_
+
+#include "stm32f7xx_hal.h"
+
+/*!
+ * @typedef Event_IdTypeDef refers to enum of event types
+ */
+typedef enum {
+	EVENT_TICK,			/**< Sampling tick; arg unused **/
+	EVENT_BUTTON,		/**< User button edge; arg 1:pressed, 0:released **/
+	EVENT_I2C_DONE,		/**< I2C transfer completion; source is the bus, arg the HAL status **/
+	EVENT_UART_RX		/**< UART byte received; arg is the byte **/
+} Event_IdTypeDef;
+
+/*!
+ * @typedef Event_TypeDef refers to a single queued event
+ */
+typedef struct {
+	uint8_t id;			/**< Event_IdTypeDef **/
+	uint8_t source;		/**< Instance that raised it, where there is more than one **/
+	uint16_t arg;		/**< Type-specific payload **/
+	uint32_t timestamp;	/**< HAL_GetTick() when raised **/
+} Event_TypeDef;
+
+/*!
+ * @typedef EventQueue_TypeDef refers to one SPSC ring
+ */
+typedef struct {
+	volatile uint32_t head;		/**< Next slot to write, producer only **/
+	volatile uint32_t tail;		/**< Next slot to read, consumer only **/
+	volatile uint32_t dropped;	/**< Pushes rejected because the ring was full **/
+	uint32_t mask;
+	Event_TypeDef *slot;
+} EventQueue_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void EventQueue_Init(EventQueue_TypeDef *q, Event_TypeDef *storage, uint32_t capacity);
+_Bool EventQueue_Push(EventQueue_TypeDef *q, uint8_t id, uint8_t source, uint16_t arg, uint32_t timestamp);
+_Bool EventQueue_Pop(EventQueue_TypeDef *q, Event_TypeDef *e);
+uint32_t EventQueue_Count(EventQueue_TypeDef *q);
+
+#endif /* EVENT_QUEUE_H_ */
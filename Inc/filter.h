@@ -0,0 +1,94 @@
+/*!
+ * @file filter.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Fixed-memory streaming filters for one sensor channel. Input and output
+ * are Sample_TypeDef values (hundredths); internal estimates carry 8 more
+ * fractional bits so slow filters do not stall on rounding. Nothing is
+ * allocated and every update does a bounded amount of integer work.
+ *
+ *  ________________________________________________________________________
+ * | Kind    | Parameters     | Update                          | Cycles*  |
+ * |_________|________________|_________________________________|__________|
+ * | NONE    |                | pass-through                    |   ~5     |
+ * | AVERAGE | window 1-16    | running sum over a ring, 1 div  |  ~25     |
+ * | EMA     | alpha Q16      | y += alpha * (x - y)            |  ~15     |
+ * | MEDIAN  | window 1-16    | sorted copy, one entry moved    | ~10 + 4w |
+ * | KALMAN  | q, r           | 1-D random walk, 1 div          |  ~40     |
+ * |_________|________________|_________________________________|__________|
+ *
+ * * Estimated from instruction counts at 216 MHz with the ART cache on;
+ *   Bench_Run() reports measured values as filter.<kind>.
+ *
+ * The median keeps a sorted copy of the window next to the ring. Each
+ * update replaces the outgoing value with the incoming one in the sorted
+ * copy and moves it into place, so the cost grows with the window (w), not
+ * with the number of samples; keep the window small (3-9).
+ *
+ * The Kalman filter models the channel as a random walk: q is the process
+ * variance per sample and r the measurement variance, both in hundredths
+ * squared (e.g. r = 200 for the 0.49 %RH steps at RES_H8T12). The error
+ * variance is capped at 0xFFFF so the gain fits one 32-bit division.
+ *
+ * A SAMPLE_INVALID input is passed through and does not touch the state.
+ */
+
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef FILTER_WINDOW_MAX
+#define FILTER_WINDOW_MAX	16U		/**< Largest AVERAGE/MEDIAN window **/
+#endif
+
+/*!
+ * @typedef Filter_KindTypeDef refers to enum of filter kinds
+ */
+typedef enum {
+	FILTER_NONE,
+	FILTER_AVERAGE,
+	FILTER_EMA,
+	FILTER_MEDIAN,
+	FILTER_KALMAN
+} Filter_KindTypeDef;
+
+/*!
+ * @typedef Filter_ConfigTypeDef refers to filter settings, 8 bytes
+ */
+typedef struct {
+	uint8_t kind;			/**< Filter_KindTypeDef **/
+	uint8_t window;			/**< AVERAGE/MEDIAN samples **/
+	uint16_t alpha;			/**< EMA weight of a new sample, 1/65536 units **/
+	uint16_t q;				/**< KALMAN process variance **/
+	uint16_t r;				/**< KALMAN measurement variance **/
+} Filter_ConfigTypeDef;
+
+/*!
+ * @typedef Filter_TypeDef refers to one channel's filter
+ */
+typedef struct {
+	Filter_ConfigTypeDef config;
+	uint32_t count;			/**< Samples held (AVERAGE/MEDIAN) or seen **/
+	uint32_t next;			/**< Ring index of the oldest sample **/
+	int32_t acc;			/**< Running sum, or estimate in 1/256 hundredths **/
+	uint32_t p;				/**< KALMAN error variance **/
+	int16_t ring[FILTER_WINDOW_MAX];
+	int16_t sorted[FILTER_WINDOW_MAX];
+} Filter_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Filter_Init(Filter_TypeDef *f, const Filter_ConfigTypeDef *config);
+void Filter_Reset(Filter_TypeDef *f);
+int16_t Filter_Update(Filter_TypeDef *f, int16_t value);
+
+#endif /* FILTER_H_ */
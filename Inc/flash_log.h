@@ -0,0 +1,133 @@
+/*!
+ * @file flash_log.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Append-only sample log in the upper megabyte of on-chip flash.
+ *
+ * The log owns four sectors of the upper megabyte, which the linker script
+ * reserves as FLASHLOG. Where they are depends on the nDBANK option bit:
+ *  - dual bank (nDBANK=0): bank 2 sectors 20-23, 4 x 128 KB at 0x08180000.
+ *    The program runs from bank 1, so erasing and programming the log is a
+ *    read-while-write operation and nothing stalls. This is the intended
+ *    setup; set nDBANK=0 with STM32CubeProgrammer (which needs the flash to
+ *    be reprogrammed afterwards) before loading the firmware.
+ *  - single bank (nDBANK=1, the factory default): sectors 8-11, 4 x 256 KB
+ *    at 0x08100000. Any flash access, including every instruction fetch and
+ *    vector read (the ART accelerator, prefetch and I-cache are all off and
+ *    nothing runs from ITCM), waits for an erase to finish: SysTick, the
+ *    TIM7 control step, the I2C and UART interrupts and the main loop all
+ *    freeze for the 1-4 s a 256 KB sector takes. Each program operation
+ *    stalls them for ~16-100 us. Only use this mode if that is acceptable.
+ *
+ * Each record is 8 bytes (time, humidity, temperature), so a sector holds
+ * 16383 (dual bank) or 32767 (single bank) records behind its header. At
+ * the default one record per minute that is ~11 or ~22 days per sector and
+ * ~5-6 weeks or ~2.5-3 months of history across the ring.
+ *
+ * Sector layout:
+ *  ______________________________________________
+ * | Offset | Size | Field                         |
+ * |________|______|_______________________________|
+ * |   0    |  4   | magic (FLASH_LOG_MAGIC)       |
+ * |   4    |  4   | sequence number, +1 per use   |
+ * |   8    | 8*N  | records, erased = all 0xFF    |
+ * |________|______|_______________________________|
+ *
+ * Mounting reads four headers, takes the highest sequence as the active
+ * sector and binary-searches it for the first erased record, so it costs
+ * ~15 flash reads regardless of fill level.
+ *
+ * Sectors are used round-robin for wear leveling. Once the active sector is
+ * half full, the next one (the oldest data) is erased in the background with
+ * HAL_FLASHEx_Erase_IT. Appends go through a small RAM queue that is drained
+ * from FlashLog_Poll(), so a record that arrives mid-erase waits instead of
+ * blocking the caller.
+ *
+ * Record times are kept on a log time base that carries on from the last
+ * record across resets: log time = (last record time at mount + 1) + sample
+ * seconds since mount.
+ *
+ * Records are programmed as two words (x32 parallelism), which works from
+ * the 2.7-3.6 V supply alone, as on the Nucleo-F767ZI. The values word is
+ * written first and the time word last, so a slot only reads as used once
+ * it is complete. A slot that fails to program, or that a reset left with
+ * values but no time, is voided by zeroing its time (no erase needed) and
+ * skipped by readers; the written slots thus stay a prefix of the sector.
+ * A new log starts at log time 1 so that 0 is never a real time. A board
+ * with an external VPP supply can build with FLASH_LOG_PROGRAM_DOUBLEWORD=1
+ * to program each record in one x64 operation.
+ */
+
+#ifndef FLASH_LOG_H_
+#define FLASH_LOG_H_
+
+#include "stm32f7xx_hal.h"
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef FLASH_LOG_INTERVAL_S
+#define FLASH_LOG_INTERVAL_S		60U		/**< Minimum seconds between records **/
+#endif
+#ifndef FLASH_LOG_PROGRAM_DOUBLEWORD
+#define FLASH_LOG_PROGRAM_DOUBLEWORD	0		/**< 1: x64 programming, needs external VPP **/
+#endif
+#define FLASH_LOG_PENDING			16U		/**< RAM queue depth, power of two **/
+
+#define FLASH_LOG_SECTORS			4U
+#define FLASH_LOG_BASE				0x08100000U	/**< Single bank: sectors 8-11 **/
+#define FLASH_LOG_SECTOR_SIZE		0x40000U
+#define FLASH_LOG_FIRST_SECTOR		FLASH_SECTOR_8
+#define FLASH_LOG_BANK2_BASE		0x08180000U	/**< Dual bank: sectors 20-23 **/
+#define FLASH_LOG_BANK2_SECTOR_SIZE	0x20000U
+#define FLASH_LOG_BANK2_FIRST_SECTOR	FLASH_SECTOR_20
+#define FLASH_LOG_MAGIC				0x474F4C53U	/**< "SLOG" little-endian **/
+#define FLASH_LOG_HEADER_SIZE		8U
+#define FLASH_LOG_RECORD_SIZE		8U
+#define FLASH_LOG_RECORDS_PER_SECTOR(size)	(((size) - FLASH_LOG_HEADER_SIZE) / FLASH_LOG_RECORD_SIZE)
+
+/*!
+ * @typedef FlashLog_RecordTypeDef refers to one record as stored in flash
+ */
+typedef struct {
+	uint32_t time;			/**< Log time in seconds, 0xFFFFFFFF when erased, 0 when void **/
+	int16_t humidity;
+	int16_t temperature;
+} FlashLog_RecordTypeDef;
+
+/*!
+ * @typedef FlashLog_CursorTypeDef refers to a read position in the log
+ */
+typedef struct {
+	uint32_t sector;		/**< Ring index 0..FLASH_LOG_SECTORS-1 **/
+	uint32_t record;		/**< Record index within the sector **/
+	uint32_t remaining;		/**< Sectors left to visit including this one **/
+} FlashLog_CursorTypeDef;
+
+/*!
+ * @typedef FlashLog_StatsTypeDef refers to log counters
+ */
+typedef struct {
+	uint32_t appended;		/**< Records programmed since boot **/
+	uint32_t dropped;		/**< Records lost to a full RAM queue **/
+	uint32_t erases;		/**< Sector erases started since boot **/
+	uint32_t errors;		/**< Program or erase failures **/
+} FlashLog_StatsTypeDef;
+
+/*!
+ * Function prototypes
+ */
+_Bool FlashLog_Init(uint32_t now);
+void FlashLog_Append(const Sample_TypeDef *sample);
+void FlashLog_Poll(void);
+uint32_t FlashLog_Time(uint32_t time);
+uint32_t FlashLog_Count(void);
+void FlashLog_Begin(FlashLog_CursorTypeDef *cursor);
+_Bool FlashLog_Next(FlashLog_CursorTypeDef *cursor, FlashLog_RecordTypeDef *record);
+const FlashLog_StatsTypeDef *FlashLog_Stats(void);
+
+#endif /* FLASH_LOG_H_ */
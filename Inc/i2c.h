@@ -31,12 +31,18 @@
 /* USER CODE END Includes */
 
 extern I2C_HandleTypeDef hi2c1;
+extern I2C_HandleTypeDef hi2c2;
+extern I2C_HandleTypeDef hi2c3;
+extern I2C_HandleTypeDef hi2c4;
 
 /* USER CODE BEGIN Private defines */
 
 /* USER CODE END Private defines */
 
 void MX_I2C1_Init(void);
+void MX_I2C2_Init(void);
+void MX_I2C3_Init(void);
+void MX_I2C4_Init(void);
 
 /* USER CODE BEGIN Prototypes */
 
@@ -0,0 +1,86 @@
+/*!
+ * @file i2c_reg.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Register-level I2C master transfers, a lean stand-in for
+ * HAL_I2C_Master_Transmit/Receive on the short transfers the sensor drivers
+ * make (1-8 bytes).
+ *
+ * The HAL calls go through the handle lock and state checks and wait on
+ * every flag with I2C_WaitOnFlagUntilTimeout, which calls HAL_GetTick() on
+ * each pass. These functions program CR2 once with address, byte count,
+ * AUTOEND and START, move the bytes through TXDR/RXDR and wait for STOPF.
+ * Timeouts are checked against the DWT cycle counter, one register read.
+ * The peripheral itself (TIMINGR, filters, PE) is still set up by
+ * MX_I2Cx_Init; the HAL handle is only used for Instance and ErrorCode, so
+ * HAL and register transfers can be mixed on one bus.
+ *
+ * I2C_REG_MODE picks how a blocking transfer completes:
+ *  - I2C_REG_POLL: bytes and STOP are polled on ISR;
+ *  - I2C_REG_IRQ: the instance's event interrupt moves the bytes and the
+ *    caller sleeps (WFI) until STOP;
+ *  - I2C_REG_DMA: as IRQ, except that on I2C1 DMA1 stream 6 (TX) / stream 0
+ *    (RX), channel 1, moves the bytes.
+ * The D-cache is off in this project; enabling it would need cache
+ * maintenance on the DMA buffers.
+ *
+ * I2CReg_Start() is the non-blocking form, for running I2C1-I2C4 side by
+ * side: it only starts the transfer, the interrupt carries it through, and
+ * the outcome is pushed with the caller's tag onto that bus's completion
+ * queue, to be taken off with I2CReg_Complete(). Each bus has one transfer
+ * in flight at a time; I2CReg_Start() reports HAL_BUSY until it is done.
+ * These transfers have no timeout of their own, the caller abandons a late
+ * one with I2CReg_Abort().
+ *
+ * Bench_Run() times one register round trip through the HAL and through
+ * this path back to back (i2c.hal.* and i2c.reg.* items); the wire time is
+ * the same, so the difference is software overhead.
+ */
+
+#ifndef I2C_REG_H_
+#define I2C_REG_H_
+
+#include "stm32f7xx_hal.h"
+
+#define I2C_REG_POLL		0
+#define I2C_REG_IRQ			1
+#define I2C_REG_DMA			2
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef I2C_REG_MODE
+#define I2C_REG_MODE		I2C_REG_POLL
+#endif
+#ifndef I2C_REG_IRQ_PRIORITY
+#define I2C_REG_IRQ_PRIORITY	2U
+#endif
+#ifndef I2C_REG_QUEUE
+#define I2C_REG_QUEUE		4U		/**< Completions held per bus **/
+#endif
+#define I2C_REG_BUSES		4U		/**< I2C1-I2C4 **/
+
+/*!
+ * @typedef I2CReg_CompletionTypeDef refers to the outcome of a started transfer
+ */
+typedef struct {
+	uint32_t tag;			/**< As passed to I2CReg_Start **/
+	uint32_t error;			/**< HAL_I2C_ERROR_* bits, 0 on success **/
+	uint32_t stamp;			/**< DWT stamp of the STOP **/
+} I2CReg_CompletionTypeDef;
+
+/*!
+ * Function prototypes
+ */
+void I2CReg_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef I2CReg_Transmit(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, uint32_t timeout);
+HAL_StatusTypeDef I2CReg_Receive(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, uint32_t timeout);
+uint32_t I2CReg_Received(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef I2CReg_Start(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, _Bool rx, uint32_t tag);
+_Bool I2CReg_Complete(I2C_HandleTypeDef *hi2c, I2CReg_CompletionTypeDef *completion);
+void I2CReg_Abort(I2C_HandleTypeDef *hi2c);
+
+#endif /* I2C_REG_H_ */
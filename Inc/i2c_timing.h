@@ -0,0 +1,87 @@
+/*!
+ * @file i2c_timing.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * TIMINGR calculator for the STM32F7 I2C peripheral, in place of the
+ * constant CubeMX writes into MX_I2Cx_Init (0x20404768: 100 kHz from a
+ * 54 MHz PCLK1, valid for that clock only).
+ *
+ * I2CTiming_Compute() takes the kernel clock, the wanted SCL rate, the
+ * board's rise and fall times and the filter settings, and searches
+ * PRESC/SCLDEL/SDADEL/SCLL/SCLH against the I2C-bus specification limits
+ * of the mode the rate falls in (RM0410, I2C timings):
+ *  __________________________________________________________________
+ * | Mode        | Rate    | tLOW   | tHIGH  | tSU;DAT | tVD;DAT | tr   |
+ * |_____________|_________|________|________|_________|_________|______|
+ * | Standard    | 100 kHz | 4.7 us | 4.0 us | 250 ns  | 3.45 us | 1 us |
+ * | Fast        | 400 kHz | 1.3 us | 0.6 us | 100 ns  | 0.9 us  | 300  |
+ * | Fast Plus   | 1 MHz   | 0.5 us | 0.26us | 50 ns   | 0.45 us | 120  |
+ * |_____________|_________|________|________|_________|_________|______|
+ *
+ * The SCL period comes out at or just below the requested rate (never
+ * above, at most 20 % below); among equally close settings the one that
+ * splits tLOW/tHIGH closest to the ratio of their minimums wins.
+ *
+ * How slow the bus can go depends on the kernel clock: the longest SCL
+ * period is 2 x 16 x 256 kernel clocks plus the filter and edge delays,
+ * so ~6.6 kHz from 54 MHz, ~13 kHz from 108 MHz and ~26 kHz from 216 MHz.
+ * A rate between I2C_TIMING_SPEED_MIN and that floor gets the slowest
+ * setting the clock has.
+ *
+ * I2CTiming_Apply() writes the result with the peripheral disabled, sets
+ * the filters and switches the Fast-mode Plus drive (SYSCFG_PMC) of the
+ * instance on above 400 kHz and off otherwise. It can be called at any
+ * time the bus is idle. I2CTiming_Default() turns the analog filter off
+ * above 400 kHz: its worst-case delay leaves no valid data hold time in
+ * Fast-mode Plus from the 54 MHz PCLK1 I2C1 runs on. Note that the Si7021
+ * itself is rated for 400 kHz.
+ */
+
+#ifndef I2C_TIMING_H_
+#define I2C_TIMING_H_
+
+#include "stm32f7xx_hal.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef I2C_TIMING_SPEED
+#define I2C_TIMING_SPEED			400000U	/**< SCL rate set at boot, Hz **/
+#endif
+#ifndef I2C_TIMING_RISE_NS
+#define I2C_TIMING_RISE_NS			100U	/**< SCL/SDA rise time on the board **/
+#endif
+#ifndef I2C_TIMING_FALL_NS
+#define I2C_TIMING_FALL_NS			10U		/**< SCL/SDA fall time on the board **/
+#endif
+#ifndef I2C_TIMING_DIGITAL_FILTER
+#define I2C_TIMING_DIGITAL_FILTER	0U		/**< 0-15 kernel clocks **/
+#endif
+#define I2C_TIMING_SPEED_MIN		10000U	/**< Slowest rate accepted; see above for the rate reached **/
+#define I2C_TIMING_SPEED_MAX		1000000U
+
+/*!
+ * @typedef I2CTiming_ConfigTypeDef refers to the inputs of the calculation
+ */
+typedef struct {
+	uint32_t speed;				/**< SCL rate, Hz **/
+	uint16_t rise;				/**< ns **/
+	uint16_t fall;				/**< ns **/
+	uint8_t analogFilter;		/**< 0:off, 1:on **/
+	uint8_t digitalFilter;		/**< 0-15 kernel clocks **/
+} I2CTiming_ConfigTypeDef;
+
+/*!
+ * Function prototypes
+ */
+void I2CTiming_Default(I2CTiming_ConfigTypeDef *config, uint32_t speed);
+uint32_t I2CTiming_Compute(uint32_t clock, const I2CTiming_ConfigTypeDef *config);
+uint32_t I2CTiming_Rate(uint32_t clock, uint32_t timing, const I2CTiming_ConfigTypeDef *config);
+uint32_t I2CTiming_Clock(const I2C_TypeDef *instance);
+HAL_StatusTypeDef I2CTiming_Apply(I2C_HandleTypeDef *hi2c, const I2CTiming_ConfigTypeDef *config);
+HAL_StatusTypeDef I2CTiming_SetSpeed(I2C_HandleTypeDef *hi2c, uint32_t speed);
+
+#endif /* I2C_TIMING_H_ */
@@ -0,0 +1,101 @@
+/*!
+ * @file i2c_trace.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Low-overhead I2C transaction tracer. Every HAL transfer issued by the
+ * sensor drivers is recorded into a fixed-size ring together with its DWT
+ * start/end cycle stamps, so latency spikes and NACK storms can be examined
+ * after the fact without a logic analyzer.
+ *
+ * Slots are claimed with LDREX/STREX, so recording never blocks and is safe
+ * from both thread and interrupt context. The oldest entries are overwritten
+ * once the ring is full.
+ *
+ * @section Layout
+ *
+ * The ring is a plain global (i2cTrace) so it can also be pulled with a
+ * debugger, e.g. `dump binary value trace.bin i2cTrace`. All fields are
+ * little-endian:
+ *  ________________________________________________________
+ * | Offset | Size | Field                                   |
+ * |________|______|_________________________________________|
+ * |   0    |  4   | magic (I2C_TRACE_MAGIC)                 |
+ * |   4    |  4   | head -- total records ever written      |
+ * |   8    | 16*N | entries, index = sequence % N           |
+ * |________|______|_________________________________________|
+ *
+ * Entry (16 bytes):
+ *  _________________________________________________________
+ * | Offset | Size | Field                                    |
+ * |________|______|__________________________________________|
+ * |   0    |  4   | start -- DWT CYCCNT before the HAL call  |
+ * |   4    |  4   | end -- DWT CYCCNT after the HAL call     |
+ * |   8    |  4   | error -- hi2c.ErrorCode after the call   |
+ * |  12    |  2   | len -- bytes requested                   |
+ * |  14    |  1   | addr -- 8-bit (shifted) slave address    |
+ * |  15    |  1   | flags -- [7] read, [1:0] HAL status      |
+ * |________|______|__________________________________________|
+ *
+ * The UART dump (I2CTrace_Dump) emits the same information as CSV, one
+ * entry per line, oldest first, preceded by a header line.
+ */
+
+#ifndef I2C_TRACE_H_
+#define I2C_TRACE_H_
+
+#include "stm32f7xx_hal.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef I2C_TRACE_ENABLED
+#define I2C_TRACE_ENABLED		1 /**< 0 compiles all recording out **/
+#endif
+#ifndef I2C_TRACE_DEPTH
+#define I2C_TRACE_DEPTH			64U /**< entries, must be a power of two **/
+#endif
+
+#define I2C_TRACE_MAGIC			0x54433249U /**< "I2CT" little-endian **/
+
+/*!
+ * Entry flag bits
+ */
+#define I2C_TRACE_READ_POS		(7U)
+#define I2C_TRACE_READ			(0x1U << I2C_TRACE_READ_POS) /** 1:receive, 0:transmit **/
+#define I2C_TRACE_STATUS_MASK	(0x03U) /** HAL_StatusTypeDef of the transfer **/
+
+/*!
+ * @typedef I2CTrace_EntryTypeDef refers to a single recorded transfer
+ */
+typedef struct {
+	uint32_t start;		/**< DWT cycle stamp before the transfer **/
+	uint32_t end;		/**< DWT cycle stamp after the transfer **/
+	uint32_t error;		/**< HAL I2C ErrorCode after the transfer **/
+	uint16_t len;		/**< Requested length in bytes **/
+	uint8_t addr;		/**< 8-bit slave address **/
+	uint8_t flags;		/**< Direction and HAL status **/
+} I2CTrace_EntryTypeDef;
+
+/*!
+ * @typedef I2CTrace_TypeDef refers to the trace ring
+ */
+typedef struct {
+	uint32_t magic;
+	volatile uint32_t head;		/**< Total entries claimed since init **/
+	I2CTrace_EntryTypeDef entry[I2C_TRACE_DEPTH];
+} I2CTrace_TypeDef;
+
+extern I2CTrace_TypeDef i2cTrace;
+
+/*!
+ * Function prototypes
+ */
+void I2CTrace_Init(void);
+void I2CTrace_Record(uint8_t addr, uint8_t read, uint16_t len, HAL_StatusTypeDef status, uint32_t error, uint32_t start);
+uint32_t I2CTrace_Count(void);
+void I2CTrace_Dump(UART_HandleTypeDef *huart);
+
+#endif /* I2C_TRACE_H_ */
@@ -0,0 +1,66 @@
+/*!
+ * @file mux.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * TCA9548A 1-to-8 I2C multiplexer.
+ *
+ * The Si7021 answers at 0x40 only, so a bus holds one of them; a mux fans
+ * a bus out to eight channels with one sensor each. The mux has a single
+ * control register, one bit per channel, written with a one-byte transfer
+ * to the mux address; the channels whose bit is set are connected
+ * downstream until the next write. Up to eight muxes (0x70-0x77, A2-A0)
+ * share a bus, 64 sensors in all.
+ *
+ * The handle caches the control register, so Mux_Select() only goes on the
+ * wire when the channel changes; writes and skipped writes are counted.
+ * The cache is unknown after Mux_Init() and after Mux_Invalidate(), which
+ * callers use after a bus error or an abandoned transfer, and the next
+ * select always writes.
+ *
+ * Only one channel of one mux may be connected at a time, since the
+ * sensors behind them share an address: before selecting a channel on one
+ * mux, every other mux on the bus has to be switched off (Mux_Select with
+ * MUX_OFF). Acquire_AddMuxed() devices get this done by Acquire_Poll().
+ */
+
+#ifndef MUX_H_
+#define MUX_H_
+
+#include "stm32f7xx_hal.h"
+
+/*!
+ * Compile-time configuration
+ */
+#define MUX_DEFAULT_ADDRESS		0x70
+#define MUX_CHANNELS			8U
+#define MUX_OFF					0xFFU		/**< Channel argument that disconnects all **/
+#ifndef MUX_TIMEOUT_MS
+#define MUX_TIMEOUT_MS			10U
+#endif
+
+/*!
+ * @typedef Mux_TypeDef refers to one TCA9548A and its cached control register
+ */
+typedef struct {
+	I2C_HandleTypeDef *hi2c;
+	uint8_t address;		/**< 7-bit address in [7:1] **/
+	uint8_t control;		/**< Last control value written **/
+	_Bool known;			/**< control matches the device **/
+	uint32_t writes;
+	uint32_t skipped;		/**< Selects served from the cache **/
+} Mux_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Mux_Init(Mux_TypeDef *mux, I2C_HandleTypeDef *hi2c, uint8_t address);
+uint8_t Mux_Control(uint8_t channel);
+_Bool Mux_Current(const Mux_TypeDef *mux, uint8_t channel);
+HAL_StatusTypeDef Mux_Select(Mux_TypeDef *mux, uint8_t channel);
+void Mux_Written(Mux_TypeDef *mux, uint8_t control);
+void Mux_Invalidate(Mux_TypeDef *mux);
+
+#endif /* MUX_H_ */
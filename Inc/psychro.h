@@ -0,0 +1,64 @@
+/*!
+ * @file psychro.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Derived psychrometric metrics from one RH + temperature reading: dew
+ * point, absolute humidity and heat index.
+ *
+ * Saturation vapour pressure is the Magnus form over water with Sonntag's
+ * constants, es = 6.112 hPa * exp(17.62 T / (243.12 + T)), good to ~0.1 %
+ * against the WMO reference from -45 to 60 C. The exp and ln it needs are
+ * done with base-2 range reduction on the float's exponent bits and a
+ * polynomial on the mantissa (exp2: degree 4, relative error 3.6e-6;
+ * log2: degree 5, absolute error 1.4e-5) instead of libm's expf/logf. The
+ * libm calls left are sqrtf() in the heat index's low-RH adjustment and
+ * lrintf() for the rounding in Sample_FromFloat().
+ * Heat index is the NWS algorithm (Steadman simple form, Rothfusz
+ * regression with its low and high RH adjustments).
+ *
+ * Against the same formulas in double precision, over -40..85 C and
+ * 1..100 %RH, the approximations add at most:
+ *  ______________________________________________
+ * | Metric            | Unit       | Max error    |
+ * |___________________|____________|______________|
+ * | dew point         | 0.01 C     | 1 (rounding) |
+ * | absolute humidity | 0.01 g/m3  | 1 (rounding) |
+ * | heat index        | 0.01 C     | 1 (rounding) |
+ * |___________________|____________|______________|
+ *
+ * Sim/Src/bench_kernels.c checks these bounds over a 0.1 C x 0.1 %RH grid.
+ *
+ * Cost is three FPU divisions and ~60 other FPU operations, ~150 cycles
+ * (0.7 us) at 216 MHz; Bench_Run() reports it as psychro.compute.
+ */
+
+#ifndef PSYCHRO_H_
+#define PSYCHRO_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * @typedef Psychro_TypeDef refers to the metrics derived from one sample
+ *
+ * All fields are SAMPLE_INVALID when either input is. Dew point is also
+ * invalid at 0 %RH. Absolute humidity and heat index saturate at +-327.67
+ * rather than wrap; absolute humidity only gets there above ~81 C near
+ * saturation, heat index (a regression fitted for 27-50 C) in hot, humid
+ * air above ~60 C.
+ */
+typedef struct {
+	int16_t dewPoint;		/**< Dew point in 0.01 C **/
+	int16_t absHumidity;	/**< Water vapour density in 0.01 g/m3 **/
+	int16_t heatIndex;		/**< Apparent temperature in 0.01 C **/
+} Psychro_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Psychro_Compute(int16_t humidity, int16_t temperature, Psychro_TypeDef *out);
+
+#endif /* PSYCHRO_H_ */
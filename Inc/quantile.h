@@ -0,0 +1,78 @@
+/*!
+ * @file quantile.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Daily percentiles of one channel from a fixed-bin histogram.
+ *
+ * Each day (App_Time() / 86400) has a histogram of QUANTILE_BINS counters
+ * over the channel's range; a sample increments one counter, so updating is
+ * constant time and the memory is fixed whatever the sample rate. Values
+ * outside the range land in the end bins. Quantile_Get() walks the counts to
+ * the requested rank and interpolates linearly inside the bin, so a
+ * percentile is accurate to the bin width -- 0.1 %RH and 0.2 C with the
+ * application's settings -- rather than to a sketch's error bound.
+ *
+ * Today and yesterday are kept (8 KB per channel by default), so a full
+ * day's percentiles stay available for the whole of the day after.
+ */
+
+#ifndef QUANTILE_H_
+#define QUANTILE_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef QUANTILE_BINS
+#define QUANTILE_BINS		1024U
+#endif
+
+/*!
+ * @typedef Quantile_DayTypeDef refers to enum of the days kept
+ */
+typedef enum {
+	QUANTILE_TODAY,
+	QUANTILE_YESTERDAY,
+	QUANTILE_DAYS
+} Quantile_DayTypeDef;
+
+/*!
+ * @typedef Quantile_ConfigTypeDef refers to a channel's histogram range
+ */
+typedef struct {
+	int16_t min;			/**< Lower edge of the first bin, 0.01 units **/
+	uint16_t width;			/**< Bin width, 0.01 units **/
+} Quantile_ConfigTypeDef;
+
+/*!
+ * @typedef Quantile_HistogramTypeDef refers to one day's counts
+ */
+typedef struct {
+	uint32_t day;
+	uint32_t count;
+	uint32_t bins[QUANTILE_BINS];
+} Quantile_HistogramTypeDef;
+
+/*!
+ * @typedef Quantile_TypeDef refers to one channel's estimator
+ */
+typedef struct {
+	Quantile_ConfigTypeDef config;
+	uint32_t today;
+	Quantile_HistogramTypeDef days[QUANTILE_DAYS];	/**< Indexed by day parity **/
+} Quantile_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Quantile_Init(Quantile_TypeDef *q, const Quantile_ConfigTypeDef *config);
+void Quantile_Add(Quantile_TypeDef *q, uint32_t time, int16_t value);
+uint32_t Quantile_Count(const Quantile_TypeDef *q, Quantile_DayTypeDef day);
+int16_t Quantile_Get(const Quantile_TypeDef *q, Quantile_DayTypeDef day, uint32_t permille);
+
+#endif /* QUANTILE_H_ */
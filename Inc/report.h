@@ -0,0 +1,54 @@
+/*!
+ * @file report.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Change-only reporting policy for one channel of the UART text report.
+ *
+ * A sample is due -- worth a line -- when it is the first one, when it has
+ * moved more than the deadband from the last value sent, when its anomaly
+ * status bits differ from those sent, when it goes from valid to invalid or
+ * back, or when nothing has been sent for heartbeat seconds. Everything else
+ * is counted as suppressed. Storage is unaffected; only the text output is
+ * thinned.
+ *
+ * In a steady room with a 0.5 %RH / 0.1 C deadband and a 60 s heartbeat,
+ * this sends one report a minute instead of two a second.
+ */
+
+#ifndef REPORT_H_
+#define REPORT_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * @typedef Report_ConfigTypeDef refers to one channel's policy, 4 bytes
+ */
+typedef struct {
+	uint16_t deadband;		/**< 0.01 units; 0 sends every change **/
+	uint16_t heartbeat;		/**< Longest silence in seconds; 0 never forces **/
+} Report_ConfigTypeDef;
+
+/*!
+ * @typedef Report_TypeDef refers to one channel's reporting state
+ */
+typedef struct {
+	Report_ConfigTypeDef config;
+	_Bool started;
+	int16_t value;			/**< Last value sent **/
+	uint8_t status;			/**< Its SAMPLE_* bits **/
+	uint32_t time;			/**< When it was sent **/
+	uint32_t sent;
+	uint32_t suppressed;
+} Report_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Report_Init(Report_TypeDef *r, const Report_ConfigTypeDef *config);
+_Bool Report_Due(Report_TypeDef *r, uint32_t time, int16_t value, uint8_t status);
+
+#endif /* REPORT_H_ */
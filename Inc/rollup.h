@@ -0,0 +1,115 @@
+/*!
+ * @file rollup.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Multi-resolution rollups of the sample stream for history queries.
+ *
+ * Three tiers -- 1 minute, 1 hour and 1 day -- are each a fixed ring of
+ * buckets holding {min, max, sum, count} per channel. Every sample updates
+ * one bucket per tier, so the cost per sample is constant. A bucket's slot
+ * is its period number modulo the ring size, and the period number is kept
+ * in the bucket so stale slots are recognized and reset on first use.
+ *
+ * Default retention: 1440 minutes (1 day), 744 hours (31 days) and 366
+ * days, 100 KB in total.
+ *
+ * Rollup_Query() aggregates a time range by walking it with the coarsest
+ * bucket that is aligned, fits in what is left of the range and is still
+ * retained, dropping to finer tiers only at the ends. "Hourly min/max/mean
+ * for the last week" is 168 one-hour queries of one bucket each; a week
+ * in one query is at most 7 day buckets plus the partial days at either
+ * end. Range ends are rounded down to whole minutes.
+ *
+ * Where the range reaches past what the finer tiers keep, its unaligned
+ * ends cannot be answered: the first 40 minutes of a range starting at
+ * 10:20 two days ago are only in the 10:00 hour bucket, which also holds
+ * 10:00-10:20. Those stretches are left out, and the query reports the
+ * span it actually covered and the seconds missing inside it.
+ *
+ * Times are the Sample_TypeDef seconds since boot (App_Time()).
+ */
+
+#ifndef ROLLUP_H_
+#define ROLLUP_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef ROLLUP_MINUTES
+#define ROLLUP_MINUTES		1440U	/**< 1 minute buckets kept **/
+#endif
+#ifndef ROLLUP_HOURS
+#define ROLLUP_HOURS		744U	/**< 1 hour buckets kept **/
+#endif
+#ifndef ROLLUP_DAYS
+#define ROLLUP_DAYS			366U	/**< 1 day buckets kept **/
+#endif
+
+/*!
+ * @typedef Rollup_TierTypeDef refers to enum of tiers, finest first
+ */
+typedef enum {
+	ROLLUP_MINUTE,
+	ROLLUP_HOUR,
+	ROLLUP_DAY,
+	ROLLUP_TIERS
+} Rollup_TierTypeDef;
+
+/*!
+ * @typedef Rollup_StatTypeDef refers to the aggregate of one channel
+ *
+ * Values are in 0.01 units. sum is 64-bit: a day of 2 Hz samples near
+ * the top of the temperature range already overflows 32 bits.
+ */
+typedef struct {
+	int64_t sum;
+	uint32_t count;
+	int16_t min;
+	int16_t max;
+} Rollup_StatTypeDef;
+
+/*!
+ * @typedef Rollup_BucketTypeDef refers to one bucket of a tier
+ */
+typedef struct {
+	uint32_t period;				/**< time / tier period **/
+	Rollup_StatTypeDef humidity;
+	Rollup_StatTypeDef temperature;
+} Rollup_BucketTypeDef;
+
+/*!
+ * @typedef Rollup_SpanTypeDef refers to the part of a query range answered
+ */
+typedef struct {
+	uint32_t from;					/**< Start of the first bucket used **/
+	uint32_t to;					/**< End of the last bucket used, exclusive **/
+	uint32_t missing;				/**< Seconds in between that no tier kept **/
+} Rollup_SpanTypeDef;
+
+/*!
+ * @typedef Rollup_TypeDef refers to the set of tiers for one sensor
+ */
+typedef struct {
+	uint32_t last;					/**< Time of the newest sample **/
+	_Bool started;
+	Rollup_BucketTypeDef minute[ROLLUP_MINUTES];
+	Rollup_BucketTypeDef hour[ROLLUP_HOURS];
+	Rollup_BucketTypeDef day[ROLLUP_DAYS];
+} Rollup_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Rollup_Init(Rollup_TypeDef *r);
+void Rollup_Add(Rollup_TypeDef *r, const Sample_TypeDef *sample);
+uint32_t Rollup_Query(const Rollup_TypeDef *r, uint32_t from, uint32_t to, Rollup_BucketTypeDef *result,
+		Rollup_SpanTypeDef *covered);
+float Rollup_Mean(const Rollup_StatTypeDef *stat);
+
+#endif /* ROLLUP_H_ */
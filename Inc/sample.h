@@ -0,0 +1,61 @@
+/*!
+ * @file sample.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Fixed-point sample record shared by the storage and reporting code.
+ * Values are kept in hundredths (0.01 %RH, 0.01 C), which covers the full
+ * Si7021 output range of both channels in an int16_t and is finer than the
+ * sensor's best resolution.
+ */
+
+#ifndef SAMPLE_H_
+#define SAMPLE_H_
+
+#include <stdint.h>
+#include <math.h>
+
+#define SAMPLE_INVALID		INT16_MIN	/**< Channel value for a failed read **/
+
+/*!
+ * Channel status bits, set by the anomaly detector (see anomaly.h)
+ */
+#define SAMPLE_FAILED		0x01U	/**< Read failed **/
+#define SAMPLE_RANGE		0x02U	/**< Outside the plausible range **/
+#define SAMPLE_SPIKE		0x04U	/**< Jump from the previous sample **/
+#define SAMPLE_RATE			0x08U	/**< Sustained change too fast **/
+#define SAMPLE_STUCK		0x10U	/**< Same value for too long **/
+#define SAMPLE_DRIFT		0x20U	/**< Far from the long-term baseline **/
+
+/*!
+ * @typedef Sample_TypeDef refers to one humidity/temperature reading
+ */
+typedef struct {
+	uint32_t time;			/**< Seconds since boot, see App_Time() **/
+	int16_t humidity;		/**< Relative humidity in 0.01 % **/
+	int16_t temperature;	/**< Temperature in 0.01 C **/
+	uint8_t humidityStatus;		/**< SAMPLE_* bits, not kept by the stores **/
+	uint8_t temperatureStatus;
+} Sample_TypeDef;
+
+/*!
+ * @brief Converts a float reading to hundredths, mapping NAN to SAMPLE_INVALID
+ */
+static inline int16_t Sample_FromFloat(float value) {
+	if (isnan(value))
+		return SAMPLE_INVALID;
+	return (int16_t)lrintf(value * 100.0f);
+}
+
+/*!
+ * @brief Converts hundredths back to a float, mapping SAMPLE_INVALID to NAN
+ */
+static inline float Sample_ToFloat(int16_t value) {
+	if (value == SAMPLE_INVALID)
+		return NAN;
+	return value / 100.0f;
+}
+
+#endif /* SAMPLE_H_ */
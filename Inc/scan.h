@@ -0,0 +1,139 @@
+/*!
+ * @file scan.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Background discovery of the devices on I2C2-I2C4, and behind any
+ * TCA9548A multiplexers on them.
+ *
+ * A pass runs on all buses side by side, one transfer in flight per bus,
+ * started with I2CReg_Start() from Scan_Poll() in the main loop, so boot
+ * does not wait for it and the time spent on empty addresses never blocks
+ * anything. Each bus goes through:
+ *  - 0x70-0x77: a write of 0 to the control register, which finds the
+ *    muxes and switches all their channels off, so the direct probes below
+ *    only see the devices on the bus itself;
+ *  - SCAN_FIRST-SCAN_LAST: an address-only write per address. An ACK at
+ *    0x40 or 0x41 is followed by the electronic ID 2 command and a one-byte
+ *    read of SNB_3, which Si7021_ModelFromId() turns into the Si70xx
+ *    variant, as Si7021_Begin() does;
+ *  - then every channel of every mux found: the same probes, skipping the
+ *    addresses already seen directly.
+ * A probe not done within SCAN_TIMEOUT_MS (a device stretching the clock,
+ * a bus held low) is aborted and taken as absent.
+ *
+ * Si70xx sensors are added to the acquisition as they are identified, mux
+ * channel included, so a sensor plugged in while running is picked up by
+ * the next pass, SCAN_PERIOD_MS after the last one. The scan starts no
+ * transfer while an acquisition cycle runs. Everything that answered is
+ * kept in a table with the number of the pass it last answered in.
+ *
+ * I2C1 is not scanned: the primary sensor's blocking reads run there from
+ * App_Sample(), and a probe in flight would make them fail.
+ */
+
+#ifndef SCAN_H_
+#define SCAN_H_
+
+#include "acquire.h"
+
+/*!
+ * Compile-time configuration
+ */
+#define SCAN_FIRST			0x08U	/**< 0x00-0x07 are reserved addresses **/
+#define SCAN_LAST			0x77U	/**< 0x78-0x7F are reserved addresses **/
+#define SCAN_MUX_FIRST		MUX_DEFAULT_ADDRESS
+#define SCAN_MUX_LAST		(MUX_DEFAULT_ADDRESS + 7U)
+#ifndef SCAN_PERIOD_MS
+#define SCAN_PERIOD_MS		10000U	/**< From the end of one pass to the next **/
+#endif
+#ifndef SCAN_TIMEOUT_MS
+#define SCAN_TIMEOUT_MS		2U		/**< Per transfer **/
+#endif
+#ifndef SCAN_MUXES
+#define SCAN_MUXES			ACQUIRE_MUXES
+#endif
+#ifndef SCAN_FOUND
+#define SCAN_FOUND			64U
+#endif
+#define SCAN_DIRECT			0xFFU	/**< Scan_BusTypeDef.mux before the mux walk **/
+#define SCAN_MODEL_MUX		0xFEU	/**< Scan_DeviceTypeDef.model of a multiplexer **/
+#define SCAN_MODEL_OTHER	0xFFU	/**< Not a Si70xx **/
+
+/*!
+ * @typedef Scan_StateTypeDef refers to enum of the steps of a bus's pass
+ */
+typedef enum {
+	SCAN_IDLE,
+	SCAN_MUX,				/**< Control write of 0 to a mux address **/
+	SCAN_PROBE,				/**< Address-only write **/
+	SCAN_ID_COMMAND,		/**< Electronic ID 2 command **/
+	SCAN_ID_READ,			/**< SNB_3 read **/
+	SCAN_ADD,				/**< Waiting for the acquisition to be idle **/
+	SCAN_DONE
+} Scan_StateTypeDef;
+
+/*!
+ * @typedef Scan_BusTypeDef refers to the progress of a pass on one bus
+ */
+typedef struct {
+	I2C_HandleTypeDef *hi2c;
+	uint8_t bus;			/**< 1-4 for I2C1-I2C4 **/
+	uint8_t state;			/**< Scan_StateTypeDef **/
+	uint8_t address;		/**< 7-bit address at hand **/
+	uint8_t mux;			/**< Index of the mux walked, SCAN_DIRECT before **/
+	uint8_t channel;
+	_Bool wire;				/**< A transfer is under way **/
+	Mux_TypeDef *switching;	/**< Mux the transfer under way writes to, 0 for the step's own **/
+	uint8_t data[2];
+	uint32_t started;		/**< Tick the transfer went out **/
+	uint32_t muxes;			/**< Muxes that answered this pass, bit per index **/
+	uint32_t direct[4];		/**< Addresses that answered on the bus itself, bit per address **/
+} Scan_BusTypeDef;
+
+/*!
+ * @typedef Scan_DeviceTypeDef refers to one device that answered
+ */
+typedef struct {
+	uint8_t bus;			/**< 1-4 for I2C1-I2C4 **/
+	uint8_t address;		/**< 7-bit address in [6:0] **/
+	uint8_t mux;			/**< 7-bit address of its mux, 0 if direct **/
+	uint8_t channel;
+	uint8_t model;			/**< Si_SensorTypeDef, SCAN_MODEL_MUX or SCAN_MODEL_OTHER **/
+	uint32_t seen;			/**< Pass it last answered in **/
+} Scan_DeviceTypeDef;
+
+/*!
+ * @typedef Scan_TypeDef refers to the scanner and what it found
+ */
+typedef struct {
+	Acquire_TypeDef *acquire;
+	Scan_BusTypeDef bus[I2C_REG_BUSES];
+	uint8_t buses;
+	Mux_TypeDef mux[SCAN_MUXES];
+	uint8_t muxes;
+	Scan_DeviceTypeDef device[SCAN_FOUND];
+	uint8_t count;
+	_Bool running;
+	uint32_t pass;			/**< Passes started **/
+	uint32_t start;			/**< Tick the pass started **/
+	uint32_t next;			/**< Tick the next pass is due **/
+	uint32_t duration;		/**< Length of the last complete pass, ms **/
+	uint32_t probes;		/**< Transfers, all passes **/
+	uint32_t added;			/**< Sensors handed to the acquisition **/
+} Scan_TypeDef;
+
+extern Scan_TypeDef scan;
+
+/*!
+ * Function prototypes
+ */
+void Scan_Init(Scan_TypeDef *s, Acquire_TypeDef *acquire);
+_Bool Scan_AddBus(Scan_TypeDef *s, I2C_HandleTypeDef *hi2c);
+void Scan_Start(Scan_TypeDef *s);
+_Bool Scan_Poll(Scan_TypeDef *s);
+_Bool Scan_Present(const Scan_TypeDef *s, const Scan_DeviceTypeDef *device);
+
+#endif /* SCAN_H_ */
@@ -17,12 +17,39 @@
 
 #include "main.h"
 #include "stm32f7xx_hal.h"
+#include "breaker.h"
 
 /*!
  * I2C Address
  */
 #define SI7021_DEFAULT_ADDRESS	0x40
 
+/*!
+ * Compile-time configuration
+ *
+ * SI7021_REGISTER_I2C sends the transfers through the register-level driver
+ * in i2c_reg.h instead of HAL_I2C_Master_Transmit/Receive. The host
+ * simulator only models the HAL calls, so it always takes the HAL path.
+ */
+#ifdef SIM_HOST
+#undef SI7021_REGISTER_I2C
+#define SI7021_REGISTER_I2C		0
+#endif
+#ifndef SI7021_REGISTER_I2C
+#define SI7021_REGISTER_I2C		1
+#endif
+
+/*!
+ * Every transfer goes through the handle's circuit breaker (breaker.h): once
+ * the sensor has failed BREAKER_THRESHOLD transfers in a row, transfers fail
+ * at once without touching the bus, and after the backoff interval one
+ * HAL_I2C_IsDeviceReady() probe, with SI7021_PROBE_TIMEOUT_MS in place of
+ * the 100 ms transfer timeout, decides whether the next transfer is tried.
+ */
+#ifndef SI7021_PROBE_TIMEOUT_MS
+#define SI7021_PROBE_TIMEOUT_MS	2U
+#endif
+
 /*!
  * I2C Commands
  */
@@ -88,6 +115,28 @@ typedef enum {
 	RES_H11T11
 } Si_ResolutionTypeDef;
 
+/*!
+ * @typedef Si_ChannelTypeDef refers to enum of measurement channels
+ */
+typedef enum {
+	SI_HUMIDITY,
+	SI_TEMPERATURE
+} Si_ChannelTypeDef;
+
+struct __Si7021;
+
+/*!
+ * @typedef Si_ConversionCallbackTypeDef refers to the hook run on each new code
+ *
+ * Called from the read functions as soon as a conversion result has been
+ * received, before it is converted to float, with the raw 16-bit code and the
+ * DWT cycle stamp of its last byte arriving: the last RXNE on the register
+ * path (the STOP in its DMA mode), the return from HAL_I2C_Master_Receive,
+ * which waits for the STOP, on the HAL path.
+ */
+typedef void (*Si_ConversionCallbackTypeDef)(struct __Si7021 *si7021, Si_ChannelTypeDef channel,
+		uint16_t code, uint32_t stamp);
+
 /*!
  * @typedef Si7021 refers to struct __Si7021 containing sensor properties
  */
@@ -100,6 +149,9 @@ typedef struct __Si7021 {
 	uint8_t  _i2caddr;
 	uint32_t sernum_a; /**< Serial number A */
 	uint32_t sernum_b; /**< Serial number B */
+	Si_ConversionCallbackTypeDef conversion; /**< Optional, see Si7021_SetConversionCallback */
+	Breaker_TypeDef breaker; /**< Health of the link */
+	uint32_t _received; /**< DWT stamp of the last byte of the latest receive */
 } Si7021_TypeDef;
 
 /*!
@@ -112,12 +164,17 @@ _Bool Si7021_SetResolution(Si7021_TypeDef *si7021, Si_ResolutionTypeDef res);
 float Si7021_ReadHumidity(Si7021_TypeDef *si7021);
 float Si7021_ReadPrevTemperature(Si7021_TypeDef *si7021);
 float Si7021_ReadTemperature(Si7021_TypeDef *si7021);
+float Si7021_ConvertHumidity(uint16_t code);
+float Si7021_ConvertTemperature(uint16_t code);
 Si_SensorTypeDef Si7021_GetModel(Si7021_TypeDef *si7021);
+Si_SensorTypeDef Si7021_ModelFromId(uint8_t snb3);
 Si_ResolutionTypeDef Si7021_GetResolution(Si7021_TypeDef *si7021);
 uint8_t Si7021_GetRevision(Si7021_TypeDef *si7021);
 uint8_t Si7021_HeaterStatus(Si7021_TypeDef *si7021);
+uint8_t Si7021_ReadUserRegister(Si7021_TypeDef *si7021);
 void Si7021_Init(Si7021_TypeDef *si7021, I2C_HandleTypeDef *hi2c, uint8_t i2caddr);
-void Si7021_Reset(Si7021_TypeDef *si7021);
+_Bool Si7021_Reset(Si7021_TypeDef *si7021);
+void Si7021_SetConversionCallback(Si7021_TypeDef *si7021, Si_ConversionCallbackTypeDef callback);
 
 
 #endif /* SI7021_H_ */
@@ -56,7 +56,11 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void EXTI15_10_IRQHandler(void);
+void TIM7_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void FLASH_IRQHandler(void);
+void DMA1_Stream4_IRQHandler(void);
+void UART4_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -0,0 +1,131 @@
+/*!
+ * @file tsdb.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Compressed in-RAM time series of humidity/temperature samples, one store
+ * per sensor, in the style of Facebook's Gorilla.
+ *
+ * Samples are packed into fixed-size blocks arranged as a ring; when the
+ * ring is full the oldest block is recycled. Each block opens with one
+ * uncompressed sample in its header and then holds a bit stream of records,
+ * so any block decodes on its own:
+ *
+ *  - run:    '0' + Elias-gamma(n). n samples with the same interval and
+ *            unchanged values. The run is only counted in RAM until
+ *            something changes, so a steady signal costs nothing per sample.
+ *  - change: '1' + timestamp + humidity + temperature, where
+ *            timestamp is the delta-of-delta of the sample time:
+ *              '0' (0) | '10' + 7b | '110' + 14b zigzag | '111' + 32b delta
+ *            and each value is its zigzagged delta to the previous one:
+ *              '0' (0) | '10' + 2b (1-4) | '110' + 5b | '1110' + 9b | '1111' + 17b
+ *
+ * Values are stored in steps of TSDB_QUANTUM hundredths, and a channel
+ * keeps its previous step until the input moves more than TSDB_HYSTERESIS
+ * away from it, so decoded values are within TSDB_HYSTERESIS of what was
+ * appended. The defaults (0.1 step, 0.1 band) match the resolution the UART
+ * report prints and are well inside the sensor's accuracy (+/-3 %RH,
+ * +/-0.4 C). Without the band, sensor noise flickering across a step
+ * boundary turns most samples into change records.
+ *
+ * Append is O(1): it writes at most a pending run and one change record
+ * (110 bits), and opens a new block when fewer than TSDB_RUN_BITS +
+ * TSDB_CHANGE_BITS bits remain.
+ *
+ * Decoding is sequential from the oldest block. A cursor stays valid across
+ * appends and picks up samples added after it reached the end; if the
+ * block under it is recycled it jumps to the oldest remaining block.
+ *
+ * Measured with bench_kernels (Sim/readme.md) on 31 days of a 1 Hz diurnal
+ * signal with datasheet-level noise: 0.022 bytes/sample, so the default
+ * 128 KB ring holds ~70 days per sensor. A 0.07 band gives 0.11 bytes/sample
+ * (~14 days); a signal that changes faster shortens it further.
+ */
+
+#ifndef TSDB_H_
+#define TSDB_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * Compile-time configuration
+ */
+#ifndef TSDB_QUANTUM
+#define TSDB_QUANTUM		10		/**< Stored step in 0.01 units **/
+#endif
+#ifndef TSDB_HYSTERESIS
+#define TSDB_HYSTERESIS		10		/**< Hold band in 0.01 units, >= TSDB_QUANTUM / 2 **/
+#endif
+#ifndef TSDB_BLOCK_BYTES
+#define TSDB_BLOCK_BYTES	1024U	/**< Block size including header **/
+#endif
+#ifndef TSDB_BLOCKS
+#define TSDB_BLOCKS			128U	/**< Blocks per store in the application **/
+#endif
+
+#define TSDB_HEADER_BYTES	16U
+#define TSDB_PAYLOAD_BITS	((TSDB_BLOCK_BYTES - TSDB_HEADER_BYTES) * 8U)
+#define TSDB_RUN_MAX		0xFFFFU
+#define TSDB_RUN_BITS		32U		/**< '0' + gamma(TSDB_RUN_MAX) **/
+#define TSDB_CHANGE_BITS	78U		/**< '1' + 35 + 21 + 21 **/
+
+/*!
+ * @typedef Tsdb_BlockTypeDef refers to one compressed block
+ */
+typedef struct {
+	uint32_t time;			/**< Time of the header sample **/
+	uint32_t count;			/**< Samples in the block, header included **/
+	int16_t humidity;		/**< Header sample, quantized **/
+	int16_t temperature;
+	uint16_t bits;			/**< Bits used in payload **/
+	uint16_t reserved;
+	uint8_t payload[TSDB_BLOCK_BYTES - TSDB_HEADER_BYTES];
+} Tsdb_BlockTypeDef;
+
+/*!
+ * @typedef Tsdb_TypeDef refers to one store
+ */
+typedef struct {
+	Tsdb_BlockTypeDef *block;
+	uint32_t capacity;		/**< Number of blocks **/
+	uint32_t first;			/**< Sequence number of the oldest block **/
+	uint32_t next;			/**< Sequence number after the newest block **/
+	uint32_t count;			/**< Samples held **/
+	uint32_t dropped;		/**< Samples lost to recycled blocks **/
+	uint32_t run;			/**< Unchanged samples not yet written **/
+	uint32_t time;			/**< Last appended sample, values quantized **/
+	uint32_t delta;
+	int16_t humidity;
+	int16_t temperature;
+} Tsdb_TypeDef;
+
+/*!
+ * @typedef Tsdb_CursorTypeDef refers to a sequential read position
+ */
+typedef struct {
+	const Tsdb_TypeDef *db;
+	uint32_t seq;			/**< Block sequence number **/
+	uint32_t bit;			/**< Read position in the payload **/
+	uint32_t run;			/**< Samples left in the current run **/
+	uint32_t taken;			/**< Samples already taken from the store's pending run **/
+	uint32_t time;
+	uint32_t delta;
+	int16_t humidity;
+	int16_t temperature;
+	uint8_t state;
+} Tsdb_CursorTypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Tsdb_Init(Tsdb_TypeDef *db, Tsdb_BlockTypeDef *storage, uint32_t capacity);
+_Bool Tsdb_Append(Tsdb_TypeDef *db, const Sample_TypeDef *sample);
+void Tsdb_Begin(const Tsdb_TypeDef *db, Tsdb_CursorTypeDef *cursor);
+_Bool Tsdb_Next(Tsdb_CursorTypeDef *cursor, Sample_TypeDef *sample);
+uint32_t Tsdb_Count(const Tsdb_TypeDef *db);
+uint32_t Tsdb_Bytes(const Tsdb_TypeDef *db);
+
+#endif /* TSDB_H_ */
@@ -33,6 +33,7 @@
 extern UART_HandleTypeDef huart4;
 
 /* USER CODE BEGIN Private defines */
+extern DMA_HandleTypeDef hdma_uart4_tx;
 
 /* USER CODE END Private defines */
 
@@ -0,0 +1,69 @@
+/*!
+ * @file window.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Windowed aggregate of the sample stream for the UART summary report.
+ *
+ * Samples are folded into the current window as they arrive -- count, min,
+ * max, and mean and spread by Welford's method, so the standard deviation
+ * needs no second pass and does not cancel catastrophically. Windows are
+ * aligned to multiples of their length in App_Time() seconds. The first
+ * sample of a new window closes the previous one and hands it back as a
+ * summary, so one line per window can stand in for every sample in it
+ * while still carrying its extremes. The application feeds it the screened
+ * readings before filtering, for the same reason.
+ *
+ * Unlike the rollups (rollup.h) nothing is retained beyond the window just
+ * closed; this is a reporting aid, not a history.
+ */
+
+#ifndef WINDOW_H_
+#define WINDOW_H_
+
+#include <stdint.h>
+#include "sample.h"
+
+/*!
+ * @typedef Window_StatTypeDef refers to the aggregate of one channel
+ *
+ * min and max are in 0.01 units; mean is in 0.01 units and m2 is the sum
+ * of squared distances from it, as Welford's method keeps them.
+ */
+typedef struct {
+	uint32_t count;
+	int16_t min;
+	int16_t max;
+	float mean;
+	float m2;
+} Window_StatTypeDef;
+
+/*!
+ * @typedef Window_SummaryTypeDef refers to one window's aggregate
+ */
+typedef struct {
+	uint32_t start;					/**< Time of the window's first second **/
+	uint32_t seconds;				/**< Window length **/
+	Window_StatTypeDef humidity;
+	Window_StatTypeDef temperature;
+} Window_SummaryTypeDef;
+
+/*!
+ * @typedef Window_TypeDef refers to the aggregator
+ */
+typedef struct {
+	_Bool open;
+	Window_SummaryTypeDef current;
+} Window_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void Window_Init(Window_TypeDef *w, uint32_t seconds);
+_Bool Window_Add(Window_TypeDef *w, const Sample_TypeDef *sample, Window_SummaryTypeDef *closed);
+float Window_Mean(const Window_StatTypeDef *stat);
+float Window_StdDev(const Window_StatTypeDef *stat);
+
+#endif /* WINDOW_H_ */
@@ -0,0 +1,53 @@
+/*!
+ * @file hal_sim.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Simulator-only controls for the host HAL: virtual clock, bus topology and
+ * UART capture. Everything advances on virtual time; nothing sleeps.
+ *
+ * Bus timing is derived from hi2c->Init.Timing the same way the I2C
+ * peripheral does (PRESC, SCLL, SCLH in TIMINGR against a 54 MHz kernel
+ * clock), so a faster TIMINGR shows up as shorter transfers.
+ */
+
+#ifndef HAL_SIM_H_
+#define HAL_SIM_H_
+
+#include "stm32f7xx_hal.h"
+#include "si7021_model.h"
+#include <stdio.h>
+
+#define SIM_BUS_COUNT			4U
+#define SIM_DEVICES_PER_BUS		8U
+#define SIM_I2C_KERNEL_HZ		54000000U	/**< PCLK1 in SystemClock_Config **/
+
+/*!
+ * @typedef SimStats_TypeDef refers to counters kept by the simulated HAL
+ */
+typedef struct {
+	uint32_t i2cTransfers;
+	uint32_t i2cBytes;
+	uint32_t i2cNacks;
+	uint32_t i2cTimeouts;
+	uint64_t i2cBusyNs;			/**< Virtual time spent inside I2C calls **/
+	uint32_t uartBytes;
+	uint64_t uartBusyNs;		/**< Virtual time spent inside blocking UART calls **/
+} SimStats_TypeDef;
+
+extern SimStats_TypeDef simStats;
+
+/*!
+ * Function prototypes
+ */
+uint64_t SimClock_Now(void);
+void SimClock_Advance(uint64_t ns);
+void SimClock_AdvanceTo(uint64_t ns);
+void SimBus_Attach(uint32_t bus, SiModel_TypeDef *model);
+void SimBus_Detach(uint32_t bus, SiModel_TypeDef *model);
+void SimUart_SetEcho(FILE *out);
+void SimUart_Queue(const uint8_t *data, uint32_t len);
+
+#endif /* HAL_SIM_H_ */
@@ -0,0 +1,88 @@
+/*!
+ * @file si7021_model.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Behavioural model of the Si7021-A20 for the host simulator. The model
+ * answers the same command set as the real part (Si7021-A20 datasheet rev
+ * 1.2, section 5) at the byte level:
+ *
+ *  - measurement commands in hold and no-hold mode, with conversion times
+ *    taken from the datasheet typical column for the active resolution
+ *  - user register 1 with reserved bits preserved and D6 (VDDS) read-only
+ *  - heater control register
+ *  - electronic ID (both accesses, with the interleaved CRC bytes) and the
+ *    firmware revision
+ *  - CRC-8 (x^8 + x^5 + x^4 + 1, init 0x00) on measurement reads
+ *  - soft reset, during which the part does not acknowledge
+ *
+ * Faults can be injected per device, either as the next N transfers or as a
+ * random rate in parts per million.
+ */
+
+#ifndef SI7021_MODEL_H_
+#define SI7021_MODEL_H_
+
+#include <stdint.h>
+
+#define SIMODEL_USER_REG_RESET		0x3AU
+#define SIMODEL_HEATER_REG_RESET	0x00U
+#define SIMODEL_DEVICE_ID_SI7021	0x15U
+#define SIMODEL_FIRMWARE_REV_2		0x20U
+
+/*!
+ * @typedef SiModel_ResultTypeDef refers to how the model answered a transfer
+ */
+typedef enum {
+	SIMODEL_ACK,		/**< Transfer acknowledged **/
+	SIMODEL_NACK,		/**< Address or data not acknowledged **/
+	SIMODEL_STALL		/**< Bus held low until the master times out **/
+} SiModel_ResultTypeDef;
+
+/*!
+ * @typedef SiModel_TypeDef refers to one simulated sensor
+ */
+typedef struct {
+	uint8_t addr;				/**< 7-bit address **/
+	uint8_t userReg;			/**< User register 1 **/
+	uint8_t heaterReg;			/**< Heater control register **/
+	uint8_t firmware;			/**< Firmware revision byte **/
+	uint32_t snA;				/**< Electronic ID SNA_3..SNA_0 **/
+	uint32_t snB;				/**< Electronic ID SNB_3..SNB_0 **/
+
+	float rh;					/**< Ambient relative humidity in % **/
+	float temp;					/**< Ambient temperature in C **/
+
+	uint16_t prevTempCode;		/**< Temperature code from the last RH conversion **/
+	uint8_t resp[8];			/**< Pending read response **/
+	uint8_t respLen;
+	uint8_t hold;				/**< Pending response uses clock stretching **/
+	uint64_t readyAt;			/**< Virtual ns at which the response is ready **/
+	uint64_t resetUntil;		/**< Virtual ns until which the part ignores the bus **/
+
+	uint32_t nackNext;			/**< NACK the next N transfers **/
+	uint32_t stallNext;			/**< Stall the next N transfers **/
+	uint32_t nackPpm;			/**< Random NACK rate **/
+	uint32_t stallPpm;			/**< Random stall rate **/
+	uint32_t rng;
+
+	uint32_t conversions;		/**< Statistics **/
+	uint32_t nacks;
+	uint32_t stalls;
+} SiModel_TypeDef;
+
+/*!
+ * Function prototypes
+ */
+void SiModel_Init(SiModel_TypeDef *m, uint8_t addr, uint32_t seed);
+void SiModel_SetEnvironment(SiModel_TypeDef *m, float rh, float temp);
+SiModel_ResultTypeDef SiModel_Fault(SiModel_TypeDef *m);
+SiModel_ResultTypeDef SiModel_Write(SiModel_TypeDef *m, const uint8_t *data, uint16_t len, uint64_t now);
+SiModel_ResultTypeDef SiModel_Read(SiModel_TypeDef *m, uint8_t *data, uint16_t len, uint64_t now, uint64_t *stretch);
+uint8_t SiModel_Crc8(const uint8_t *data, uint16_t len);
+uint16_t SiModel_HumidityCode(float rh);
+uint16_t SiModel_TemperatureCode(float temp);
+
+#endif /* SI7021_MODEL_H_ */
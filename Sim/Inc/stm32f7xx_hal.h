@@ -0,0 +1,147 @@
+/*!
+ * @file stm32f7xx_hal.h
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Host stand-in for the STM32F7 HAL. It declares just enough of the HAL,
+ * CMSIS and DWT surface for the portable application sources (si7021.c,
+ * app.c, i2c_trace.c and friends) to compile on Linux. The definitions live
+ * in hal_sim.c, which routes I2C traffic to the device models in
+ * si7021_model.c and runs everything on a virtual clock.
+ *
+ * Sim/Inc must come before Inc on the include path so this header shadows
+ * the real one.
+ */
+
+#ifndef SIM_STM32F7XX_HAL_H_
+#define SIM_STM32F7XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SIM_HOST	1
+
+/*!
+ * Common HAL definitions (stm32f7xx_hal_def.h)
+ */
+typedef enum {
+	HAL_OK       = 0x00U,
+	HAL_ERROR    = 0x01U,
+	HAL_BUSY     = 0x02U,
+	HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY	0xFFFFFFFFU
+#define __weak			__attribute__((weak))
+#define UNUSED(X)		(void)X
+
+/*!
+ * I2C (stm32f7xx_hal_i2c.h)
+ */
+#define HAL_I2C_ERROR_NONE		(0x00000000U)
+#define HAL_I2C_ERROR_BERR		(0x00000001U)
+#define HAL_I2C_ERROR_ARLO		(0x00000002U)
+#define HAL_I2C_ERROR_AF		(0x00000004U)
+#define HAL_I2C_ERROR_OVR		(0x00000008U)
+#define HAL_I2C_ERROR_TIMEOUT	(0x00000020U)
+
+typedef struct {
+	uint32_t Timing;
+} I2C_InitTypeDef;
+
+typedef struct {
+	uint32_t bus;				/**< Simulated bus number **/
+} I2C_TypeDef;
+
+extern I2C_TypeDef SimI2C1, SimI2C2, SimI2C3, SimI2C4;
+#define I2C1	(&SimI2C1)
+#define I2C2	(&SimI2C2)
+#define I2C3	(&SimI2C3)
+#define I2C4	(&SimI2C4)
+
+typedef struct __I2C_HandleTypeDef {
+	I2C_TypeDef *Instance;
+	I2C_InitTypeDef Init;
+	volatile uint32_t ErrorCode;
+} I2C_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+
+/*!
+ * GPIO (stm32f7xx_hal_gpio.h); writes land in a plain struct
+ */
+typedef struct {
+	volatile uint32_t BSRR;
+} GPIO_TypeDef;
+
+extern GPIO_TypeDef SimGPIOB;
+#define GPIOB			(&SimGPIOB)
+#define GPIO_PIN_14		((uint16_t)0x4000U)
+
+/*!
+ * DMA (stm32f7xx_hal_dma.h); declared for usart.h, never driven
+ */
+typedef struct {
+	void *Instance;
+} DMA_HandleTypeDef;
+
+/*!
+ * UART (stm32f7xx_hal_uart.h)
+ */
+typedef struct {
+	uint32_t BaudRate;
+} UART_InitTypeDef;
+
+typedef struct {
+	UART_InitTypeDef Init;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+/*!
+ * Time base (stm32f7xx_hal.h)
+ */
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/*!
+ * Core peripherals and intrinsics (core_cm7.h, cmsis_gcc.h)
+ */
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+	volatile uint32_t LAR;
+} DWT_Type;
+
+typedef struct {
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern DWT_Type SimDWT;
+extern CoreDebug_Type SimCoreDebug;
+extern uint32_t SystemCoreClock;
+
+#define DWT							(&SimDWT)
+#define CoreDebug					(&SimCoreDebug)
+#define DWT_CTRL_CYCCNTENA_Msk		(0x1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk	(1UL << 24)
+
+/* The simulator is single-threaded, so exclusives always succeed */
+static inline uint32_t __LDREXW(volatile uint32_t *addr) {
+	return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr) {
+	__atomic_store_n(addr, value, __ATOMIC_RELEASE);
+	return 0U;
+}
+
+static inline void __DMB(void) {
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif /* SIM_STM32F7XX_HAL_H_ */
@@ -0,0 +1,428 @@
+/*!
+ * @file bench_kernels.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Host microbenchmarks for the numeric kernels on the sampling path. Each
+ * kernel is run over a table of synthetic raw codes and reported as ns/op
+ * and heap allocations/op. Kernels that have a reference implementation are
+ * also checked bit-for-bit against it over the full 16-bit code range, so a
+ * rewrite can be validated here before it goes to the board.
+ *
+ * The time-series store (tsdb.c) is benchmarked separately on a synthetic
+ * 1 Hz signal: a diurnal cycle with sensor noise, pushed through the same
+ * code quantization and conversion as a real read. It reports bytes/sample,
+ * append and decode ns/sample and how many days the application's ring
+ * holds, and checks that every sample decodes back within the store's
+ * error bound.
+ *
+ * The psychrometric metrics (psychro.c) are checked over a 0.1 C x 0.1 %RH
+ * grid against the same formulas in double precision with libm, and timed
+ * per sample.
+ *
+ * Usage: bench_kernels [-n iterations] [-k kernel-substring] [-d days]
+ *
+ * Exit status is nonzero if any kernel differs from its reference or the
+ * store does not round-trip or a metric is off by more than its bound.
+ *
+ * Link with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so allocations
+ * are counted; see Sim/readme.md.
+ */
+
+#include "si7021.h"
+#include "si7021_model.h"
+#include "tsdb.h"
+#include "psychro.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define _CODE_TABLE_SIZE	4096U	/**< power of two, stays in L1 **/
+#define _STORE_BLOCKS		8192U	/**< 8 MB, enough that nothing is recycled **/
+
+/*!
+ * @typedef Bench_KernelTypeDef refers to one benchmarked kernel
+ *
+ * run() processes one raw code and returns something derived from the result
+ * so the work cannot be optimised away. When ref() is present, run() must
+ * return the kernel's output bits and ref() the reference output bits.
+ */
+typedef struct {
+	const char *name;
+	uint32_t (*run)(uint16_t code);
+	uint32_t (*ref)(uint16_t code);
+	uint32_t scale;		/**< iterations divisor for slow kernels **/
+} Bench_KernelTypeDef;
+
+static uint16_t codes[_CODE_TABLE_SIZE];
+static char fmtbuf[32];
+static volatile uint32_t sink;
+static uint32_t allocations;
+
+/*!
+ * @brief Required by si7021.c; the kernels never touch the bus
+ */
+void Error_Handler(void) {
+	abort();
+}
+
+/*!
+ * Allocation counting (--wrap)
+ */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+void *__wrap_malloc(size_t size) {
+	allocations++;
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+	allocations++;
+	return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t size) {
+	allocations++;
+	return __real_realloc(p, size);
+}
+
+/*!
+ * Reference implementations, kept verbatim from the original driver
+ */
+
+static float _refHumidity(uint16_t hum) {
+	float humidity = hum;
+	humidity *= 125;
+	humidity /= 65536;
+	humidity -= 6;
+	return humidity;
+}
+
+static float _refTemperature(uint16_t temp) {
+	float temperature = temp;
+	temperature *= 175.72;
+	temperature /= 65536;
+	temperature -= 46.85;
+	return temperature;
+}
+
+static uint32_t _bits(float f) {
+	uint32_t u;
+	memcpy(&u, &f, sizeof(u));
+	return u;
+}
+
+/*!
+ * Kernels
+ */
+
+static uint32_t _humidity(uint16_t code) {
+	return _bits(Si7021_ConvertHumidity(code));
+}
+
+static uint32_t _humidityRef(uint16_t code) {
+	return _bits(_refHumidity(code));
+}
+
+static uint32_t _temperature(uint16_t code) {
+	return _bits(Si7021_ConvertTemperature(code));
+}
+
+static uint32_t _temperatureRef(uint16_t code) {
+	return _bits(_refTemperature(code));
+}
+
+static uint32_t _formatHumidity(uint16_t code) {
+	return (uint32_t)sprintf(fmtbuf, "Humidity: %.1f%%\r\n", Si7021_ConvertHumidity(code));
+}
+
+static uint32_t _formatTemperature(uint16_t code) {
+	return (uint32_t)sprintf(fmtbuf, "PrevTemperature: %.1f C\r\n", Si7021_ConvertTemperature(code));
+}
+
+static uint32_t _formatHeater(uint16_t code) {
+	return (uint32_t)sprintf(fmtbuf, "Heater: %d\r\n\n", code & 0x1F);
+}
+
+static const Bench_KernelTypeDef kernels[] = {
+	{"convert.humidity",     _humidity,          _humidityRef,    1},
+	{"convert.temperature",  _temperature,       _temperatureRef, 1},
+	{"format.humidity",      _formatHumidity,    NULL,            16},
+	{"format.temperature",   _formatTemperature, NULL,            16},
+	{"format.heater",        _formatHeater,      NULL,            16},
+};
+
+/*!
+ * Store
+ */
+
+static uint64_t _hostNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static float _gauss(uint32_t *x) {
+	float sum = 0.0f;
+	for (int i = 0; i < 12; i++) {
+		*x ^= *x << 13;
+		*x ^= *x >> 17;
+		*x ^= *x << 5;
+		sum += (float)(*x >> 8) / 16777216.0f;
+	}
+	return sum - 6.0f;
+}
+
+/*!
+ * @brief Sample at second t of a 22 +/- 3 C, 45 +/- 10 %RH diurnal cycle
+ *
+ * Noise is roughly the datasheet RMS figure at the default resolution
+ * (12-bit RH, 14-bit temperature), and codes are truncated the same way.
+ */
+static void _signal(uint32_t t, uint32_t *rng, Sample_TypeDef *s) {
+	float phase = 2.0f * 3.14159265f * (float)(t % 86400U) / 86400.0f;
+	float temp = 22.0f + 3.0f * sinf(phase) + 0.01f * _gauss(rng);
+	float rh = 45.0f - 10.0f * sinf(phase) + 0.025f * _gauss(rng);
+
+	s->time = t;
+	s->humidity = Sample_FromFloat(Si7021_ConvertHumidity(SiModel_HumidityCode(rh) & 0xFFF0U));
+	s->temperature = Sample_FromFloat(Si7021_ConvertTemperature(SiModel_TemperatureCode(temp) & 0xFFFCU));
+}
+
+static _Bool _within(int16_t decoded, int16_t original) {
+	int32_t error = (int32_t)decoded - original;
+	return error >= -TSDB_HYSTERESIS && error <= TSDB_HYSTERESIS;
+}
+
+/*!
+ * @brief Fills a store with days of 1 Hz samples, then decodes it back
+ * @return Nonzero if a decoded sample is off by more than TSDB_HYSTERESIS
+ */
+static int _benchStore(uint32_t days) {
+	static Tsdb_BlockTypeDef blocks[_STORE_BLOCKS];
+	Tsdb_TypeDef db;
+	Tsdb_CursorTypeDef cursor;
+	Sample_TypeDef s, d;
+	uint32_t n = days * 86400U;
+	uint32_t rng = 0x2545F491U;
+	uint32_t bad = 0;
+
+	Tsdb_Init(&db, blocks, _STORE_BLOCKS);
+
+	uint64_t appendNs = 0;
+	for (uint32_t t = 0; t < n; t++) {
+		_signal(t, &rng, &s);
+		uint64_t start = _hostNs();
+		Tsdb_Append(&db, &s);
+		appendNs += _hostNs() - start;
+	}
+
+	uint32_t decoded = 0;
+	rng = 0x2545F491U;
+	Tsdb_Begin(&db, &cursor);
+	uint64_t start = _hostNs();
+	while (Tsdb_Next(&cursor, &d)) {
+		decoded++;
+	}
+	uint64_t decodeNs = _hostNs() - start;
+
+	Tsdb_Begin(&db, &cursor);
+	for (uint32_t t = 0; t < n; t++) {
+		_signal(t, &rng, &s);
+		if (!Tsdb_Next(&cursor, &d) || d.time != s.time ||
+				!_within(d.humidity, s.humidity) || !_within(d.temperature, s.temperature))
+			bad++;
+	}
+
+	double perSample = (double)Tsdb_Bytes(&db) / (n ? n : 1);
+	double ringDays = (double)TSDB_BLOCKS * TSDB_BLOCK_BYTES / (perSample * 86400.0);
+
+	printf("\n%-24s %12s %10s %12s %12s %10s  %s\n", "store", "samples", "B/sample", "append ns", "decode ns", "ring days", "exact");
+	printf("%-24s %12lu %10.4f %12.1f %12.1f %10.1f  %s\n", "store.tsdb", (unsigned long)n, perSample,
+			(double)appendNs / (n ? n : 1), (double)decodeNs / (decoded ? decoded : 1), ringDays,
+			(bad || decoded != n || db.dropped) ? "FAIL" : "ok");
+	return bad || decoded != n || db.dropped;
+}
+
+/*!
+ * Psychrometrics
+ */
+
+static double _refHeatIndex(double t, double rh) {
+	double f = t * 1.8 + 32.0;
+	double hi = 0.5 * (f + 61.0 + (f - 68.0) * 1.2 + rh * 0.094);
+
+	if ((hi + f) * 0.5 >= 80.0) {
+		hi = -42.379 + 2.04901523 * f + 10.14333127 * rh
+				- 0.22475541 * f * rh - 6.83783e-3 * f * f - 5.481717e-2 * rh * rh
+				+ 1.22874e-3 * f * f * rh + 8.5282e-4 * f * rh * rh
+				- 1.99e-6 * f * f * rh * rh;
+		if (rh < 13.0 && f >= 80.0 && f <= 112.0)
+			hi -= (13.0 - rh) * 0.25 * sqrt((17.0 - fabs(f - 95.0)) / 17.0);
+		else if (rh > 85.0 && f >= 80.0 && f <= 87.0)
+			hi += (rh - 85.0) * 0.1 * (87.0 - f) * 0.2;
+	}
+	return (hi - 32.0) / 1.8;
+}
+
+static int32_t _error(int16_t value, double ref) {
+	double r = ref * 100.0;
+	if (r > INT16_MAX)
+		r = INT16_MAX;
+	if (r < -INT16_MAX)
+		r = -INT16_MAX;
+	int32_t e = (int32_t)value - (int32_t)lrint(r);
+	return e < 0 ? -e : e;
+}
+
+/*!
+ * @brief Checks Psychro_Compute against double-precision formulas
+ * @return Nonzero if any metric is off by more than 0.01
+ */
+static int _benchPsychro(void) {
+	int32_t worst[3] = {0, 0, 0};
+	uint32_t n = 0;
+	Psychro_TypeDef p;
+
+	for (int32_t t = -4000; t <= 8500; t += 10) {
+		for (int32_t h = 100; h <= 10000; h += 10) {
+			double tc = t / 100.0, rh = h / 100.0;
+			double k = 17.62 * tc / (243.12 + tc);
+			double gamma = log(rh / 100.0) + k;
+			double ah = 216.679 * rh / 100.0 * 6.112 * exp(k) / (273.15 + tc);
+
+			Psychro_Compute((int16_t)h, (int16_t)t, &p);
+			int32_t e[3] = {
+				_error(p.dewPoint, 243.12 * gamma / (17.62 - gamma)),
+				_error(p.absHumidity, ah),
+				_error(p.heatIndex, _refHeatIndex(tc, rh)),
+			};
+			for (int i = 0; i < 3; i++) {
+				if (e[i] > worst[i])
+					worst[i] = e[i];
+			}
+			n++;
+		}
+	}
+
+	uint32_t acc = 0;
+	uint64_t start = _hostNs();
+	for (uint32_t i = 0; i < n; i++) {
+		uint16_t c = codes[i & (_CODE_TABLE_SIZE - 1U)];
+		Psychro_Compute((int16_t)(c % 10001U), (int16_t)(c % 12501U) - 4000, &p);
+		acc += (uint16_t)p.dewPoint + (uint16_t)p.absHumidity + (uint16_t)p.heatIndex;
+	}
+	uint64_t elapsed = _hostNs() - start;
+	sink = acc;
+
+	int failed = worst[0] > 1 || worst[1] > 1 || worst[2] > 1;
+	printf("\n%-24s %12s %10s %12s %12s %12s  %s\n", "psychro", "samples", "ns/op", "dew 0.01C", "ah 0.01g", "hi 0.01C", "exact");
+	printf("%-24s %12lu %10.2f %12ld %12ld %12ld  %s\n", "psychro.compute", (unsigned long)n,
+			(double)elapsed / (n ? n : 1), (long)worst[0], (long)worst[1], (long)worst[2],
+			failed ? "FAIL" : "ok");
+	return failed;
+}
+
+/*!
+ * Harness
+ */
+
+/*!
+ * @brief Fills the code table with xorshift codes spanning the full range
+ */
+static void _fillCodes(void) {
+	uint32_t x = 0x9E3779B9U;
+	for (uint32_t i = 0; i < _CODE_TABLE_SIZE; i++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		codes[i] = (uint16_t)x;
+	}
+}
+
+/*!
+ * @brief Compares a kernel against its reference for every 16-bit code
+ * @return Number of mismatching codes
+ */
+static uint32_t _checkExact(const Bench_KernelTypeDef *k, uint16_t *first) {
+	uint32_t mismatches = 0;
+	for (uint32_t code = 0; code <= 0xFFFFU; code++) {
+		if (k->run((uint16_t)code) != k->ref((uint16_t)code)) {
+			if (mismatches++ == 0)
+				*first = (uint16_t)code;
+		}
+	}
+	return mismatches;
+}
+
+int main(int argc, char **argv) {
+	uint32_t iterations = 4000000;
+	uint32_t days = 31;
+	const char *filter = NULL;
+	int failed = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:k:d:")) != -1) {
+		switch (opt) {
+		case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 0); break;
+		case 'k': filter = optarg; break;
+		case 'd': days = (uint32_t)strtoul(optarg, NULL, 0); break;
+		default:
+			fprintf(stderr, "usage: %s [-n iterations] [-k kernel-substring] [-d days]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	_fillCodes();
+	printf("%-24s %12s %10s %12s  %s\n", "kernel", "iterations", "ns/op", "allocs/op", "exact");
+
+	for (size_t i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+		const Bench_KernelTypeDef *k = &kernels[i];
+		if (filter && !strstr(k->name, filter))
+			continue;
+
+		uint32_t n = iterations / k->scale;
+		uint32_t acc = 0;
+		uint32_t allocStart = allocations;
+		uint64_t start = _hostNs();
+		for (uint32_t j = 0; j < n; j++) {
+			acc += k->run(codes[j & (_CODE_TABLE_SIZE - 1U)]);
+		}
+		uint64_t elapsed = _hostNs() - start;
+		sink = acc;
+
+		char exact[40] = "-";
+		if (k->ref) {
+			uint16_t first = 0;
+			uint32_t bad = _checkExact(k, &first);
+			if (bad) {
+				snprintf(exact, sizeof(exact), "FAIL %lu codes, first 0x%04X", (unsigned long)bad, first);
+				failed = 1;
+			}
+			else {
+				snprintf(exact, sizeof(exact), "ok");
+			}
+		}
+
+		printf("%-24s %12lu %10.2f %12.4f  %s\n", k->name, (unsigned long)n,
+				(double)elapsed / (n ? n : 1),
+				(double)(allocations - allocStart) / (n ? n : 1),
+				exact);
+	}
+
+	if ((!filter || strstr("store.tsdb", filter)) && _benchStore(days))
+		failed = 1;
+	if ((!filter || strstr("psychro.compute", filter)) && _benchPsychro())
+		failed = 1;
+
+	return failed ? 3 : 0;
+}
+
+/*! End of file bench_kernels.c **/
@@ -0,0 +1,372 @@
+/*!
+ * @file hal_sim.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Host implementation of the HAL calls used by the application: blocking
+ * I2C master transfers routed to Si7021 models, UART transmit captured to a
+ * stream, and a virtual millisecond tick with a matching DWT cycle counter.
+ *
+ * The started transfers of i2c_reg.h, which acquire.c runs on I2C2-I2C4,
+ * are modelled too: I2CReg_Start() settles the transfer with the device
+ * model as of its STOP and I2CReg_Complete() hands the outcome back once
+ * the virtual clock has passed it. The CPU does not wait on them, so they
+ * do not count toward i2cBusyNs.
+ */
+
+#include "hal_sim.h"
+#include "i2c_reg.h"
+
+#define _START_STOP_BITS	2U		/**< START and STOP conditions, in bit times **/
+
+DWT_Type SimDWT;
+CoreDebug_Type SimCoreDebug;
+GPIO_TypeDef SimGPIOB;
+uint32_t SystemCoreClock = 216000000U;
+SimStats_TypeDef simStats;
+
+I2C_TypeDef SimI2C1 = {0};
+I2C_TypeDef SimI2C2 = {1};
+I2C_TypeDef SimI2C3 = {2};
+I2C_TypeDef SimI2C4 = {3};
+
+static uint64_t _now;				/**< virtual ns **/
+static uint64_t _cycleRemainder;	/**< ns not yet folded into CYCCNT **/
+static SiModel_TypeDef *_bus[SIM_BUS_COUNT][SIM_DEVICES_PER_BUS];
+static FILE *_echo;
+
+/*!
+ * @typedef SimReg_BusTypeDef refers to the started transfer of one bus
+ */
+typedef struct {
+	_Bool busy;
+	uint64_t doneAt;			/**< Virtual ns of the STOP, UINT64_MAX if stalled **/
+	I2CReg_CompletionTypeDef done;
+	I2CReg_CompletionTypeDef queue[I2C_REG_QUEUE];
+	uint32_t head;
+	uint32_t tail;
+} SimReg_BusTypeDef;
+
+static SimReg_BusTypeDef _reg[SIM_BUS_COUNT];
+
+/*!
+ * Static function definitions
+ */
+
+/*!
+ * @brief SCL period in ns for a TIMINGR value, 10 us when unset
+ */
+static uint64_t _bitTimeNs(const I2C_HandleTypeDef *hi2c) {
+	uint32_t timing = hi2c->Init.Timing;
+	if (timing == 0)
+		return 10000U;
+
+	uint64_t presc = ((timing >> 28) & 0x0FU) + 1U;
+	uint64_t sclh = ((timing >> 8) & 0xFFU) + 1U;
+	uint64_t scll = (timing & 0xFFU) + 1U;
+	return presc * (sclh + scll) * 1000000000ULL / SIM_I2C_KERNEL_HZ;
+}
+
+/*!
+ * @brief Time on the wire for an address byte plus len data bytes
+ */
+static uint64_t _transferNs(const I2C_HandleTypeDef *hi2c, uint16_t len) {
+	return ((uint64_t)(1U + len) * 9U + _START_STOP_BITS) * _bitTimeNs(hi2c);
+}
+
+/*!
+ * @brief Finds the model answering at an 8-bit address on the handle's bus
+ */
+static SiModel_TypeDef *_lookup(const I2C_HandleTypeDef *hi2c, uint16_t devAddress) {
+	uint32_t bus = hi2c->Instance ? hi2c->Instance->bus : 0U;
+	if (bus >= SIM_BUS_COUNT)
+		return NULL;
+
+	for (uint32_t i = 0; i < SIM_DEVICES_PER_BUS; i++) {
+		SiModel_TypeDef *m = _bus[bus][i];
+		if (m && m->addr == (devAddress >> 1))
+			return m;
+	}
+	return NULL;
+}
+
+/*!
+ * @brief Applies the outcome of a failed transfer to the handle and clock
+ */
+static HAL_StatusTypeDef _fail(I2C_HandleTypeDef *hi2c, SiModel_ResultTypeDef result, uint32_t timeout) {
+	if (result == SIMODEL_STALL) {
+		SimClock_Advance((uint64_t)timeout * 1000000ULL);
+		hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+		simStats.i2cTimeouts++;
+		return HAL_TIMEOUT;
+	}
+
+	SimClock_Advance(_transferNs(hi2c, 0));
+	hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+	simStats.i2cNacks++;
+	return HAL_ERROR;
+}
+
+/*!
+ * @brief Queues a started transfer's outcome once the clock has passed its STOP
+ */
+static void _retire(SimReg_BusTypeDef *r) {
+	if (!r->busy || _now < r->doneAt)
+		return;
+	r->busy = 0;
+	if (r->head - r->tail < I2C_REG_QUEUE) {
+		/* DWT stamp of the STOP, as the interrupt would have taken it */
+		r->done.stamp = SimDWT.CYCCNT - (uint32_t)((_now - r->doneAt) * (SystemCoreClock / 1000000U) / 1000U);
+		r->queue[r->head % I2C_REG_QUEUE] = r->done;
+		r->head++;
+	}
+}
+
+static SimReg_BusTypeDef *_regBus(const I2C_HandleTypeDef *hi2c) {
+	uint32_t bus = hi2c->Instance ? hi2c->Instance->bus : 0U;
+	return bus < SIM_BUS_COUNT ? &_reg[bus] : NULL;
+}
+
+/*!
+ * Virtual clock
+ */
+
+uint64_t SimClock_Now(void) {
+	return _now;
+}
+
+/*!
+ * @brief Moves virtual time forward and keeps CYCCNT in step
+ * @param ns Nanoseconds to advance
+ */
+void SimClock_Advance(uint64_t ns) {
+	_now += ns;
+	if (SimDWT.CTRL & DWT_CTRL_CYCCNTENA_Msk) {
+		uint64_t total = _cycleRemainder + ns * (SystemCoreClock / 1000000U);
+		SimDWT.CYCCNT += (uint32_t)(total / 1000U);
+		_cycleRemainder = total % 1000U;
+	}
+}
+
+void SimClock_AdvanceTo(uint64_t ns) {
+	if (ns > _now)
+		SimClock_Advance(ns - _now);
+}
+
+/*!
+ * Bus topology
+ */
+
+void SimBus_Attach(uint32_t bus, SiModel_TypeDef *model) {
+	for (uint32_t i = 0; i < SIM_DEVICES_PER_BUS; i++) {
+		if (_bus[bus][i] == NULL) {
+			_bus[bus][i] = model;
+			return;
+		}
+	}
+}
+
+void SimBus_Detach(uint32_t bus, SiModel_TypeDef *model) {
+	for (uint32_t i = 0; i < SIM_DEVICES_PER_BUS; i++) {
+		if (_bus[bus][i] == model)
+			_bus[bus][i] = NULL;
+	}
+}
+
+void SimUart_SetEcho(FILE *out) {
+	_echo = out;
+}
+
+/*!
+ * @brief Captures bytes sent by DMA: counted and echoed, but the CPU does not wait
+ */
+void SimUart_Queue(const uint8_t *data, uint32_t len) {
+	if (_echo) {
+		for (uint32_t i = 0; i < len; i++) {
+			if (data[i] != '\0' && data[i] != '\r')
+				fputc(data[i], _echo);
+		}
+	}
+	simStats.uartBytes += len;
+}
+
+/*!
+ * HAL replacements
+ */
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+	uint64_t start = _now;
+	HAL_StatusTypeDef status = HAL_OK;
+	SiModel_TypeDef *m = _lookup(hi2c, DevAddress);
+	SiModel_ResultTypeDef result = m ? SiModel_Fault(m) : SIMODEL_NACK;
+
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	simStats.i2cTransfers++;
+
+	if (result == SIMODEL_ACK)
+		result = SiModel_Write(m, pData, Size, _now);
+	if (result != SIMODEL_ACK) {
+		status = _fail(hi2c, result, Timeout);
+	}
+	else {
+		SimClock_Advance(_transferNs(hi2c, Size));
+		simStats.i2cBytes += Size;
+	}
+
+	simStats.i2cBusyNs += _now - start;
+	return status;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+	uint64_t start = _now;
+	uint64_t stretch = 0;
+	HAL_StatusTypeDef status = HAL_OK;
+	SiModel_TypeDef *m = _lookup(hi2c, DevAddress);
+	SiModel_ResultTypeDef result = m ? SiModel_Fault(m) : SIMODEL_NACK;
+
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	simStats.i2cTransfers++;
+
+	if (result == SIMODEL_ACK)
+		result = SiModel_Read(m, pData, Size, _now, &stretch);
+	if (result == SIMODEL_ACK && stretch > (uint64_t)Timeout * 1000000ULL)
+		result = SIMODEL_STALL;
+	if (result != SIMODEL_ACK) {
+		status = _fail(hi2c, result, Timeout);
+	}
+	else {
+		SimClock_Advance(stretch + _transferNs(hi2c, Size));
+		simStats.i2cBytes += Size;
+	}
+
+	simStats.i2cBusyNs += _now - start;
+	return status;
+}
+
+/*!
+ * @brief Address-only write per trial, as the HAL does, until one is acknowledged
+ */
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout) {
+	uint64_t start = _now;
+	HAL_StatusTypeDef status = HAL_ERROR;
+	SiModel_TypeDef *m = _lookup(hi2c, DevAddress);
+
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	for (uint32_t trial = 0; trial < Trials && status != HAL_OK; trial++) {
+		SiModel_ResultTypeDef result = m ? SiModel_Fault(m) : SIMODEL_NACK;
+		simStats.i2cTransfers++;
+		if (result == SIMODEL_ACK) {
+			SimClock_Advance(_transferNs(hi2c, 0));
+			hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+			status = HAL_OK;
+		}
+		else {
+			status = _fail(hi2c, result, Timeout);
+		}
+	}
+
+	simStats.i2cBusyNs += _now - start;
+	return status == HAL_OK ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+	(void)Timeout;
+	uint32_t baud = huart->Init.BaudRate ? huart->Init.BaudRate : 9600U;
+	uint64_t busy = (uint64_t)Size * 10U * 1000000000ULL / baud;
+
+	SimUart_Queue(pData, Size);
+	SimClock_Advance(busy);
+	simStats.uartBusyNs += busy;
+	return HAL_OK;
+}
+
+/*!
+ * i2c_reg.h replacements; the blocking calls are the HAL ones
+ */
+
+void I2CReg_Init(I2C_HandleTypeDef *hi2c) {
+	(void)hi2c;
+}
+
+HAL_StatusTypeDef I2CReg_Transmit(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, uint32_t timeout) {
+	return HAL_I2C_Master_Transmit(hi2c, address, data, len, timeout);
+}
+
+HAL_StatusTypeDef I2CReg_Receive(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, uint32_t timeout) {
+	return HAL_I2C_Master_Receive(hi2c, address, data, len, timeout);
+}
+
+HAL_StatusTypeDef I2CReg_Start(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, _Bool rx, uint32_t tag) {
+	SimReg_BusTypeDef *r = _regBus(hi2c);
+	if (!r)
+		return HAL_ERROR;
+	_retire(r);
+	if (r->busy)
+		return HAL_BUSY;
+
+	SiModel_TypeDef *m = _lookup(hi2c, address);
+	SiModel_ResultTypeDef result = m ? SiModel_Fault(m) : SIMODEL_NACK;
+	uint64_t stop = _now + _transferNs(hi2c, len);
+	uint64_t stretch = 0;
+
+	simStats.i2cTransfers++;
+	if (result == SIMODEL_ACK)
+		result = rx ? SiModel_Read(m, data, len, stop, &stretch) : SiModel_Write(m, data, len, stop);
+
+	r->busy = 1;
+	r->done.tag = tag;
+	switch (result) {
+	case SIMODEL_ACK:
+		r->done.error = HAL_I2C_ERROR_NONE;
+		r->doneAt = stop + stretch;
+		simStats.i2cBytes += len;
+		break;
+	case SIMODEL_STALL:
+		/* SCL held low: no STOP until the caller aborts */
+		r->doneAt = UINT64_MAX;
+		simStats.i2cTimeouts++;
+		break;
+	default:
+		r->done.error = HAL_I2C_ERROR_AF;
+		r->doneAt = _now + _transferNs(hi2c, 0);
+		simStats.i2cNacks++;
+		break;
+	}
+	return HAL_OK;
+}
+
+_Bool I2CReg_Complete(I2C_HandleTypeDef *hi2c, I2CReg_CompletionTypeDef *completion) {
+	SimReg_BusTypeDef *r = _regBus(hi2c);
+	if (!r)
+		return 0;
+	_retire(r);
+	if (r->head == r->tail)
+		return 0;
+	*completion = r->queue[r->tail % I2C_REG_QUEUE];
+	r->tail++;
+	return 1;
+}
+
+void I2CReg_Abort(I2C_HandleTypeDef *hi2c) {
+	SimReg_BusTypeDef *r = _regBus(hi2c);
+	if (r)
+		r->busy = 0;
+}
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t)(_now / 1000000ULL);
+}
+
+/*!
+ * @brief Same semantics as the HAL: waits at least Delay + 1 ticks
+ */
+void HAL_Delay(uint32_t Delay) {
+	uint64_t wait = Delay;
+	if (wait < HAL_MAX_DELAY)
+		wait += 1U;
+	SimClock_Advance(wait * 1000000ULL);
+}
+
+/*! End of file hal_sim.c **/
@@ -0,0 +1,332 @@
+/*!
+ * @file si7021_model.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Behavioural Si7021-A20 model for the host simulator. See si7021_model.h.
+ */
+
+#include "si7021_model.h"
+#include <math.h>
+#include <string.h>
+
+#define _NS_PER_US			1000ULL
+#define _RESET_TIME_US		5000ULL		/**< soft reset, typical **/
+
+/*!
+ * Conversion times (typical, us) and resolutions indexed by user register
+ * bits D7:D0, i.e. in Si_ResolutionTypeDef order.
+ */
+static const uint32_t _rhTimeUs[4] = {10000, 2600, 3700, 5800};
+static const uint32_t _tempTimeUs[4] = {7000, 2400, 4000, 1500};
+static const uint8_t _rhBits[4] = {12, 8, 10, 11};
+static const uint8_t _tempBits[4] = {14, 12, 13, 11};
+
+/*!
+ * Static function definitions
+ */
+
+/*!
+ * @brief xorshift32 step for fault injection
+ */
+static uint32_t _random(SiModel_TypeDef *m) {
+	uint32_t x = m->rng;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	m->rng = x;
+	return x;
+}
+
+/*!
+ * @brief Decodes the resolution index from user register bits D7 and D0
+ */
+static uint8_t _resolution(const SiModel_TypeDef *m) {
+	return (uint8_t)(((m->userReg >> 6) & 0x02U) | (m->userReg & 0x01U));
+}
+
+/*!
+ * @brief Truncates a code to the given resolution and applies status bits
+ *
+ * The part returns left-justified codes; the two LSBs are status bits that
+ * read as 10b for RH and 00b for temperature.
+ */
+static uint16_t _quantize(uint16_t code, uint8_t bits, uint16_t status) {
+	uint16_t mask = (uint16_t)(0xFFFFU << (16U - bits));
+	return (uint16_t)((code & mask & 0xFFFCU) | status);
+}
+
+/*!
+ * @brief Temperature seen by the die, including the on-chip heater
+ *
+ * Crude: about 1 C per heater level step plus 0.5 C at level 0.
+ */
+static float _dieTemperature(const SiModel_TypeDef *m) {
+	if (m->userReg & 0x04U)
+		return m->temp + 0.5f + (float)(m->heaterReg & 0x0FU);
+	return m->temp;
+}
+
+/*!
+ * @brief Relative humidity at the die temperature (Magnus saturation curve)
+ */
+static float _dieHumidity(const SiModel_TypeDef *m) {
+	float t = _dieTemperature(m);
+	if (t == m->temp)
+		return m->rh;
+	float es = expf(17.62f * m->temp / (243.12f + m->temp));
+	float esDie = expf(17.62f * t / (243.12f + t));
+	return m->rh * es / esDie;
+}
+
+/*!
+ * @brief Queues a 16-bit code followed by its CRC as the read response
+ */
+static void _queueCode(SiModel_TypeDef *m, uint16_t code) {
+	m->resp[0] = (uint8_t)(code >> 8);
+	m->resp[1] = (uint8_t)(code & 0xFF);
+	m->resp[2] = SiModel_Crc8(m->resp, 2);
+	m->respLen = 3;
+}
+
+/*!
+ * @brief Queues the first electronic ID access: SNA bytes with running CRC
+ */
+static void _queueId1(SiModel_TypeDef *m) {
+	uint8_t sna[4] = {m->snA >> 24, m->snA >> 16, m->snA >> 8, m->snA};
+	for (uint8_t i = 0; i < 4; i++) {
+		m->resp[2 * i] = sna[i];
+		m->resp[2 * i + 1] = SiModel_Crc8(sna, i + 1);
+	}
+	m->respLen = 8;
+}
+
+/*!
+ * @brief Queues the second electronic ID access: SNB bytes in pairs with CRC
+ */
+static void _queueId2(SiModel_TypeDef *m) {
+	uint8_t snb[4] = {m->snB >> 24, m->snB >> 16, m->snB >> 8, m->snB};
+	m->resp[0] = snb[0];
+	m->resp[1] = snb[1];
+	m->resp[2] = SiModel_Crc8(snb, 2);
+	m->resp[3] = snb[2];
+	m->resp[4] = snb[3];
+	m->resp[5] = SiModel_Crc8(snb, 4);
+	m->respLen = 6;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Powers up a model in its reset state
+ * @param *m Pointer to the model
+ * @param addr 7-bit address
+ * @param seed Fault injection seed, must be nonzero
+ */
+void SiModel_Init(SiModel_TypeDef *m, uint8_t addr, uint32_t seed) {
+	memset(m, 0, sizeof(*m));
+	m->addr = addr;
+	m->userReg = SIMODEL_USER_REG_RESET;
+	m->heaterReg = SIMODEL_HEATER_REG_RESET;
+	m->firmware = SIMODEL_FIRMWARE_REV_2;
+	m->snA = 0x1B2C3D4EU ^ seed;
+	m->snB = ((uint32_t)SIMODEL_DEVICE_ID_SI7021 << 24) | 0x00FFB5U;
+	m->rh = 45.0f;
+	m->temp = 22.0f;
+	m->rng = seed ? seed : 1U;
+}
+
+/*!
+ * @brief Sets the ambient conditions the next conversion will report
+ */
+void SiModel_SetEnvironment(SiModel_TypeDef *m, float rh, float temp) {
+	m->rh = rh;
+	m->temp = temp;
+}
+
+/*!
+ * @brief Decides whether the current transfer is hit by an injected fault
+ * @param *m Pointer to the model
+ * @return SIMODEL_ACK if the transfer proceeds normally
+ */
+SiModel_ResultTypeDef SiModel_Fault(SiModel_TypeDef *m) {
+	if (m->stallNext) {
+		m->stallNext--;
+		m->stalls++;
+		return SIMODEL_STALL;
+	}
+	if (m->nackNext) {
+		m->nackNext--;
+		m->nacks++;
+		return SIMODEL_NACK;
+	}
+	if (m->stallPpm && (_random(m) % 1000000U) < m->stallPpm) {
+		m->stalls++;
+		return SIMODEL_STALL;
+	}
+	if (m->nackPpm && (_random(m) % 1000000U) < m->nackPpm) {
+		m->nacks++;
+		return SIMODEL_NACK;
+	}
+	return SIMODEL_ACK;
+}
+
+/*!
+ * @brief Handles a master write (command plus optional data byte)
+ * @param *m Pointer to the model
+ * @param *data Bytes following the address byte
+ * @param len Number of bytes, 0 for an address-only probe
+ * @param now Virtual time in ns
+ * @return SIMODEL_ACK or SIMODEL_NACK
+ */
+SiModel_ResultTypeDef SiModel_Write(SiModel_TypeDef *m, const uint8_t *data, uint16_t len, uint64_t now) {
+	if (now < m->resetUntil)
+		return SIMODEL_NACK;
+	if (len == 0)
+		return SIMODEL_ACK;
+
+	uint8_t res = _resolution(m);
+	m->respLen = 0;
+	m->hold = 0;
+	m->readyAt = now;
+
+	switch (data[0]) {
+	case 0xE5: /* measure RH, hold */
+	case 0xF5: /* measure RH, no hold */
+		_queueCode(m, _quantize(SiModel_HumidityCode(_dieHumidity(m)), _rhBits[res], 0x02U));
+		m->prevTempCode = _quantize(SiModel_TemperatureCode(_dieTemperature(m)), _tempBits[res], 0x00U);
+		m->readyAt = now + (uint64_t)(_rhTimeUs[res] + _tempTimeUs[res]) * _NS_PER_US;
+		m->hold = (data[0] == 0xE5);
+		m->conversions++;
+		break;
+	case 0xE3: /* measure temperature, hold */
+	case 0xF3: /* measure temperature, no hold */
+		_queueCode(m, _quantize(SiModel_TemperatureCode(_dieTemperature(m)), _tempBits[res], 0x00U));
+		m->readyAt = now + (uint64_t)_tempTimeUs[res] * _NS_PER_US;
+		m->hold = (data[0] == 0xE3);
+		m->conversions++;
+		break;
+	case 0xE0: /* temperature from previous RH conversion, no CRC */
+		m->resp[0] = (uint8_t)(m->prevTempCode >> 8);
+		m->resp[1] = (uint8_t)(m->prevTempCode & 0xFF);
+		m->respLen = 2;
+		break;
+	case 0xFE: /* reset */
+		m->userReg = SIMODEL_USER_REG_RESET;
+		m->heaterReg = SIMODEL_HEATER_REG_RESET;
+		m->resetUntil = now + _RESET_TIME_US * _NS_PER_US;
+		break;
+	case 0xE6: /* write user register 1: D7, D2 and D0 are writable */
+		if (len < 2)
+			return SIMODEL_NACK;
+		m->userReg = (uint8_t)((m->userReg & ~0x85U) | (data[1] & 0x85U));
+		break;
+	case 0xE7: /* read user register 1 */
+		m->resp[0] = m->userReg;
+		m->respLen = 1;
+		break;
+	case 0x51: /* write heater control register */
+		if (len < 2)
+			return SIMODEL_NACK;
+		m->heaterReg = data[1] & 0x0FU;
+		break;
+	case 0x11: /* read heater control register */
+		m->resp[0] = m->heaterReg;
+		m->respLen = 1;
+		break;
+	case 0xFA: /* electronic ID, first access */
+		if (len < 2 || data[1] != 0x0F)
+			return SIMODEL_NACK;
+		_queueId1(m);
+		break;
+	case 0xFC: /* electronic ID, second access */
+		if (len < 2 || data[1] != 0xC9)
+			return SIMODEL_NACK;
+		_queueId2(m);
+		break;
+	case 0x84: /* firmware revision */
+		if (len < 2 || data[1] != 0xB8)
+			return SIMODEL_NACK;
+		m->resp[0] = m->firmware;
+		m->respLen = 1;
+		break;
+	default:
+		return SIMODEL_NACK;
+	}
+
+	return SIMODEL_ACK;
+}
+
+/*!
+ * @brief Handles a master read
+ * @param *m Pointer to the model
+ * @param *data Buffer for the returned bytes
+ * @param len Number of bytes the master clocks out
+ * @param now Virtual time in ns
+ * @param *stretch Set to the clock stretching time in ns
+ * @return SIMODEL_ACK, or SIMODEL_NACK while a no-hold conversion is busy
+ *
+ * Bytes past the end of the pending response read as 0xFF.
+ */
+SiModel_ResultTypeDef SiModel_Read(SiModel_TypeDef *m, uint8_t *data, uint16_t len, uint64_t now, uint64_t *stretch) {
+	*stretch = 0;
+	if (now < m->resetUntil)
+		return SIMODEL_NACK;
+	if (now < m->readyAt) {
+		if (!m->hold)
+			return SIMODEL_NACK;
+		*stretch = m->readyAt - now;
+	}
+
+	for (uint16_t i = 0; i < len; i++) {
+		data[i] = (i < m->respLen) ? m->resp[i] : 0xFFU;
+	}
+	m->respLen = 0;
+	m->hold = 0;
+
+	return SIMODEL_ACK;
+}
+
+/*!
+ * @brief Si7021 CRC-8, polynomial 0x31, initial value 0x00
+ */
+uint8_t SiModel_Crc8(const uint8_t *data, uint16_t len) {
+	uint8_t crc = 0x00;
+	for (uint16_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (uint8_t b = 0; b < 8; b++) {
+			crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ 0x31U) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/*!
+ * @brief Inverse of the datasheet RH equation, clamped to the code range
+ */
+uint16_t SiModel_HumidityCode(float rh) {
+	float code = (rh + 6.0f) * 65536.0f / 125.0f;
+	if (code < 0.0f)
+		return 0;
+	if (code > 65535.0f)
+		return 0xFFFFU;
+	return (uint16_t)lrintf(code);
+}
+
+/*!
+ * @brief Inverse of the datasheet temperature equation, clamped to the code range
+ */
+uint16_t SiModel_TemperatureCode(float temp) {
+	float code = (temp + 46.85f) * 65536.0f / 175.72f;
+	if (code < 0.0f)
+		return 0;
+	if (code > 65535.0f)
+		return 0xFFFFU;
+	return (uint16_t)lrintf(code);
+}
+
+/*! End of file si7021_model.c **/
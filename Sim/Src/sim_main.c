@@ -0,0 +1,353 @@
+/*!
+ * @file sim_main.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Host driver for the application loop. Plays the role of main() and
+ * SysTick: runs App_Sample() on the 500 ms virtual tick against a simulated
+ * Si7021 and prints throughput and latency figures at the end.
+ *
+ * Usage: si7021_sim [-n samples] [-r resolution] [-N nack_ppm]
+ *                   [-T timeout_ppm] [-s seed] [-b sensors] [-a] [-q] [-S]
+ *                   [-H] [-v] [-h]
+ *
+ *  -n  run for as long as this many 500 ms ticks take (default 1000)
+ *  -r  Si_ResolutionTypeDef value 0-3 applied after App_Init (default 0)
+ *  -N  random NACK rate per transfer, parts per million
+ *  -T  random bus stall (timeout) rate per transfer, parts per million
+ *  -s  fault injection seed
+ *  -b  add 1-3 sensors on I2C2-I2C4, measured by acquire.c around each
+ *      sample like main() does; faults apply to them too
+ *  -S  measure those sensors one after another instead of all at once
+ *  -a  schedule samples with the adaptive period (App_Cadence) like main()
+ *  -q  steady room with a door opening every 15 minutes instead of the
+ *      default always-moving climate
+ *  -H  stop at the first Error_Handler() like the target does
+ *  -v  echo UART output to stdout
+ *  -h  print the usage line and exit
+ *
+ * Exit status is 0 on success, 2 if Error_Handler() halted the run.
+ */
+
+#include "hal_sim.h"
+#include "app.h"
+#include "i2c.h"
+#include "usart.h"
+#include "i2c_trace.h"
+#include "console.h"
+#include "acquire.h"
+#include <math.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define _TICK_NS		500000000ULL	/**< SysTick sampling period (TICK_PERIOD_MS) **/
+#define _TICK_QUEUE_DEPTH	4U			/**< TICK_QUEUE_DEPTH in main.c **/
+#define _POLL_NS		50000ULL		/**< One pass of the main loop **/
+#define _EXTRA_MAX		3U
+#define _USAGE			"usage: %s [-n samples] [-r res] [-N nack_ppm] [-T timeout_ppm] [-s seed] [-b sensors] [-a] [-q] [-S] [-H] [-v] [-h]\n"
+#define _HELP \
+	"  -n  run for as long as this many 500 ms ticks take (default 1000)\n" \
+	"  -r  resolution 0-3 applied after App_Init (default 0)\n" \
+	"  -N  random NACK rate per transfer, parts per million\n" \
+	"  -T  random bus stall rate per transfer, parts per million\n" \
+	"  -s  fault injection seed\n" \
+	"  -b  add 1-3 sensors on I2C2-I2C4, measured by the acquisition\n" \
+	"  -a  schedule samples with the adaptive period\n" \
+	"  -q  steady room with a door opening every 15 minutes\n" \
+	"  -S  measure the -b sensors one after another\n" \
+	"  -H  stop at the first Error_Handler()\n" \
+	"  -v  echo UART output to stdout\n"
+
+I2C_HandleTypeDef hi2c1;
+static I2C_HandleTypeDef hi2cExtra[_EXTRA_MAX];
+static SiModel_TypeDef extra[_EXTRA_MAX];
+static uint32_t extras = 0;
+static uint64_t tickLast;			/**< Virtual ns of the last tick event **/
+static uint64_t tickPeriod = _TICK_NS;
+static uint32_t tickQueued;
+static uint32_t tickDropped;
+UART_HandleTypeDef huart4;
+
+static SiModel_TypeDef model;
+static jmp_buf recover;
+static _Bool haltOnError = 0;
+static _Bool quietRoom = 0;
+static uint32_t errorHandlerHits = 0;
+
+/*!
+ * @brief Stands in for the target's Error_Handler()
+ *
+ * The target would halt here. By default the simulator counts the hit and
+ * abandons the current sample so a fault-injection run keeps going.
+ */
+void Error_Handler(void) {
+	errorHandlerHits++;
+	if (haltOnError) {
+		fprintf(stderr, "Error_Handler() at %.3f s\n", SimClock_Now() / 1e9);
+		SimUart_SetEcho(stderr);
+		I2CTrace_Dump(&huart4);
+		exit(2);
+	}
+	longjmp(recover, 1);
+}
+
+/*!
+ * @brief Stands in for the console ring: the report leaves by DMA, so it
+ * costs no CPU time, and at 9600 baud the ring drains faster than the
+ * report fills it
+ */
+uint32_t Console_Free(void) {
+	return CONSOLE_TX_SIZE;
+}
+
+_Bool Console_Write(const void *data, uint32_t len) {
+	SimUart_Queue(data, len);
+	return 1;
+}
+
+/*!
+ * @brief Slow synthetic climate: daily-ish swings with a faster wobble
+ */
+static void _environment(uint64_t now) {
+	double t = now / 1e9;
+	float rh = (float)(45.0 + 10.0 * sin(t / 600.0) + 1.5 * sin(t / 7.0));
+	float temp = (float)(22.0 + 2.0 * sin(t / 900.0) + 0.2 * sin(t / 11.0));
+
+	if (quietRoom) {
+		/* Door opens every 900 s: a step that settles back with tau = 120 s */
+		double door = exp(-fmod(t, 900.0) / 120.0);
+		rh = (float)(45.0 + 8.0 * door);
+		temp = (float)(22.0 - 1.5 * door);
+	}
+	SiModel_SetEnvironment(&model, rh, temp);
+	for (uint32_t k = 0; k < extras; k++) {
+		SiModel_SetEnvironment(&extra[k], rh, temp);
+	}
+}
+
+/*!
+ * @brief Runs fn with Error_Handler() unwinding back here
+ * @return 1 if fn returned normally, 0 if Error_Handler() was hit
+ */
+/*!
+ * @brief Plays SysTick up to now: a tick event once the period has passed
+ * since the last one, into a queue of TICK_QUEUE_DEPTH, as in main.c
+ *
+ * Ticks landing during a long sample queue up and are taken back to back;
+ * only those arriving with the queue full are lost.
+ */
+static void _sysTick(uint64_t end) {
+	while (SimClock_Now() - tickLast >= tickPeriod && tickLast + tickPeriod < end) {
+		tickLast += tickPeriod;
+		if (tickQueued < _TICK_QUEUE_DEPTH)
+			tickQueued++;
+		else
+			tickDropped++;
+	}
+}
+
+static _Bool _guarded(void (*fn)(void)) {
+	if (setjmp(recover))
+		return 0;
+	fn();
+	return 1;
+}
+
+static void _appInit(void) {
+	App_Init(&hi2c1);
+}
+
+static uint64_t _hostNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+	uint32_t samples = 1000;
+	uint32_t seed = 1;
+	uint32_t nackPpm = 0, stallPpm = 0;
+	int res = 0;
+	_Bool adaptive = 0;
+	_Bool serial = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:r:N:T:s:b:aqSHvh")) != -1) {
+		switch (opt) {
+		case 'n': samples = (uint32_t)strtoul(optarg, NULL, 0); break;
+		case 'r': res = atoi(optarg) & 0x03; break;
+		case 'N': nackPpm = (uint32_t)strtoul(optarg, NULL, 0); break;
+		case 'T': stallPpm = (uint32_t)strtoul(optarg, NULL, 0); break;
+		case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+		case 'b': extras = (uint32_t)strtoul(optarg, NULL, 0); break;
+		case 'a': adaptive = 1; break;
+		case 'q': quietRoom = 1; break;
+		case 'S': serial = 1; break;
+		case 'H': haltOnError = 1; break;
+		case 'v': SimUart_SetEcho(stdout); break;
+		case 'h':
+			printf(_USAGE, argv[0]);
+			fputs(_HELP, stdout);
+			return 0;
+		default:
+			fprintf(stderr, _USAGE, argv[0]);
+			return 1;
+		}
+	}
+
+	SiModel_Init(&model, SI7021_DEFAULT_ADDRESS, seed);
+	SimBus_Attach(0, &model);
+
+	hi2c1.Instance = I2C1;
+	hi2c1.Init.Timing = 0x00A02353;	/* I2C_TIMING_SPEED from 54 MHz, as main() sets it */
+	huart4.Init.BaudRate = 9600;
+
+	if (extras > _EXTRA_MAX)
+		extras = _EXTRA_MAX;
+	Acquire_Init(&acquire);
+	for (uint32_t k = 0; k < extras; k++) {
+		static I2C_TypeDef *const instances[_EXTRA_MAX] = {I2C2, I2C3, I2C4};
+		SiModel_Init(&extra[k], SI7021_DEFAULT_ADDRESS, seed + k + 1U);
+		SimBus_Attach(k + 1U, &extra[k]);
+		hi2cExtra[k].Instance = instances[k];
+		hi2cExtra[k].Init.Timing = hi2c1.Init.Timing;
+		Acquire_Add(&acquire, &hi2cExtra[k], SI7021_DEFAULT_ADDRESS << 1);
+	}
+
+	I2CTrace_Init();
+	if (!_guarded(_appInit)) {
+		fprintf(stderr, "App_Init() failed\n");
+		return 2;
+	}
+	if (Si7021_SetResolution(&sensor, (Si_ResolutionTypeDef)res) != 1) {
+		fprintf(stderr, "Si7021_SetResolution() failed\n");
+		return 2;
+	}
+
+	/* Faults start once the sensor is configured */
+	model.nackPpm = nackPpm;
+	model.stallPpm = stallPpm;
+	for (uint32_t k = 0; k < extras; k++) {
+		extra[k].nackPpm = nackPpm;
+		extra[k].stallPpm = stallPpm;
+	}
+
+	SimStats_TypeDef base = simStats;
+	uint32_t baseTransfers = I2CTrace_Count();
+	uint64_t latMin = UINT64_MAX, latMax = 0, latSum = 0;
+	tickLast = (SimClock_Now() / _TICK_NS) * _TICK_NS;
+	uint64_t end = tickLast + (uint64_t)(samples + 1U) * _TICK_NS;
+	uint32_t aborted = 0;
+	uint64_t hostNs = 0;
+	uint64_t acqMin = UINT64_MAX, acqMax = 0, acqSum = 0;
+
+	samples = 0;
+	for (;;) {
+		/* The main loop takes one tick event per pass and sleeps through the rest */
+		_sysTick(end);
+		if (!tickQueued) {
+			if (tickLast + tickPeriod >= end)
+				break;
+			SimClock_AdvanceTo(tickLast + tickPeriod);
+			continue;
+		}
+		tickQueued--;
+		_environment(SimClock_Now());
+		samples++;
+
+		/* As in main(): the other buses convert while the primary read blocks */
+		uint64_t start = SimClock_Now();
+		uint32_t next = 1;
+		if (extras)
+			Acquire_Start(&acquire, serial ? ACQUIRE_BIT(0) : ACQUIRE_ALL);
+		uint64_t hostStart = _hostNs();
+		if (!_guarded(App_Sample)) {
+			aborted++;
+		}
+		hostNs += _hostNs() - hostStart;
+		/* Ticks due during the sample went out at the old period; main() then updates samplePeriod */
+		_sysTick(end);
+		tickPeriod = adaptive ? App_Cadence()->period * 1000000ULL : _TICK_NS;
+
+		uint64_t lat = SimClock_Now() - start;
+		latSum += lat;
+		latMin = (lat < latMin) ? lat : latMin;
+		latMax = (lat > latMax) ? lat : latMax;
+
+		if (extras) {
+			for (;;) {
+				if (Acquire_Poll(&acquire)) {
+					if (!serial || next >= acquire.count)
+						break;
+					Acquire_Start(&acquire, ACQUIRE_BIT(next++));
+					continue;
+				}
+				SimClock_Advance(_POLL_NS);
+			}
+			Acquire_Store(&acquire, App_Time());
+			uint64_t acq = SimClock_Now() - start;
+			acqSum += acq;
+			acqMin = (acq < acqMin) ? acq : acqMin;
+			acqMax = (acq > acqMax) ? acq : acqMax;
+		}
+	}
+
+	uint64_t simNs = SimClock_Now();
+	uint32_t transfers = I2CTrace_Count() - baseTransfers;
+	printf("samples            %lu\n", (unsigned long)samples);
+	printf("virtual time       %.3f s\n", simNs / 1e9);
+	printf("sample latency     min %.3f  mean %.3f  max %.3f ms\n",
+			latMin / 1e6, latSum / 1e6 / (samples ? samples : 1), latMax / 1e6);
+	printf("missed ticks       %lu (tick queue full)\n", (unsigned long)tickDropped);
+	if (adaptive) {
+		uint32_t fixed = Adaptive_Fixed(App_Cadence());
+		printf("fixed 500 ms       %lu samples (%.1f%% saved)\n", (unsigned long)fixed,
+				fixed ? 100.0 * ((double)fixed - samples) / fixed : 0.0);
+	}
+	printf("i2c transfers      %lu (%.2f per sample)\n", (unsigned long)transfers, (double)transfers / (samples ? samples : 1));
+	printf("i2c busy           %.3f s\n", (simStats.i2cBusyNs - base.i2cBusyNs) / 1e9);
+	printf("i2c nacks          %lu\n", (unsigned long)(simStats.i2cNacks - base.i2cNacks));
+	printf("i2c timeouts       %lu\n", (unsigned long)(simStats.i2cTimeouts - base.i2cTimeouts));
+	printf("uart bytes         %lu (%.3f s busy)\n", (unsigned long)(simStats.uartBytes - base.uartBytes),
+			(simStats.uartBusyNs - base.uartBusyNs) / 1e9);
+	printf("breaker            %lu trips, %lu transfers refused\n", (unsigned long)sensor.breaker.trips,
+			(unsigned long)sensor.breaker.skipped);
+	if (extras) {
+		uint32_t reads = 0, errors = 0, stored = 0;
+		for (uint32_t k = 0; k < acquire.count; k++) {
+			reads += acquire.device[k].reads;
+			errors += acquire.device[k].errors;
+			if (acquire.device[k].store)
+				stored += Tsdb_Count(acquire.device[k].store);
+		}
+		printf("acquire cycle      min %.3f  mean %.3f  max %.3f ms (%lu sensors, %s)\n",
+				acqMin / 1e6, acqSum / 1e6 / (samples ? samples : 1), acqMax / 1e6,
+				(unsigned long)extras, serial ? "one after another" : "all at once");
+		printf("acquire reads      %lu ok, %lu failed\n", (unsigned long)reads, (unsigned long)errors);
+		printf("acquire stored     %lu samples\n", (unsigned long)stored);
+	}
+	/* The whole run in one query must hold what hour-sized queries hold between them */
+	Rollup_BucketTypeDef whole, part;
+	Rollup_SpanTypeDef span, partSpan;
+	uint32_t to = (App_Time() / 60U + 1U) * 60U;
+	uint32_t buckets = Rollup_Query(&rollup, 0, to, &whole, &span);
+	uint32_t hourly = 0;
+	for (uint32_t t = 0; t < to; t += 3600U) {
+		Rollup_Query(&rollup, t, (to - t > 3600U) ? t + 3600U : to, &part, &partSpan);
+		hourly += part.humidity.count;
+	}
+	printf("rollup query       %lu buckets, %lu readings over %lu-%lu s (%lu s missing), hourly %s\n",
+			(unsigned long)buckets, (unsigned long)whole.humidity.count, (unsigned long)span.from,
+			(unsigned long)span.to, (unsigned long)span.missing,
+			hourly == whole.humidity.count ? "agrees" : "DISAGREES");
+	printf("Error_Handler()    %lu (%lu samples aborted)\n", (unsigned long)errorHandlerHits, (unsigned long)aborted);
+	printf("host cost          %.1f ns/sample\n", (double)hostNs / (samples ? samples : 1));
+
+	return 0;
+}
+
+/*! End of file sim_main.c **/
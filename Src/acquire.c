@@ -0,0 +1,422 @@
+/*!
+ * @file acquire.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Non-blocking Si7021 acquisition over I2C1-I2C4. See acquire.h.
+ */
+
+#include "acquire.h"
+#include "si7021.h"
+#include "cycles.h"
+
+Acquire_TypeDef acquire;
+
+/*!
+ * Static function definitions
+ */
+
+static uint8_t _busNumber(const I2C_TypeDef *i2c) {
+	if (i2c == I2C2)
+		return 2;
+	if (i2c == I2C3)
+		return 3;
+	if (i2c == I2C4)
+		return 4;
+	return 1;
+}
+
+/*!
+ * @brief Sort key of a device: bus, then mux (direct first), then channel
+ */
+static uint32_t _key(const Acquire_DeviceTypeDef *d) {
+	return (uint32_t)d->bus << 16 | (d->mux ? (uint32_t)d->mux->address << 8 | d->channel : 0);
+}
+
+static void _fail(Acquire_DeviceTypeDef *d) {
+	d->humidity = d->temperature = SAMPLE_INVALID;
+	d->fresh = 1;
+	d->errors++;
+	d->wire = 0;
+	if (d->switching)
+		Mux_Invalidate(d->switching);
+	else if (d->mux)
+		Mux_Invalidate(d->mux);
+	d->switching = 0;
+	d->state = ACQUIRE_IDLE;
+	Breaker_Failure(&d->breaker, HAL_GetTick());
+}
+
+static _Bool _transfers(const Acquire_DeviceTypeDef *d) {
+	return d->state == ACQUIRE_PROBE || d->state == ACQUIRE_MEASURE || d->state == ACQUIRE_HUMIDITY ||
+			d->state == ACQUIRE_PREVIOUS || d->state == ACQUIRE_TEMPERATURE;
+}
+
+/*!
+ * @brief Finds the mux write a device needs before its step
+ * @param *channel Set to the channel to select, MUX_OFF for another mux
+ * @return The mux to write, 0 if the device can go on the wire as is
+ */
+static Mux_TypeDef *_switch(const Acquire_TypeDef *a, const Acquire_DeviceTypeDef *d, uint8_t *channel) {
+	/* Sensors behind different muxes share an address; only one mux may be on */
+	for (uint32_t m = 0; m < a->muxes; m++) {
+		if (a->mux[m] != d->mux && a->mux[m]->hi2c == d->hi2c && !Mux_Current(a->mux[m], MUX_OFF)) {
+			*channel = MUX_OFF;
+			return a->mux[m];
+		}
+	}
+	if (d->mux && !Mux_Current(d->mux, d->channel)) {
+		*channel = d->channel;
+		return d->mux;
+	}
+	return 0;
+}
+
+/*!
+ * @brief Starts the transfer of a device's step, or the mux write it needs
+ * first, unless the bus is taken
+ */
+static void _issue(Acquire_TypeDef *a, Acquire_DeviceTypeDef *d, uint32_t tag, uint32_t now) {
+	uint8_t channel;
+	Mux_TypeDef *mux;
+	HAL_StatusTypeDef status;
+	uint16_t len = 1;
+	_Bool rx = 0;
+
+	if (!_transfers(d))
+		return;
+	mux = _switch(a, d, &channel);
+	if (mux) {
+		d->control = Mux_Control(channel);
+		d->switching = mux;
+		status = I2CReg_Start(d->hi2c, mux->address, &d->control, 1, 0, tag);
+		if (status == HAL_BUSY)
+			d->switching = 0;
+	}
+	else {
+		switch (d->state) {
+		case ACQUIRE_PROBE: len = 0; break;
+		case ACQUIRE_MEASURE: d->data[0] = SI7021_MEASRH_NOHOLD_CMD; break;
+		case ACQUIRE_HUMIDITY: len = 3; rx = 1; break;
+		case ACQUIRE_PREVIOUS: d->data[0] = SI7021_READPREVTEMP_CMD; break;
+		default: len = 2; rx = 1; break;
+		}
+		status = I2CReg_Start(d->hi2c, d->address, d->data, len, rx, tag);
+		if (status == HAL_OK && d->mux)
+			d->mux->skipped++;
+	}
+
+	switch (status) {
+	case HAL_OK: d->wire = 1; d->issued = now; break;
+	case HAL_BUSY: break;
+	default: _fail(d); break;
+	}
+}
+
+static uint16_t _code(const Acquire_DeviceTypeDef *d) {
+	return (uint16_t)(d->data[0] << 8 | d->data[1]);
+}
+
+/*!
+ * @brief Moves a device on after its transfer completed
+ */
+static void _complete(Acquire_DeviceTypeDef *d, const I2CReg_CompletionTypeDef *c, uint32_t now) {
+	if (!d->wire)
+		return;				/* left over from an abandoned transfer */
+	d->wire = 0;
+
+	if (d->switching) {
+		if (c->error) {
+			_fail(d);
+			return;
+		}
+		Mux_Written(d->switching, d->control);
+		d->switching = 0;
+		return;				/* the step itself goes next */
+	}
+
+	if (d->state == ACQUIRE_HUMIDITY && c->error == HAL_I2C_ERROR_AF &&
+			(int32_t)(now - d->deadline) < 0) {
+		/* Still converting */
+		d->state = ACQUIRE_CONVERTING;
+		d->due = now + ACQUIRE_RETRY_MS;
+		return;
+	}
+	if (c->error) {
+		_fail(d);
+		return;
+	}
+
+	switch (d->state) {
+	case ACQUIRE_PROBE:
+		d->state = ACQUIRE_MEASURE;
+		break;
+	case ACQUIRE_MEASURE:
+		/* The conversion started at the STOP, which may be a while back if the caller blocked */
+		d->state = ACQUIRE_CONVERTING;
+		d->due = now - Cycles_ToMicros(Cycles_Now() - c->stamp) / 1000U + ACQUIRE_CONVERSION_MS;
+		d->deadline = d->due + ACQUIRE_TIMEOUT_MS;
+		break;
+	case ACQUIRE_HUMIDITY:
+		d->humidity = Sample_FromFloat(Si7021_ConvertHumidity(_code(d)));
+		d->state = ACQUIRE_PREVIOUS;
+		break;
+	case ACQUIRE_PREVIOUS:
+		d->state = ACQUIRE_TEMPERATURE;
+		break;
+	case ACQUIRE_TEMPERATURE:
+		d->temperature = Sample_FromFloat(Si7021_ConvertTemperature(_code(d)));
+		d->reads++;
+		d->fresh = 1;
+		d->state = ACQUIRE_IDLE;
+		Breaker_Success(&d->breaker);
+		break;
+	default:
+		break;
+	}
+}
+
+/*!
+ * @brief Inserts a device in (bus, mux, channel) order and registers its bus
+ * @return The device, or 0 if the list is full or a cycle is running
+ */
+static Acquire_DeviceTypeDef *_insert(Acquire_TypeDef *a, const Acquire_DeviceTypeDef *add) {
+	uint32_t at = a->count;
+
+	if (a->count >= ACQUIRE_DEVICES || a->active || !Acquire_AddBus(a, add->hi2c))
+		return 0;
+
+	while (at > 0 && _key(&a->device[at - 1]) > _key(add)) {
+		a->device[at] = a->device[at - 1];
+		at--;
+	}
+	a->count++;
+
+	Acquire_DeviceTypeDef *d = &a->device[at];
+	*d = *add;
+	d->state = ACQUIRE_IDLE;
+	d->wire = 0;
+	d->switching = 0;
+	d->humidity = d->temperature = SAMPLE_INVALID;
+	d->fresh = 0;
+	d->store = 0;
+	if (a->stores < ACQUIRE_STORES) {
+		d->store = &a->store[a->stores];
+		Tsdb_Init(d->store, a->storeBlock[a->stores], ACQUIRE_STORE_BLOCKS);
+		a->stores++;
+	}
+	d->reads = d->errors = 0;
+	Breaker_Init(&d->breaker);
+	return d;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Clears the device list
+ */
+void Acquire_Init(Acquire_TypeDef *a) {
+	a->count = 0;
+	a->buses = 0;
+	a->muxes = 0;
+	a->active = 0;
+	a->pending = 0;
+	a->cycles = 0;
+	a->listener = 0;
+	a->context = 0;
+	a->stores = 0;
+}
+
+/*!
+ * @brief Has Acquire_Poll() read a bus's completions, with or without devices on it
+ * @param *a Pointer to the acquisition
+ * @param *hi2c Pointer to the bus, after I2CReg_Init
+ * @return 1 if the bus is read, 0 if the list of buses is full
+ */
+_Bool Acquire_AddBus(Acquire_TypeDef *a, I2C_HandleTypeDef *hi2c) {
+	for (uint32_t b = 0; b < a->buses; b++) {
+		if (a->bus[b] == hi2c)
+			return 1;
+	}
+	if (a->buses >= I2C_REG_BUSES)
+		return 0;
+	a->bus[a->buses++] = hi2c;
+	return 1;
+}
+
+/*!
+ * @brief Sets the handler of completions tagged ACQUIRE_TAG_FOREIGN
+ * @param *a Pointer to the acquisition
+ * @param listener Called from Acquire_Poll() with the bus and the completion
+ * @param *context Passed back to the listener
+ */
+void Acquire_SetListener(Acquire_TypeDef *a, Acquire_ListenerTypeDef listener, void *context) {
+	a->listener = listener;
+	a->context = context;
+}
+
+/*!
+ * @brief Adds a sensor
+ * @param *a Pointer to the acquisition
+ * @param *hi2c Pointer to the bus, after I2CReg_Init
+ * @param address 7-bit address in [7:1]
+ * @return 1 if added, 0 if the list is full
+ *
+ * Devices are kept sorted, so the index of one added earlier can change;
+ * add them all before the first Acquire_Start().
+ */
+_Bool Acquire_Add(Acquire_TypeDef *a, I2C_HandleTypeDef *hi2c, uint8_t address) {
+	Acquire_DeviceTypeDef d = {0};
+
+	d.hi2c = hi2c;
+	d.bus = _busNumber(hi2c->Instance);
+	d.address = address;
+	return _insert(a, &d) != 0;
+}
+
+/*!
+ * @brief Adds a sensor behind a multiplexer channel
+ * @param *a Pointer to the acquisition
+ * @param *mux Pointer to the mux, after Mux_Init
+ * @param channel Mux channel, 0-7
+ * @param address 7-bit address in [7:1]
+ * @return 1 if added, 0 if a list is full or the channel is out of range
+ */
+_Bool Acquire_AddMuxed(Acquire_TypeDef *a, Mux_TypeDef *mux, uint8_t channel, uint8_t address) {
+	Acquire_DeviceTypeDef d = {0};
+	uint32_t m = 0;
+
+	if (channel >= MUX_CHANNELS)
+		return 0;
+	while (m < a->muxes && a->mux[m] != mux)
+		m++;
+	if (m == a->muxes && m >= ACQUIRE_MUXES)
+		return 0;
+
+	d.hi2c = mux->hi2c;
+	d.bus = _busNumber(mux->hi2c->Instance);
+	d.address = address;
+	d.mux = mux;
+	d.channel = channel;
+	if (!_insert(a, &d))
+		return 0;
+	if (m == a->muxes)
+		a->mux[a->muxes++] = mux;
+	return 1;
+}
+
+/*!
+ * @brief Starts a measurement on the given devices and returns
+ * @param *a Pointer to the acquisition
+ * @param mask Bit per device, ACQUIRE_ALL for every one
+ *
+ * A device still busy with the previous cycle carries on with that one; a
+ * device whose breaker is open skips the cycle.
+ */
+void Acquire_Start(Acquire_TypeDef *a, uint64_t mask) {
+	uint64_t all = a->count < 64U ? ACQUIRE_BIT(a->count) - 1U : ACQUIRE_ALL;
+
+	a->pending |= mask & all;
+	if (!a->active) {
+		a->active = 1;
+		a->start = Cycles_Now();
+	}
+	Acquire_Poll(a);
+}
+
+/*!
+ * @brief Collects completions and starts the next steps; call from the main loop
+ * @param *a Pointer to the acquisition
+ * @return 1 when no device is in a cycle
+ */
+_Bool Acquire_Poll(Acquire_TypeDef *a) {
+	uint32_t now = HAL_GetTick();
+	I2CReg_CompletionTypeDef c;
+	_Bool busy = 0;
+
+	/* Completions are tagged with the device index; devices on a bus share its queue */
+	for (uint32_t b = 0; b < a->buses; b++) {
+		while (I2CReg_Complete(a->bus[b], &c)) {
+			if (c.tag & ACQUIRE_TAG_FOREIGN) {
+				if (a->listener)
+					a->listener(a->context, a->bus[b], &c);
+			}
+			else if (c.tag < a->count) {
+				_complete(&a->device[c.tag], &c, now);
+			}
+		}
+	}
+
+	for (uint32_t k = 0; k < a->count; k++) {
+		Acquire_DeviceTypeDef *d = &a->device[k];
+		uint64_t bit = ACQUIRE_BIT(k);
+
+		if (d->state == ACQUIRE_IDLE && (a->pending & bit)) {
+			a->pending &= ~bit;
+			if (Breaker_Allow(&d->breaker, now))
+				d->state = d->breaker.state == BREAKER_HALF_OPEN ? ACQUIRE_PROBE : ACQUIRE_MEASURE;
+		}
+		if (d->state == ACQUIRE_CONVERTING && (int32_t)(now - d->due) >= 0)
+			d->state = ACQUIRE_HUMIDITY;
+
+		/* The completions above are in, so a transfer still out this late is stuck */
+		if (d->wire && now - d->issued > ACQUIRE_TIMEOUT_MS) {
+			I2CReg_Abort(d->hi2c);
+			_fail(d);
+		}
+	}
+
+	/* Steps on the channels already selected go first, then the ones needing a switch */
+	for (uint32_t pass = 0; pass < 2; pass++) {
+		for (uint32_t k = 0; k < a->count; k++) {
+			Acquire_DeviceTypeDef *d = &a->device[k];
+			uint8_t channel;
+
+			if (!d->wire && _transfers(d) && (pass || !_switch(a, d, &channel)))
+				_issue(a, d, k, now);
+		}
+	}
+
+	for (uint32_t k = 0; k < a->count; k++) {
+		if (a->device[k].state != ACQUIRE_IDLE)
+			busy = 1;
+	}
+
+	if (a->active && !busy) {
+		a->active = 0;
+		a->cycles = Cycles_Now() - a->start;
+	}
+	return !busy;
+}
+
+/*!
+ * @brief Appends the readings of the cycles ended since the last call to the histories
+ * @param *a Pointer to the acquisition
+ * @param time Sample time of the readings, see App_Time()
+ * @return Number of readings appended
+ */
+uint32_t Acquire_Store(Acquire_TypeDef *a, uint32_t time) {
+	uint32_t stored = 0;
+
+	for (uint32_t k = 0; k < a->count; k++) {
+		Acquire_DeviceTypeDef *d = &a->device[k];
+
+		if (!d->fresh)
+			continue;
+		d->fresh = 0;
+		if (d->store) {
+			Sample_TypeDef s = {0};
+			s.time = time;
+			s.humidity = d->humidity;
+			s.temperature = d->temperature;
+			stored += Tsdb_Append(d->store, &s);
+		}
+	}
+	return stored;
+}
+
+/*! End of file acquire.c **/
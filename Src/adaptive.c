@@ -0,0 +1,111 @@
+/*!
+ * @file adaptive.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Adaptive sampling period. See adaptive.h.
+ */
+
+#include "adaptive.h"
+
+#define _FRAC			8
+#define _EMA_DIV		8
+#define _VARIANCE_MAX	0x3FFFFFFFU
+
+/*!
+ * Static function definitions
+ */
+
+/*!
+ * @brief Updates one channel's statistics
+ * @return True if the channel is active
+ */
+static _Bool _channel(Adaptive_TypeDef *a, uint32_t c, int16_t value, uint32_t dt) {
+	if (value == SAMPLE_INVALID)
+		return 0;
+
+	int32_t scaled = (int32_t)value * (1 << _FRAC);
+	if (a->previous[c] == SAMPLE_INVALID) {
+		a->previous[c] = value;
+		a->mean[c] = scaled;
+		a->variance[c] = 0;
+		return 0;
+	}
+
+	int32_t step = (int32_t)value - a->previous[c];
+	uint32_t change = (uint32_t)(step < 0 ? -step : step);
+	a->previous[c] = value;
+
+	a->mean[c] += (scaled - a->mean[c]) / _EMA_DIV;
+	int32_t d = (scaled - a->mean[c]) / (1 << _FRAC);
+	uint32_t square = (uint32_t)(d * d);
+	if (square > _VARIANCE_MAX)
+		square = _VARIANCE_MAX;
+	a->variance[c] = a->variance[c] - a->variance[c] / _EMA_DIV + square / _EMA_DIV;
+
+	uint32_t deviation = a->config.deviation[c];
+	return (a->config.rate[c] && change * 1000U >= a->config.rate[c] * dt) ||
+			(deviation && a->variance[c] >= deviation * deviation);
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets up the controller, starting at the minimum period
+ */
+void Adaptive_Init(Adaptive_TypeDef *a, const Adaptive_ConfigTypeDef *config) {
+	a->config = *config;
+	a->period = config->minPeriod;
+	a->quiet = 0;
+	a->samples = 0;
+	for (uint32_t c = 0; c < 2U; c++) {
+		a->previous[c] = SAMPLE_INVALID;
+	}
+}
+
+/*!
+ * @brief Feeds one sample and picks the period to the next
+ * @param *a Pointer to the controller
+ * @param *sample Pointer to the sample, preferably filtered
+ * @param now Time of the sample in ms
+ * @return Period to the next sample in ms
+ */
+uint32_t Adaptive_Update(Adaptive_TypeDef *a, const Sample_TypeDef *sample, uint32_t now) {
+	uint32_t dt = a->samples ? now - a->last : a->period;
+	if (!dt)
+		dt = 1;
+	if (!a->samples)
+		a->first = now;
+	a->last = now;
+	a->samples++;
+
+	_Bool active = _channel(a, 0, sample->humidity, dt);
+	active |= _channel(a, 1, sample->temperature, dt);
+
+	if (active) {
+		a->period = a->config.minPeriod;
+		a->quiet = 0;
+	}
+	else if (++a->quiet >= ADAPTIVE_QUIET) {
+		a->period *= 2U;
+		if (a->period > a->config.maxPeriod)
+			a->period = a->config.maxPeriod;
+		a->quiet = 0;
+	}
+	return a->period;
+}
+
+/*!
+ * @brief Samples a fixed ADAPTIVE_REFERENCE_MS cadence would have taken so far
+ */
+uint32_t Adaptive_Fixed(const Adaptive_TypeDef *a) {
+	if (!a->samples)
+		return 0;
+	return (a->last - a->first) / ADAPTIVE_REFERENCE_MS + 1U;
+}
+
+/*! End of file adaptive.c **/
@@ -0,0 +1,121 @@
+/*!
+ * @file alarm.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Threshold alarm on the conversion path. See alarm.h.
+ */
+
+#include "alarm.h"
+#include "cycles.h"
+#include <math.h>
+
+/*!
+ * Static function definitions
+ */
+
+/*!
+ * @brief Inverse of Si7021_ConvertHumidity/Si7021_ConvertTemperature
+ * @param channel Channel the value belongs to
+ * @param value Value in 0.01 units
+ * @return Sensor code as a real number, not yet rounded or clamped
+ */
+static float _code(Si_ChannelTypeDef channel, int32_t value) {
+	if (channel == SI_HUMIDITY)
+		return (value / 100.0f + 6.0f) * (65536.0f / 125.0f);
+	return (value / 100.0f + 46.85f) * (65536.0f / 175.72f);
+}
+
+static uint16_t _clamp(float code) {
+	if (code <= 0.0f)
+		return 0;
+	if (code >= 65535.0f)
+		return 0xFFFFU;
+	return (uint16_t)code;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets up the alarm with every channel disabled and the line low
+ * @param *a Pointer to the alarm
+ * @param *port GPIO port of the output, already configured as an output
+ * @param pin GPIO_PIN_x of the output
+ *
+ * Starts the DWT cycle counter for the latency measurement.
+ */
+void Alarm_Init(Alarm_TypeDef *a, GPIO_TypeDef *port, uint16_t pin) {
+	a->port = port;
+	a->pin = pin;
+	a->checks = 0;
+	a->worst = 0;
+	Cycles_Init();
+	for (uint32_t c = 0; c < ALARM_CHANNELS; c++) {
+		a->config[c].low = a->config[c].high = 0;
+		a->config[c].hysteresis = 0;
+		a->limits[c].enabled = 0;
+		a->state[c] = 0;
+		a->raised[c] = 0;
+	}
+	port->BSRR = (uint32_t)pin << 16;
+}
+
+/*!
+ * @brief Sets a channel's thresholds; the channel leaves alarm until rechecked
+ * @param *a Pointer to the alarm
+ * @param channel Channel to set
+ * @param *config Thresholds in 0.01 units
+ */
+void Alarm_Configure(Alarm_TypeDef *a, Si_ChannelTypeDef channel, const Alarm_ConfigTypeDef *config) {
+	Alarm_LimitsTypeDef *l = &a->limits[channel];
+
+	/* Codes rise with the value, so each compare maps onto one code */
+	a->config[channel] = *config;
+	l->enabled = config->low != config->high;
+	l->highOn = _clamp(ceilf(_code(channel, config->high)));
+	l->highOff = _clamp(ceilf(_code(channel, (int32_t)config->high - config->hysteresis)));
+	l->lowOn = _clamp(floorf(_code(channel, config->low)));
+	l->lowOff = _clamp(floorf(_code(channel, (int32_t)config->low + config->hysteresis)));
+	a->state[channel] = 0;
+}
+
+/*!
+ * @brief Updates a channel from a fresh conversion and drives the line
+ * @param *a Pointer to the alarm
+ * @param channel Channel the code belongs to
+ * @param code Raw 16-bit code as received
+ * @param stamp DWT cycle stamp of the data arriving
+ */
+void Alarm_Check(Alarm_TypeDef *a, Si_ChannelTypeDef channel, uint16_t code, uint32_t stamp) {
+	const Alarm_LimitsTypeDef *l = &a->limits[channel];
+	uint8_t old = a->state[channel];
+	uint8_t state = old;
+
+	if (l->enabled) {
+		if (code >= l->highOn)
+			state |= ALARM_HIGH;
+		else if (code < l->highOff)
+			state &= (uint8_t)~ALARM_HIGH;
+		if (code <= l->lowOn)
+			state |= ALARM_LOW;
+		else if (code > l->lowOff)
+			state &= (uint8_t)~ALARM_LOW;
+	}
+	if (state & ~old)
+		a->raised[channel]++;
+	a->state[channel] = state;
+
+	uint32_t on = a->state[SI_HUMIDITY] | a->state[SI_TEMPERATURE];
+	a->port->BSRR = on ? a->pin : (uint32_t)a->pin << 16;
+
+	uint32_t latency = Cycles_Now() - stamp;
+	if (latency > a->worst)
+		a->worst = latency;
+	a->checks++;
+}
+
+/*! End of file alarm.c **/
@@ -0,0 +1,128 @@
+/*!
+ * @file anomaly.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Per-channel anomaly detector. See anomaly.h.
+ */
+
+#include "anomaly.h"
+
+#define _FRAC			8		/**< Fractional bits of slope and baselines **/
+#define _SLOPE_DIV		8
+#define _FAST_TAU_MS	32000		/**< 1/64 per sample at 2 Hz **/
+#define _SLOW_TAU_MS	2048000		/**< 1/4096 per sample at 2 Hz **/
+
+/*!
+ * Static function definitions
+ */
+
+static int32_t _abs(int32_t x) {
+	return x < 0 ? -x : x;
+}
+
+/*!
+ * @brief Moves a baseline toward x by dt / tau, all of the way past tau
+ */
+static int32_t _ema(int32_t baseline, int32_t x, uint32_t dt, uint32_t tau) {
+	if (dt >= tau)
+		return x;
+	return baseline + (int32_t)((int64_t)(x - baseline) * dt / tau);
+}
+
+static uint8_t _count(Anomaly_TypeDef *a, uint8_t flags) {
+	for (uint32_t k = 0; k < ANOMALY_KINDS; k++) {
+		if (flags & (1U << k))
+			a->flagged[k]++;
+	}
+	return flags;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets a channel's limits and forgets its history
+ */
+void Anomaly_Init(Anomaly_TypeDef *a, const Anomaly_ConfigTypeDef *config) {
+	a->config = *config;
+	a->seen = 0;
+	a->repeats = 0;
+	a->jumped = 0;
+	a->slope = 0;
+	for (uint32_t k = 0; k < ANOMALY_KINDS; k++) {
+		a->flagged[k] = 0;
+	}
+}
+
+/*!
+ * @brief Checks one raw reading
+ * @param *a Pointer to the channel's detector
+ * @param now HAL tick of the reading, ms
+ * @param value Raw reading in 0.01 units, SAMPLE_INVALID for a failed read
+ * @return SAMPLE_* status bits, 0 for a clean reading
+ */
+uint8_t Anomaly_Check(Anomaly_TypeDef *a, uint32_t now, int16_t value) {
+	const Anomaly_ConfigTypeDef *c = &a->config;
+	uint8_t flags = 0;
+
+	if (value == SAMPLE_INVALID)
+		return _count(a, SAMPLE_FAILED);
+
+	int16_t previous = a->previous;
+	a->previous = value;
+	if (a->seen && value == previous) {
+		if (a->repeats < UINT16_MAX)
+			a->repeats++;
+	}
+	else {
+		a->repeats = 0;
+	}
+	if (c->stuck && a->repeats + 1U >= c->stuck)
+		flags |= SAMPLE_STUCK;
+
+	if (c->min != c->max && (value < c->min || value > c->max))
+		return _count(a, flags | SAMPLE_RANGE);
+
+	int32_t scaled = (int32_t)value * (1 << _FRAC);
+	if (!a->seen++) {
+		a->last = value;
+		a->time = now;
+		a->fast = a->slow = scaled;
+		return _count(a, flags);
+	}
+
+	/* A jump stands only once the following sample confirms the new level */
+	int32_t step = (int32_t)value - a->last;
+	if (c->spike && _abs(step) > c->spike) {
+		if (!a->jumped || _abs((int32_t)value - previous) > c->spike) {
+			a->jumped = 1;
+			return _count(a, flags | SAMPLE_SPIKE);
+		}
+		step = 0;
+	}
+	a->jumped = 0;
+
+	uint32_t dt = now - a->time;
+	if (!dt)
+		dt = 1;
+	int32_t rate = (int32_t)((int64_t)step * (1000 << _FRAC) / dt);
+	a->slope += (rate - a->slope) / _SLOPE_DIV;
+	a->last = value;
+	a->time = now;
+	if (c->rate && _abs(a->slope) > (int32_t)c->rate * (1 << _FRAC))
+		flags |= SAMPLE_RATE;
+
+	/* Time constants rather than per-sample weights, so the adaptive cadence does not move them */
+	a->fast = _ema(a->fast, scaled, dt, _FAST_TAU_MS);
+	a->slow = _ema(a->slow, scaled, dt, _SLOW_TAU_MS);
+	if (c->drift && _abs(a->fast - a->slow) > (int32_t)c->drift * (1 << _FRAC))
+		flags |= SAMPLE_DRIFT;
+
+	return _count(a, flags);
+}
+
+/*! End of file anomaly.c **/
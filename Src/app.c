@@ -0,0 +1,396 @@
+/*!
+ * @file app.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Application sampling loop. Reads the Si7021, screens each channel for
+ * anomalies (anomaly.h) and keeps the screened readings in the history,
+ * rollups, percentiles and window. A filtered copy of each channel (see
+ * filter.h) feeds the report and the control loop only. It also derives the
+ * psychrometric metrics (psychro.h), picks the time to the next sample
+ * (adaptive.h) and reports changes over UART4 (report.h), with a summary
+ * line per window (window.h). Daily percentiles are kept alongside
+ * (quantile.h). Threshold alarms on PB14 run straight off the driver's
+ * conversion callback (alarm.h), and App_Control() runs the climate control
+ * loop (control.h) from the TIM7 interrupt.
+ */
+
+#include "app.h"
+#include "console.h"
+#include <stdio.h>
+
+Si7021_TypeDef sensor;
+Tsdb_TypeDef history;
+Rollup_TypeDef rollup;
+uint8_t obufH[32];
+uint8_t obufT[32];
+uint8_t obufS[64];
+uint8_t obufD[48];
+uint8_t obufW[112];
+
+static Sample_TypeDef last;		/**< Filtered, for the report and control **/
+static Sample_TypeDef stored;	/**< Screened but unfiltered, for storage **/
+static Psychro_TypeDef derived;
+static _Bool report = 1;
+static uint32_t timeBase;		/**< App_Time() at tick 0 **/
+static App_ConfigTypeDef config = {
+	0, 8, RES_H12T14, 0,
+	{{FILTER_EMA, 0, 16384, 0, 0}, {FILTER_EMA, 0, 16384, 0, 0}},
+	{{50, 60}, {10, 60}},		/* 0.5 %RH, 0.1 C, a line a minute regardless */
+	60,							/* one summary a minute */
+	{{2000, 7000, 200}, {500, 3500, 50}},	/* 20-70 %RH, 5-35 C */
+	{CONTROL_OFF, -1, 5000, 100.0f, 2.0f, 0.0f, 100, 0}	/* dehumidifier at 50 %RH */
+};
+static Filter_TypeDef filters[APP_CHANNELS];
+static Anomaly_TypeDef anomalies[APP_CHANNELS];
+static Adaptive_TypeDef cadence;
+static Report_TypeDef reports[APP_CHANNELS];
+static uint8_t reportedHeat;
+static Window_TypeDef window;
+static Window_SummaryTypeDef summary;
+static Quantile_TypeDef quantiles[APP_CHANNELS];
+static Alarm_TypeDef alarm;
+static Control_TypeDef control;
+
+/* 0.1 %RH bins from 0 %RH, 0.2 C bins from -40 C; see quantile.h */
+static const Quantile_ConfigTypeDef quantileConfig[APP_CHANNELS] = {
+	{0, 10},
+	{-4000, 20},
+};
+
+/* Active above 0.10 %RH/s or 0.05 C/s, or a scatter of 0.20 %RH or 0.10 C */
+static const Adaptive_ConfigTypeDef cadenceConfig = {
+	ADAPTIVE_MIN_MS, ADAPTIVE_MAX_MS, {10, 5}, {20, 10}
+};
+
+/* min, max, spike, rate/s, drift, stuck samples; see anomaly.h */
+static const Anomaly_ConfigTypeDef anomalyConfig[APP_CHANNELS] = {
+	{-300, 10300, 1000, 100, 1500, 600},
+	{-4000, 12500, 500, 50, 500, 600},
+};
+static Tsdb_BlockTypeDef historyBlocks[TSDB_BLOCKS];
+
+/*!
+ * @brief Runs the alarm on every conversion, from inside the driver's read path
+ */
+static void _conversion(Si7021_TypeDef *si7021, Si_ChannelTypeDef channel, uint16_t code, uint32_t stamp) {
+	(void)si7021;
+	Alarm_Check(&alarm, channel, code, stamp);
+}
+
+/*!
+ * @brief Initializes and probes the sensor
+ * @param *hi2c Pointer to handle of the I2C channel the sensor is on
+ *
+ * A sensor that does not answer leaves the samples invalid rather than
+ * halting the node; its breaker keeps probing for it (see si7021.h).
+ */
+void App_Init(I2C_HandleTypeDef *hi2c) {
+	Tsdb_Init(&history, historyBlocks, TSDB_BLOCKS);
+	Rollup_Init(&rollup);
+	for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+		Filter_Init(&filters[c], &config.filter[c]);
+		Anomaly_Init(&anomalies[c], &anomalyConfig[c]);
+		Report_Init(&reports[c], &config.report[c]);
+		Quantile_Init(&quantiles[c], &quantileConfig[c]);
+	}
+	Adaptive_Init(&cadence, &cadenceConfig);
+	Window_Init(&window, config.window);
+	Control_Init(&control, &config.control);
+	Alarm_Init(&alarm, GPIOB, GPIO_PIN_14);
+	for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+		Alarm_Configure(&alarm, (Si_ChannelTypeDef)c, &config.alarm[c]);
+	}
+	Si7021_Init(&sensor, hi2c, SI7021_DEFAULT_ADDRESS);
+	Si7021_SetConversionCallback(&sensor, _conversion);
+	Si7021_Begin(&sensor);
+}
+
+/*!
+ * @brief Applies a saved configuration and continues a saved time line
+ * @param *saved Configuration to apply to the sensor, after App_Init
+ * @param time Time of the newest saved sample; App_Time() carries on after it
+ *
+ * A resolution or heater setting the sensor does not take is dropped, so
+ * the configuration matches the sensor.
+ */
+void App_Restore(const App_ConfigTypeDef *saved, uint32_t time) {
+	config = *saved;
+	for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+		Filter_Init(&filters[c], &config.filter[c]);
+		Report_Init(&reports[c], &config.report[c]);
+		Alarm_Configure(&alarm, (Si_ChannelTypeDef)c, &config.alarm[c]);
+	}
+	Window_Init(&window, config.window);
+	Control_Configure(&control, &config.control);
+	timeBase = time + 1U - HAL_GetTick() / 1000U;
+
+	if (config.resolution != RES_H12T14 &&
+			Si7021_SetResolution(&sensor, (Si_ResolutionTypeDef)config.resolution) != 1) {
+		config.resolution = Si7021_GetResolution(&sensor);
+	}
+	if (config.heater && Si7021_HeaterOn(&sensor, config.heaterLevel) != 1) {
+		config.heater = sensor.heater;
+	}
+}
+
+/*!
+ * @brief Puts a saved sample back into the history, in time order
+ */
+void App_Replay(const Sample_TypeDef *sample) {
+	last = stored = *sample;
+	Tsdb_Append(&history, &stored);
+	Rollup_Add(&rollup, &stored);
+	Quantile_Add(&quantiles[APP_HUMIDITY], stored.time, stored.humidity);
+	Quantile_Add(&quantiles[APP_TEMPERATURE], stored.time, stored.temperature);
+}
+
+/*!
+ * @brief Screens a raw reading and filters what is fit to keep
+ * @param *raw Receives the unfiltered value, SAMPLE_INVALID if rejected
+ * @return Filtered value, SAMPLE_INVALID if the reading was rejected
+ */
+static int16_t _channel(App_ChannelTypeDef c, float reading, uint32_t now, uint8_t *status, int16_t *raw) {
+	int16_t value = Sample_FromFloat(reading);
+
+	*status = Anomaly_Check(&anomalies[c], now, value);
+	if (*status & ANOMALY_REJECT)
+		value = SAMPLE_INVALID;
+	*raw = value;
+	return Filter_Update(&filters[c], value);
+}
+
+/*!
+ * @brief Sends the window just closed as one line
+ */
+static void _summary(void) {
+	const Window_StatTypeDef *h = &summary.humidity;
+	const Window_StatTypeDef *t = &summary.temperature;
+	int n = sprintf((char *)obufW, "Window: %lu s H: %lu %.1f/%.1f/%.2f/%.2f%% T: %lu %.1f/%.1f/%.2f/%.2f C\r\n\n",
+			(unsigned long)summary.seconds,
+			(unsigned long)h->count, Sample_ToFloat(h->min), Sample_ToFloat(h->max), Window_Mean(h), Window_StdDev(h),
+			(unsigned long)t->count, Sample_ToFloat(t->min), Sample_ToFloat(t->max), Window_Mean(t), Window_StdDev(t));
+	Console_Write(obufW, (uint32_t)n);
+}
+
+/*!
+ * @brief Takes one humidity/temperature sample and reports what changed
+ */
+void App_Sample(void) {
+	float hum = Si7021_ReadHumidity(&sensor);
+	float temp = Si7021_ReadPrevTemperature(&sensor);
+	uint8_t heat = Si7021_HeaterStatus(&sensor);
+	uint32_t now = HAL_GetTick();
+
+	uint32_t time = App_Time();
+
+	last.humidity = _channel(APP_HUMIDITY, hum, now, &last.humidityStatus, &stored.humidity);
+	last.temperature = _channel(APP_TEMPERATURE, temp, now, &last.temperatureStatus, &stored.temperature);
+	/* The time goes last: the control step takes a new time to mean new values */
+	__DMB();
+	last.time = time;
+	stored.time = time;
+	stored.humidityStatus = last.humidityStatus;
+	stored.temperatureStatus = last.temperatureStatus;
+
+	/* Storage and aggregates keep measured values; smoothing would flatten the peaks */
+	Tsdb_Append(&history, &stored);	/* keeps the first sample of each second */
+	Rollup_Add(&rollup, &stored);
+	Quantile_Add(&quantiles[APP_HUMIDITY], stored.time, stored.humidity);
+	Quantile_Add(&quantiles[APP_TEMPERATURE], stored.time, stored.temperature);
+	_Bool closed = Window_Add(&window, &stored, &summary);
+
+	Psychro_Compute(last.humidity, last.temperature, &derived);
+	Adaptive_Update(&cadence, &last, HAL_GetTick());
+
+	if (!report)
+		return;
+	if (closed)
+		_summary();
+
+	_Bool dueH = Report_Due(&reports[APP_HUMIDITY], last.time, last.humidity, last.humidityStatus);
+	_Bool dueT = Report_Due(&reports[APP_TEMPERATURE], last.time, last.temperature, last.temperatureStatus);
+	if (!dueH && !dueT && heat == reportedHeat)
+		return;
+	reportedHeat = heat;
+	int n;
+
+	if (dueH) {
+		n = sprintf((char *)obufH, "Humidity: %.1f%%\r\n", Sample_ToFloat(last.humidity));
+		Console_Write(obufH, (uint32_t)n);
+	}
+
+	if (dueT) {
+		n = sprintf((char *)obufT, "PrevTemperature: %.1f C\r\n", Sample_ToFloat(last.temperature));
+		Console_Write(obufT, (uint32_t)n);
+	}
+
+	n = sprintf((char *)obufD, "DewPoint: %.1f C AH: %.2f g/m3 HI: %.1f C\r\n",
+			Sample_ToFloat(derived.dewPoint), Sample_ToFloat(derived.absHumidity), Sample_ToFloat(derived.heatIndex));
+	Console_Write(obufD, (uint32_t)n);
+
+	n = sprintf((char *)obufS, "Heater: %d Status: %02X %02X Held: %lu %lu\r\n\n", heat,
+			last.humidityStatus, last.temperatureStatus,
+			(unsigned long)reports[APP_HUMIDITY].suppressed, (unsigned long)reports[APP_TEMPERATURE].suppressed);
+	Console_Write(obufS, (uint32_t)n);
+}
+
+/*!
+ * @brief Runs one control loop step on the latest filtered sample
+ * @param stamp DWT cycle stamp of the step
+ * @return Actuator duty in permille
+ *
+ * Called from the TIM7 interrupt; the loop reads one int16_t channel value,
+ * which the sampling loop writes in a single store.
+ */
+uint16_t App_Control(uint32_t stamp) {
+	return Control_Step(&control, &last, stamp);
+}
+
+/*!
+ * @brief Enables or suppresses the UART text report; sampling is unaffected
+ *
+ * The report is queued on the console ring, so the caller enables it only
+ * when Console_Free() has APP_REPORT_MAX bytes.
+ */
+void App_SetReport(_Bool on) {
+	report = on;
+}
+
+/*!
+ * @brief Reporting state of one channel, for its sent/suppressed counters
+ */
+const Report_TypeDef *App_Report(App_ChannelTypeDef channel) {
+	return &reports[channel];
+}
+
+/*!
+ * @brief Summary of the most recently closed window; count 0 before the first
+ */
+const Window_SummaryTypeDef *App_Window(void) {
+	return &summary;
+}
+
+/*!
+ * @brief Daily percentile estimator of one channel
+ */
+const Quantile_TypeDef *App_Quantile(App_ChannelTypeDef channel) {
+	return &quantiles[channel];
+}
+
+/*!
+ * @brief Threshold alarm, for its state, counters and worst-case latency
+ */
+const Alarm_TypeDef *App_Alarm(void) {
+	return &alarm;
+}
+
+/*!
+ * @brief Control loop, for its settings, duty and jitter
+ */
+const Control_TypeDef *App_Controller(void) {
+	return &control;
+}
+
+/*!
+ * @brief Sampling period controller; period is the time to the next sample
+ */
+const Adaptive_TypeDef *App_Cadence(void) {
+	return &cadence;
+}
+
+/*!
+ * @brief Detector of one channel, for its counters
+ */
+const Anomaly_TypeDef *App_Anomaly(App_ChannelTypeDef channel) {
+	return &anomalies[channel];
+}
+
+/*!
+ * @brief Dew point, absolute humidity and heat index of the most recent sample
+ */
+const Psychro_TypeDef *App_LastDerived(void) {
+	return &derived;
+}
+
+/*!
+ * @brief Seconds since boot, continued across resets by App_Restore
+ */
+uint32_t App_Time(void) {
+	return timeBase + HAL_GetTick() / 1000U;
+}
+
+/*!
+ * @brief Current settings, for saving
+ */
+const App_ConfigTypeDef *App_Config(void) {
+	return &config;
+}
+
+/*!
+ * @brief Most recent screened, unfiltered sample in fixed point, for the
+ * storage code
+ */
+const Sample_TypeDef *App_LastSample(void) {
+	return &stored;
+}
+
+/*!
+ * @brief Switches the on-chip heater to the opposite state
+ * @return New heater state -- 0:off, 1:on; unchanged if the sensor did not take it
+ */
+_Bool App_ToggleHeater(void) {
+	if (sensor.heater) {
+		Si7021_HeaterOff(&sensor);
+	}
+	else {
+		Si7021_HeaterOn(&sensor, config.heaterLevel);
+	}
+
+	config.heater = sensor.heater;
+	return sensor.heater;
+}
+
+/*!
+ * @brief Replaces a channel's filter; its history starts afresh
+ */
+void App_SetFilter(App_ChannelTypeDef channel, const Filter_ConfigTypeDef *filter) {
+	Filter_Init(&filters[channel], filter);
+	config.filter[channel] = filters[channel].config;
+}
+
+/*!
+ * @brief Replaces a channel's reporting policy; its next sample is sent
+ */
+void App_SetReportPolicy(App_ChannelTypeDef channel, const Report_ConfigTypeDef *policy) {
+	config.report[channel] = *policy;
+	Report_Init(&reports[channel], policy);
+}
+
+/*!
+ * @brief Sets the summary window length in seconds, 0 to stop summaries
+ */
+void App_SetWindow(uint16_t seconds) {
+	config.window = seconds;
+	Window_Init(&window, seconds);
+}
+
+/*!
+ * @brief Replaces a channel's alarm thresholds; low == high disables it
+ */
+void App_SetAlarm(App_ChannelTypeDef channel, const Alarm_ConfigTypeDef *thresholds) {
+	config.alarm[channel] = *thresholds;
+	Alarm_Configure(&alarm, (Si_ChannelTypeDef)channel, thresholds);
+}
+
+/*!
+ * @brief Replaces the control loop settings; the next step takes them over
+ */
+void App_SetControl(const Control_ConfigTypeDef *settings) {
+	config.control = *settings;
+	Control_Configure(&control, settings);
+}
+
+/*! End of file app.c **/
@@ -0,0 +1,352 @@
+/*!
+ * @file bench.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * On-target benchmark battery. See bench.h.
+ */
+
+#include "bench.h"
+#include "acquire.h"
+#include "cycles.h"
+#include "filter.h"
+#include "i2c_reg.h"
+#include "psychro.h"
+#include "tsdb.h"
+#include <stdio.h>
+#include <string.h>
+
+#define _UART_BYTES		32U		/**< one obuf worth **/
+#define _STORE_BLOCKS	4U
+
+/* Register round trip floors: the wire time plus each path's own set-up
+ * and wind-down per call, which the wire does not hide */
+#define _WIRE_REGISTER8	19200U	/**< Two 20-bit frames of 120 kernel clocks at 400 kHz **/
+#define _HAL_REGISTER8	(_WIRE_REGISTER8 + 2U * 600U)	/**< Lock, state checks, HAL_GetTick() per flag wait **/
+#define _REG_REGISTER8	(_WIRE_REGISTER8 + 2U * 120U)	/**< CR2 write, ISR/STOPF polls **/
+#if SI7021_REGISTER_I2C
+#define _SI_REGISTER8	_REG_REGISTER8
+#else
+#define _SI_REGISTER8	_HAL_REGISTER8
+#endif
+
+/*!
+ * @typedef Bench_ItemTypeDef refers to one timed operation
+ *
+ * baseline is in cycles/op; 0 means none has been recorded yet. The bus
+ * items start from their wire time at the boot configuration (I2C at
+ * I2C_TIMING_SPEED, TIMINGR 0x00A02353 from a 54 MHz kernel clock, UART4 at
+ * 9600 baud, HCLK 216 MHz), which is a floor rather than a measurement.
+ */
+typedef struct {
+	const char *name;
+	uint32_t (*run)(uint32_t i);
+	uint32_t iterations;
+	uint32_t baseline;
+} Bench_ItemTypeDef;
+
+/*!
+ * @typedef Bench_CompareTypeDef refers to two items doing the same work two ways
+ */
+typedef struct {
+	const char *before;
+	const char *after;
+} Bench_CompareTypeDef;
+
+static Si7021_TypeDef *dut;
+static UART_HandleTypeDef *port;
+static char buf[96];
+static volatile uint32_t sink;
+static Tsdb_BlockTypeDef storeBlocks[_STORE_BLOCKS];
+static Tsdb_TypeDef store;
+static Tsdb_CursorTypeDef cursor;
+static Filter_TypeDef filters[4];
+
+static const Filter_ConfigTypeDef filterConfig[4] = {
+	{FILTER_AVERAGE, 8, 0, 0, 0},
+	{FILTER_EMA, 0, 16384, 0, 0},
+	{FILTER_MEDIAN, 5, 0, 0, 0},
+	{FILTER_KALMAN, 0, 0, 1, 200},
+};
+
+/*!
+ * Items
+ */
+
+static uint32_t _bits(float f) {
+	uint32_t u;
+	memcpy(&u, &f, sizeof(u));
+	return u;
+}
+
+static uint32_t _convertHumidity(uint32_t i) {
+	return _bits(Si7021_ConvertHumidity((uint16_t)(i * 2654435761U >> 16)));
+}
+
+static uint32_t _convertTemperature(uint32_t i) {
+	return _bits(Si7021_ConvertTemperature((uint16_t)(i * 2654435761U >> 16)));
+}
+
+static uint32_t _formatHumidity(uint32_t i) {
+	return (uint32_t)sprintf(buf, "Humidity: %.1f%%\r\n", Si7021_ConvertHumidity((uint16_t)(i * 2654435761U >> 16)));
+}
+
+static uint32_t _formatTemperature(uint32_t i) {
+	return (uint32_t)sprintf(buf, "PrevTemperature: %.1f C\r\n", Si7021_ConvertTemperature((uint16_t)(i * 2654435761U >> 16)));
+}
+
+/*!
+ * @brief One 1 Hz sample into the time-series store
+ *
+ * Every 8th sample moves a channel by one step so the mix of runs and
+ * change records is close to a real signal.
+ */
+static uint32_t _storeAppend(uint32_t i) {
+	Sample_TypeDef s;
+	s.time = i + 1U;
+	s.humidity = (int16_t)(4500 + 20 * (int32_t)((i >> 3) & 1U));
+	s.temperature = (int16_t)(2200 + 20 * (int32_t)((i >> 4) & 1U));
+	return Tsdb_Append(&store, &s);
+}
+
+/*!
+ * @brief One sequential decode from the store filled by _storeAppend
+ */
+static uint32_t _storeDecode(uint32_t i) {
+	Sample_TypeDef s;
+	(void)i;
+	if (!Tsdb_Next(&cursor, &s)) {
+		Tsdb_Begin(&store, &cursor);
+		Tsdb_Next(&cursor, &s);
+	}
+	return s.time;
+}
+
+/*!
+ * @brief One sample through each filter kind, noise of +-1.28 around 22.00
+ */
+static int16_t _filterInput(uint32_t i) {
+	return (int16_t)(2200 + (int32_t)((i * 2654435761U) >> 24) - 128);
+}
+
+static uint32_t _filterAverage(uint32_t i) {
+	return (uint32_t)Filter_Update(&filters[0], _filterInput(i));
+}
+
+static uint32_t _filterEma(uint32_t i) {
+	return (uint32_t)Filter_Update(&filters[1], _filterInput(i));
+}
+
+static uint32_t _filterMedian(uint32_t i) {
+	return (uint32_t)Filter_Update(&filters[2], _filterInput(i));
+}
+
+static uint32_t _filterKalman(uint32_t i) {
+	return (uint32_t)Filter_Update(&filters[3], _filterInput(i));
+}
+
+/*!
+ * @brief Dew point, absolute humidity and heat index of one sample
+ */
+static uint32_t _psychro(uint32_t i) {
+	Psychro_TypeDef p;
+	uint32_t h = i * 2654435761U;
+	Psychro_Compute((int16_t)((h >> 16) % 10001U), (int16_t)((h & 0xFFFFU) % 12501U) - 4000, &p);
+	return (uint16_t)p.dewPoint + (uint16_t)p.absHumidity + (uint16_t)p.heatIndex;
+}
+
+/*!
+ * @brief One user register round trip (write command, read one byte)
+ *
+ * Wire time: two 20-bit frames at ~2.2 us/bit = ~89 us = ~19k cycles.
+ */
+static uint32_t _readRegister(uint32_t i) {
+	(void)i;
+	return Si7021_ReadUserRegister(dut);
+}
+
+/*!
+ * @brief The same round trip straight through the HAL calls
+ */
+static uint32_t _halRegister(uint32_t i) {
+	uint8_t data = SI7021_READRHT_REG_CMD;
+	(void)i;
+	HAL_I2C_Master_Transmit(&dut->_hi2c, (uint16_t)dut->_i2caddr, &data, 1, 100);
+	HAL_I2C_Master_Receive(&dut->_hi2c, (uint16_t)dut->_i2caddr, &data, 1, 100);
+	return data;
+}
+
+/*!
+ * @brief The same round trip through the register-level driver
+ */
+static uint32_t _regRegister(uint32_t i) {
+	uint8_t data = SI7021_READRHT_REG_CMD;
+	(void)i;
+	I2CReg_Transmit(&dut->_hi2c, (uint16_t)dut->_i2caddr, &data, 1, 100);
+	I2CReg_Receive(&dut->_hi2c, (uint16_t)dut->_i2caddr, &data, 1, 100);
+	return data;
+}
+
+/*!
+ * @brief One measurement of every additional sensor, one sensor after another
+ *
+ * Per sensor ~23 ms of conversion plus the transfers; three sensors on
+ * I2C2-I2C4 = ~69 ms = ~14.9M cycles.
+ */
+static uint32_t _acquireSerial(uint32_t i) {
+	(void)i;
+	for (uint32_t k = 0; k < acquire.count; k++) {
+		Acquire_Start(&acquire, ACQUIRE_BIT(k));
+		while (!Acquire_Poll(&acquire)) {
+		}
+	}
+	return acquire.device[0].humidity;
+}
+
+/*!
+ * @brief The same measurements with all buses at once: ~23 ms = ~4.95M cycles
+ */
+static uint32_t _acquireConcurrent(uint32_t i) {
+	(void)i;
+	Acquire_Start(&acquire, ACQUIRE_ALL);
+	while (!Acquire_Poll(&acquire)) {
+	}
+	return acquire.device[0].humidity;
+}
+
+/*!
+ * @brief Blocking UART TX of one output buffer
+ *
+ * Wire time: 32 bytes * 10 bits / 9600 baud = 33.3 ms = 7.2M cycles.
+ */
+static uint32_t _uartTx(uint32_t i) {
+	static uint8_t line[_UART_BYTES];
+	line[0] = (uint8_t)i;
+	return (uint32_t)HAL_UART_Transmit(port, line, _UART_BYTES, HAL_MAX_DELAY);
+}
+
+static const Bench_ItemTypeDef items[] = {
+	{"convert.humidity",    _convertHumidity,    1000, 0},
+	{"convert.temperature", _convertTemperature, 1000, 0},
+	{"format.humidity",     _formatHumidity,     100,  0},
+	{"format.temperature",  _formatTemperature,  100,  0},
+	{"tsdb.append",         _storeAppend,        1000, 0},
+	{"tsdb.decode",         _storeDecode,        1000, 0},
+	{"filter.average",      _filterAverage,      1000, 0},
+	{"filter.ema",          _filterEma,          1000, 0},
+	{"filter.median",       _filterMedian,       1000, 0},
+	{"filter.kalman",       _filterKalman,       1000, 0},
+	{"psychro.compute",     _psychro,            1000, 0},
+	{"i2c.readRegister8",   _readRegister,       100,  _SI_REGISTER8},
+	{"i2c.hal.readRegister8", _halRegister,      100,  _HAL_REGISTER8},
+	{"i2c.reg.readRegister8", _regRegister,      100,  _REG_REGISTER8},
+	{"acquire.serial",      _acquireSerial,      4,    14900000},
+	{"acquire.concurrent",  _acquireConcurrent,  4,    4950000},
+	{"uart.tx32",           _uartTx,             4,    7200000},
+};
+
+static const Bench_CompareTypeDef compares[] = {
+	{"i2c.hal.readRegister8", "i2c.reg.readRegister8"},
+	{"acquire.serial",        "acquire.concurrent"},
+};
+
+/*!
+ * Static function definitions
+ */
+
+static void _print(int n) {
+	if (n > (int)sizeof(buf) - 1)
+		n = sizeof(buf) - 1;
+	HAL_UART_Transmit(port, (uint8_t *)buf, (uint16_t)n, HAL_MAX_DELAY);
+}
+
+static int32_t _find(const char *name) {
+	for (uint32_t k = 0; k < sizeof(items) / sizeof(items[0]); k++) {
+		if (!strcmp(items[k].name, name))
+			return (int32_t)k;
+	}
+	return -1;
+}
+
+/*!
+ * @brief Cycles spent by the timing loop itself for n empty iterations
+ */
+static uint32_t _overhead(uint32_t n) {
+	uint32_t start = Cycles_Now();
+	for (volatile uint32_t i = 0; i < n; i++) {
+	}
+	return Cycles_Now() - start;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Runs every benchmark item and reports the results
+ * @param *si7021 Pointer to an initialized sensor for the bus items
+ * @param *huart Pointer to the UART used both as a benchmark and for output
+ */
+void Bench_Run(Si7021_TypeDef *si7021, UART_HandleTypeDef *huart) {
+	uint32_t result[sizeof(items) / sizeof(items[0])];
+
+	dut = si7021;
+	port = huart;
+	Tsdb_Init(&store, storeBlocks, _STORE_BLOCKS);
+	Tsdb_Begin(&store, &cursor);
+	for (uint32_t k = 0; k < 4U; k++) {
+		Filter_Init(&filters[k], &filterConfig[k]);
+	}
+	Cycles_Init();
+
+	for (uint32_t k = 0; k < sizeof(items) / sizeof(items[0]); k++) {
+		const Bench_ItemTypeDef *item = &items[k];
+		uint32_t acc = 0;
+		uint32_t start = Cycles_Now();
+		for (volatile uint32_t i = 0; i < item->iterations; i++) {
+			acc += item->run(i);
+		}
+		uint32_t elapsed = Cycles_Now() - start;
+		uint32_t loop = _overhead(item->iterations);
+		sink = acc;
+
+		result[k] = ((elapsed > loop) ? elapsed - loop : 0U) / item->iterations;
+	}
+
+	for (uint32_t k = 0; k < sizeof(items) / sizeof(items[0]); k++) {
+		const Bench_ItemTypeDef *item = &items[k];
+		int n;
+		if (item->baseline) {
+			int32_t delta = (int32_t)(((int64_t)result[k] - item->baseline) * 100 / item->baseline);
+			n = snprintf(buf, sizeof(buf), "BENCH %s %lu base %lu %+ld%%\r\n", item->name,
+					(unsigned long)result[k], (unsigned long)item->baseline, (long)delta);
+		}
+		else {
+			n = snprintf(buf, sizeof(buf), "BENCH %s %lu base -\r\n", item->name, (unsigned long)result[k]);
+		}
+		_print(n);
+	}
+
+	/* Measured side by side, with the cycles and share the second way saves */
+	for (uint32_t k = 0; k < sizeof(compares) / sizeof(compares[0]); k++) {
+		int32_t a = _find(compares[k].before);
+		int32_t z = _find(compares[k].after);
+		if (a < 0 || z < 0 || !result[a])
+			continue;
+		int32_t saved = (int32_t)(result[a] - result[z]);
+		_print(snprintf(buf, sizeof(buf), "BENCH vs %s %lu %s %lu saved %ld %ld%%\r\n",
+				compares[k].before, (unsigned long)result[a], compares[k].after, (unsigned long)result[z],
+				(long)saved, (long)((int64_t)saved * 100 / result[a])));
+	}
+
+	/* Paste-ready baseline values, in table order */
+	_print(snprintf(buf, sizeof(buf), "BENCH baseline {"));
+	for (uint32_t k = 0; k < sizeof(items) / sizeof(items[0]); k++) {
+		_print(snprintf(buf, sizeof(buf), "%s%lu", k ? ", " : "", (unsigned long)result[k]));
+	}
+	_print(snprintf(buf, sizeof(buf), "}\r\n\n"));
+}
+
+/*! End of file bench.c **/
@@ -0,0 +1,172 @@
+/*!
+ * @file bkp_state.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Backup SRAM state. See bkp_state.h.
+ *
+ * The backup SRAM sits on AHB1 as device memory, so slots are copied a word
+ * at a time rather than with memcpy, which may issue unaligned accesses.
+ */
+
+#include "bkp_state.h"
+#include "i2c_trace.h"
+#include "stm32f7xx_hal.h"
+#include <stddef.h>
+#include <string.h>
+
+#define _WORDS			(sizeof(BkpState_TypeDef) / 4U)
+#define _CRC_FROM		(offsetof(BkpState_TypeDef, seq) / 4U)
+
+_Static_assert(sizeof(BkpState_TypeDef) % 4U == 0U, "slots are copied by word");
+_Static_assert(sizeof(BkpState_TypeDef) * BKP_STATE_SLOTS <= 4096U, "backup SRAM is 4 KB");
+
+BkpState_TypeDef bkpState;
+
+static uint32_t i2cBase;		/**< i2cTransfers at boot **/
+static _Bool restored;
+static _Bool dirty;
+
+/*!
+ * Static function definitions
+ */
+
+static volatile uint32_t *_slot(uint32_t index) {
+	return (volatile uint32_t *)(BKPSRAM_BASE + index * sizeof(BkpState_TypeDef));
+}
+
+/*!
+ * @brief CRC-32 of a slot from seq onwards, in the CRC unit's default setup
+ */
+static uint32_t _crc(const uint32_t *words) {
+	CRC->CR = CRC_CR_RESET;
+	for (uint32_t i = _CRC_FROM; i < _WORDS; i++) {
+		CRC->DR = words[i];
+	}
+	return CRC->DR;
+}
+
+/*!
+ * @brief Copies a slot into s and checks it
+ * @return True if the slot holds a valid state
+ */
+static _Bool _load(uint32_t index, BkpState_TypeDef *s) {
+	volatile uint32_t *src = _slot(index);
+	uint32_t *dst = (uint32_t *)s;
+
+	for (uint32_t i = 0; i < _WORDS; i++) {
+		dst[i] = src[i];
+	}
+	return s->magic == BKP_STATE_MAGIC && s->version == BKP_STATE_VERSION &&
+			s->size == sizeof(BkpState_TypeDef) && s->crc == _crc(dst);
+}
+
+static void _defaults(void) {
+	memset(&bkpState, 0, sizeof(bkpState));
+	bkpState.magic = BKP_STATE_MAGIC;
+	bkpState.version = BKP_STATE_VERSION;
+	bkpState.size = sizeof(BkpState_TypeDef);
+	bkpState.config = *App_Config();
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Enables the backup SRAM and loads the newest valid slot
+ * @return True if a saved state was found, otherwise the state starts empty
+ */
+_Bool BkpState_Init(void) {
+	static BkpState_TypeDef other;
+
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+	__HAL_RCC_BKPSRAM_CLK_ENABLE();
+	__HAL_RCC_CRC_CLK_ENABLE();
+
+	/* Keeps the contents on VBAT; without it only resets are survived */
+	HAL_PWREx_EnableBkUpReg();
+
+	_Bool a = _load(0, &bkpState);
+	_Bool b = _load(1, &other);
+	if (b && (!a || (int32_t)(other.seq - bkpState.seq) > 0))
+		bkpState = other;
+	restored = a || b;
+	if (!restored)
+		_defaults();
+	else
+		bkpState.stats.restores++;
+
+	bkpState.stats.resetFlags = RCC->CSR;
+	__HAL_RCC_CLEAR_RESET_FLAGS();
+	i2cBase = bkpState.stats.i2cTransfers;
+
+	dirty = 1;
+	return restored;
+}
+
+/*!
+ * @brief Hands the loaded state to the application; call once the sensor is up
+ */
+void BkpState_Restore(void) {
+	if (!restored)
+		return;
+
+	App_Restore(&bkpState.config, bkpState.time);
+
+	uint32_t n = bkpState.tailCount < BKP_STATE_TAIL ? bkpState.tailCount : BKP_STATE_TAIL;
+	for (uint32_t i = bkpState.tailCount - n; i != bkpState.tailCount; i++) {
+		App_Replay(&bkpState.tail[i % BKP_STATE_TAIL]);
+	}
+}
+
+/*!
+ * @brief Adds a sample to the tail, keeping the first of each second
+ */
+void BkpState_Sample(const Sample_TypeDef *sample) {
+	bkpState.stats.samples++;
+	if (sample->humidity == SAMPLE_INVALID || sample->temperature == SAMPLE_INVALID)
+		bkpState.stats.readErrors++;
+
+	if (!bkpState.tailCount || sample->time != bkpState.time) {
+		bkpState.tail[bkpState.tailCount % BKP_STATE_TAIL] = *sample;
+		bkpState.tailCount++;
+		bkpState.time = sample->time;
+	}
+	dirty = 1;
+}
+
+/*!
+ * @brief Records the application configuration if it changed
+ */
+void BkpState_Config(const App_ConfigTypeDef *config) {
+	if (memcmp(&bkpState.config, config, sizeof(*config)) != 0) {
+		bkpState.config = *config;
+		dirty = 1;
+	}
+}
+
+/*!
+ * @brief Writes the state to the older slot if anything changed; call from the main loop
+ */
+void BkpState_Commit(void) {
+	if (!dirty)
+		return;
+
+	bkpState.seq++;
+	bkpState.stats.i2cTransfers = i2cBase + I2CTrace_Count();
+	bkpState.crc = _crc((const uint32_t *)&bkpState);
+
+	volatile uint32_t *dst = _slot(bkpState.seq % BKP_STATE_SLOTS);
+	const uint32_t *src = (const uint32_t *)&bkpState;
+	for (uint32_t i = 0; i < _WORDS; i++) {
+		dst[i] = src[i];
+	}
+	__DSB();
+	dirty = 0;
+}
+
+/*! End of file bkp_state.c **/
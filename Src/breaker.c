@@ -0,0 +1,93 @@
+/*!
+ * @file breaker.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Per-device circuit breaker with exponential backoff. See breaker.h.
+ */
+
+#include "breaker.h"
+
+/*!
+ * Static function definitions
+ */
+
+static void _open(Breaker_TypeDef *b, uint32_t now) {
+	b->state = BREAKER_OPEN;
+	b->until = now + b->backoff;
+	b->trips++;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Starts a breaker closed, with no failures on record
+ * @param *b Pointer to the breaker
+ */
+void Breaker_Init(Breaker_TypeDef *b) {
+	b->state = BREAKER_CLOSED;
+	b->failures = 0;
+	b->backoff = BREAKER_BACKOFF_MS;
+	b->until = 0;
+	b->trips = 0;
+	b->skipped = 0;
+}
+
+/*!
+ * @brief Tells whether an attempt may go on the bus
+ * @param *b Pointer to the breaker
+ * @param now HAL tick, ms
+ * @return 1 if the attempt may go ahead; state is BREAKER_HALF_OPEN when it
+ * has to start with a probe
+ */
+_Bool Breaker_Allow(Breaker_TypeDef *b, uint32_t now) {
+	if (b->state != BREAKER_OPEN)
+		return 1;
+	if ((int32_t)(now - b->until) >= 0) {
+		b->state = BREAKER_HALF_OPEN;
+		return 1;
+	}
+	b->skipped++;
+	return 0;
+}
+
+/*!
+ * @brief Records a successful attempt; closes the breaker and resets the backoff
+ * @param *b Pointer to the breaker
+ */
+void Breaker_Success(Breaker_TypeDef *b) {
+	b->state = BREAKER_CLOSED;
+	b->failures = 0;
+	b->backoff = BREAKER_BACKOFF_MS;
+}
+
+/*!
+ * @brief Records a failed attempt or probe
+ * @param *b Pointer to the breaker
+ * @param now HAL tick, ms
+ */
+void Breaker_Failure(Breaker_TypeDef *b, uint32_t now) {
+	switch (b->state) {
+	case BREAKER_HALF_OPEN:
+		if (b->backoff < BREAKER_BACKOFF_MAX_MS / 2U)
+			b->backoff *= 2U;
+		else
+			b->backoff = BREAKER_BACKOFF_MAX_MS;
+		_open(b, now);
+		break;
+	case BREAKER_CLOSED:
+		if (++b->failures >= BREAKER_THRESHOLD) {
+			b->failures = 0;
+			_open(b, now);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/*! End of file breaker.c **/
@@ -0,0 +1,774 @@
+/*!
+ * @file console.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * UART4 command console. See console.h.
+ *
+ * Only the main loop touches the output ring. Completion of a DMA segment is
+ * detected in Console_Poll() from the UART returning to READY, so no
+ * interrupt callback shares state with this file.
+ */
+
+#include "console.h"
+#include "acquire.h"
+#include "scan.h"
+#include "app.h"
+#include "dump.h"
+#include "flash_log.h"
+#include "i2c_timing.h"
+#include "cycles.h"
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _TX_MASK	(CONSOLE_TX_SIZE - 1U)
+#define _PRINT_MAX	(CONSOLE_LINE_SIZE * 2U)	/**< Longest Console_Printf() line **/
+
+/*!
+ * @typedef Console_CommandTypeDef refers to one command table entry
+ */
+typedef struct {
+	const char *name;
+	void (*run)(int argc, char **argv);
+	const char *usage;
+} Console_CommandTypeDef;
+
+/*!
+ * @typedef Console_ListingTypeDef refers to a listing printed a line at a time
+ * @return False once line k was the last one
+ */
+typedef _Bool (*Console_ListingTypeDef)(uint32_t k);
+
+static UART_HandleTypeDef *port;
+static uint8_t tx[CONSOLE_TX_SIZE];
+static uint32_t txHead;			/**< Next byte to fill **/
+static uint32_t txTail;			/**< Next byte to send **/
+static uint32_t txInFlight;		/**< Bytes handed to the DMA **/
+static char line[CONSOLE_LINE_SIZE];
+static uint32_t lineLen;
+static _Bool lineOverflow;
+static Console_ListingTypeDef listing;	/**< Listing being printed, 0 if none **/
+static uint32_t listingLine;			/**< Next line of it **/
+
+static void _help(int argc, char **argv);
+static _Bool _same(const char *a, const char *b);
+static void _list(Console_ListingTypeDef lines);
+
+/*!
+ * Commands
+ */
+
+static _Bool _number(const char *s, uint32_t *value) {
+	char *end;
+	*value = (uint32_t)strtoul(s, &end, 0);
+	return end != s && *end == '\0';
+}
+
+static _Bool _signed(const char *s, int32_t *value) {
+	char *end;
+	*value = (int32_t)strtol(s, &end, 0);
+	return end != s && *end == '\0';
+}
+
+static _Bool _real(const char *s, float *value) {
+	char *end;
+	*value = strtof(s, &end);
+	return end != s && *end == '\0' && *value >= 0.0f;
+}
+
+static char _breaker(const Breaker_TypeDef *b) {
+	return b->state == BREAKER_OPEN ? 'O' : b->state == BREAKER_HALF_OPEN ? 'H' : 'C';
+}
+
+/*!
+ * @brief DUMP R|F|S<n> <from> <to> [offset]
+ */
+static void _dump(int argc, char **argv) {
+	uint32_t from, to, offset = 0, k;
+	Dump_SourceTypeDef source;
+
+	if (argc < 4 || !_number(argv[2], &from) || !_number(argv[3], &to) ||
+			(argc > 4 && !_number(argv[4], &offset))) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	switch (toupper((unsigned char)argv[1][0])) {
+	case 'R': source = DUMP_SOURCE_RAM; break;
+	case 'F': source = DUMP_SOURCE_FLASH; break;
+	case 'S':
+		if (!_number(argv[1] + 1, &k) || k >= acquire.count || !acquire.device[k].store) {
+			Console_Printf("ERR source\r\n");
+			return;
+		}
+		Dump_StartStore(acquire.device[k].store, from, to, offset);
+		Console_Printf("OK\r\n");
+		return;
+	default:
+		Console_Printf("ERR source\r\n");
+		return;
+	}
+
+	Dump_Start(source, from, to, offset);
+	Console_Printf("OK\r\n");
+}
+
+/*!
+ * @brief ACK <offset>; silent so the reply cannot land inside a frame
+ */
+static void _ack(int argc, char **argv) {
+	uint32_t offset;
+	if (argc == 2 && _number(argv[1], &offset))
+		Dump_Ack(offset);
+}
+
+/*!
+ * @brief RESUME [offset]
+ */
+static void _resume(int argc, char **argv) {
+	uint32_t offset;
+	if (argc > 1 && !_number(argv[1], &offset)) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	if (!Dump_Resume(argc > 1, offset)) {
+		Console_Printf("ERR no dump\r\n");
+		return;
+	}
+	Console_Printf("OK\r\n");
+}
+
+static void _abort(int argc, char **argv) {
+	(void)argc;
+	(void)argv;
+	Dump_Abort();
+	Console_Printf("OK\r\n");
+}
+
+/*!
+ * @brief TIME; sample time now and the flash log time it maps to
+ */
+static void _time(int argc, char **argv) {
+	uint32_t now = App_Time();
+	(void)argc;
+	(void)argv;
+	Console_Printf("TIME %lu %lu\r\n", (unsigned long)now, (unsigned long)FlashLog_Time(now));
+}
+
+/*!
+ * @brief FILTER H|T NONE|AVG <n>|EMA <alpha>|MEDIAN <n>|KALMAN <q> <r>
+ */
+static void _filter(int argc, char **argv) {
+	Filter_ConfigTypeDef f = {0};
+	App_ChannelTypeDef channel;
+	uint32_t a = 0, b = 0;
+
+	if (argc < 3 || (argc > 3 && !_number(argv[3], &a)) || (argc > 4 && !_number(argv[4], &b)) ||
+			a > 0xFFFFU || b > 0xFFFFU) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	switch (toupper((unsigned char)argv[1][0])) {
+	case 'H': channel = APP_HUMIDITY; break;
+	case 'T': channel = APP_TEMPERATURE; break;
+	default:
+		Console_Printf("ERR channel\r\n");
+		return;
+	}
+
+	if (_same(argv[2], "NONE") && argc == 3) {
+		f.kind = FILTER_NONE;
+	}
+	else if (_same(argv[2], "AVG") && argc == 4) {
+		f.kind = FILTER_AVERAGE;
+		f.window = (uint8_t)(a > FILTER_WINDOW_MAX ? FILTER_WINDOW_MAX : a);
+	}
+	else if (_same(argv[2], "EMA") && argc == 4) {
+		f.kind = FILTER_EMA;
+		f.alpha = (uint16_t)a;
+	}
+	else if (_same(argv[2], "MEDIAN") && argc == 4) {
+		f.kind = FILTER_MEDIAN;
+		f.window = (uint8_t)(a > FILTER_WINDOW_MAX ? FILTER_WINDOW_MAX : a);
+	}
+	else if (_same(argv[2], "KALMAN") && argc == 5) {
+		f.kind = FILTER_KALMAN;
+		f.q = (uint16_t)a;
+		f.r = (uint16_t)b;
+	}
+	else {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+
+	App_SetFilter(channel, &f);
+	Console_Printf("OK\r\n");
+}
+
+/*!
+ * @brief ANOMALY; per channel, samples flagged failed/range/spike/rate/stuck/drift
+ */
+static void _anomaly(int argc, char **argv) {
+	static const char names[APP_CHANNELS] = {'H', 'T'};
+	(void)argc;
+	(void)argv;
+	for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+		const uint32_t *n = App_Anomaly((App_ChannelTypeDef)c)->flagged;
+		Console_Printf("ANOMALY %c %lu %lu %lu %lu %lu %lu\r\n", names[c], (unsigned long)n[0],
+				(unsigned long)n[1], (unsigned long)n[2], (unsigned long)n[3], (unsigned long)n[4],
+				(unsigned long)n[5]);
+	}
+}
+
+/*!
+ * @brief RATE; current period in ms, samples taken, samples at the fixed cadence
+ */
+static void _rate(int argc, char **argv) {
+	const Adaptive_TypeDef *a = App_Cadence();
+	uint32_t fixed = Adaptive_Fixed(a);
+	uint32_t saved = (fixed > a->samples) ? (uint32_t)((uint64_t)(fixed - a->samples) * 100U / fixed) : 0U;
+	(void)argc;
+	(void)argv;
+	Console_Printf("RATE %lu %lu %lu %lu%%\r\n", (unsigned long)a->period, (unsigned long)a->samples,
+			(unsigned long)fixed, (unsigned long)saved);
+}
+
+/*!
+ * @brief REPORT [H|T <deadband> <heartbeat>]; without arguments, lines sent and held back
+ */
+static void _report(int argc, char **argv) {
+	static const char names[APP_CHANNELS] = {'H', 'T'};
+	Report_ConfigTypeDef policy;
+	uint32_t deadband, heartbeat;
+
+	if (argc == 1) {
+		for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+			const Report_TypeDef *r = App_Report((App_ChannelTypeDef)c);
+			Console_Printf("REPORT %c %u %u %lu %lu\r\n", names[c], r->config.deadband,
+					r->config.heartbeat, (unsigned long)r->sent, (unsigned long)r->suppressed);
+		}
+		return;
+	}
+	if (argc != 4 || !_number(argv[2], &deadband) || !_number(argv[3], &heartbeat) ||
+			deadband > 0xFFFFU || heartbeat > 0xFFFFU) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	policy.deadband = (uint16_t)deadband;
+	policy.heartbeat = (uint16_t)heartbeat;
+	switch (toupper((unsigned char)argv[1][0])) {
+	case 'H': App_SetReportPolicy(APP_HUMIDITY, &policy); break;
+	case 'T': App_SetReportPolicy(APP_TEMPERATURE, &policy); break;
+	default:
+		Console_Printf("ERR channel\r\n");
+		return;
+	}
+	Console_Printf("OK\r\n");
+}
+
+/*!
+ * @brief WINDOW [seconds]; without arguments, the last closed window per channel:
+ * start, length, count, then min, max, mean and standard deviation in 0.01 units
+ */
+static void _window(int argc, char **argv) {
+	static const char names[APP_CHANNELS] = {'H', 'T'};
+	const Window_SummaryTypeDef *w = App_Window();
+	uint32_t seconds;
+
+	if (argc == 1) {
+		for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+			const Window_StatTypeDef *s = c == APP_HUMIDITY ? &w->humidity : &w->temperature;
+			if (!s->count) {
+				Console_Printf("WINDOW %c %lu %lu 0\r\n", names[c], (unsigned long)w->start,
+						(unsigned long)w->seconds);
+				continue;
+			}
+			long sd = s->count > 1U ? lrintf(Window_StdDev(s) * 100.0f) : 0;
+			Console_Printf("WINDOW %c %lu %lu %lu %d %d %ld %ld\r\n", names[c], (unsigned long)w->start,
+					(unsigned long)w->seconds, (unsigned long)s->count, s->min, s->max, lrintf(s->mean), sd);
+		}
+		return;
+	}
+	if (argc != 2 || !_number(argv[1], &seconds) || seconds > 0xFFFFU) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	App_SetWindow((uint16_t)seconds);
+	Console_Printf("OK\r\n");
+}
+
+/*!
+ * @brief QUANTILE [Y] [percent ...]; per channel, the day's count and
+ * percentiles in 0.01 units, today's or yesterday's, p5/p50/p95 by default
+ */
+static void _quantile(int argc, char **argv) {
+	static const char names[APP_CHANNELS] = {'H', 'T'};
+	static const uint32_t defaults[] = {5, 50, 95};
+	uint32_t percents[CONSOLE_MAX_ARGS];
+	uint32_t count = 0;
+	Quantile_DayTypeDef day = QUANTILE_TODAY;
+	int i = 1;
+
+	if (argc > 1 && _same(argv[1], "Y")) {
+		day = QUANTILE_YESTERDAY;
+		i++;
+	}
+	for (; i < argc; i++) {
+		if (!_number(argv[i], &percents[count]) || percents[count] > 100U) {
+			Console_Printf("ERR usage\r\n");
+			return;
+		}
+		count++;
+	}
+	if (!count) {
+		for (; count < sizeof(defaults) / sizeof(defaults[0]); count++) {
+			percents[count] = defaults[count];
+		}
+	}
+
+	for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+		const Quantile_TypeDef *q = App_Quantile((App_ChannelTypeDef)c);
+		Console_Printf("QUANTILE %c %lu", names[c], (unsigned long)Quantile_Count(q, day));
+		for (uint32_t k = 0; k < count; k++) {
+			Console_Printf(" %d", Quantile_Get(q, day, percents[k] * 10U));
+		}
+		Console_Printf("\r\n");
+	}
+}
+
+/*!
+ * @brief ROLLUP <from> <to>; history between two sample times from the
+ * rollups: the span actually covered, seconds missing inside it and buckets
+ * merged, then per channel count, min, max and mean in 0.01 units
+ */
+static void _rollup(int argc, char **argv) {
+	static const char names[APP_CHANNELS] = {'H', 'T'};
+	Rollup_BucketTypeDef result;
+	Rollup_SpanTypeDef covered;
+	uint32_t from, to;
+
+	if (argc != 3 || !_number(argv[1], &from) || !_number(argv[2], &to) || to < from) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	uint32_t merged = Rollup_Query(&rollup, from, to, &result, &covered);
+	Console_Printf("ROLLUP %lu %lu %lu %lu\r\n", (unsigned long)covered.from, (unsigned long)covered.to,
+			(unsigned long)covered.missing, (unsigned long)merged);
+	for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+		const Rollup_StatTypeDef *s = c == APP_HUMIDITY ? &result.humidity : &result.temperature;
+		if (!s->count) {
+			Console_Printf("ROLLUP %c 0\r\n", names[c]);
+			continue;
+		}
+		Console_Printf("ROLLUP %c %lu %d %d %ld\r\n", names[c], (unsigned long)s->count, s->min, s->max,
+				lrintf(Rollup_Mean(s) * 100.0f));
+	}
+}
+
+/*!
+ * @brief ALARM [H|T <low> <high> <hysteresis>]; without arguments, per channel
+ * thresholds in 0.01 units, state bits and times raised, then checks run and
+ * the worst data-to-pin latency in cycles and us
+ */
+static void _alarm(int argc, char **argv) {
+	static const char names[APP_CHANNELS] = {'H', 'T'};
+	const Alarm_TypeDef *a = App_Alarm();
+	Alarm_ConfigTypeDef thresholds;
+	int32_t low, high;
+	uint32_t hysteresis;
+
+	if (argc == 1) {
+		for (uint32_t c = 0; c < APP_CHANNELS; c++) {
+			Console_Printf("ALARM %c %d %d %u %u %lu\r\n", names[c], a->config[c].low, a->config[c].high,
+					a->config[c].hysteresis, a->state[c], (unsigned long)a->raised[c]);
+		}
+		Console_Printf("ALARM LATENCY %lu %lu %lu\r\n", (unsigned long)a->checks,
+				(unsigned long)a->worst, (unsigned long)Cycles_ToMicros(a->worst));
+		return;
+	}
+	if (argc != 5 || !_signed(argv[2], &low) || !_signed(argv[3], &high) || !_number(argv[4], &hysteresis) ||
+			low < INT16_MIN + 1 || low > INT16_MAX || high < low || high > INT16_MAX || hysteresis > 0xFFFFU) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	thresholds.low = (int16_t)low;
+	thresholds.high = (int16_t)high;
+	thresholds.hysteresis = (uint16_t)hysteresis;
+	switch (toupper((unsigned char)argv[1][0])) {
+	case 'H': App_SetAlarm(APP_HUMIDITY, &thresholds); break;
+	case 'T': App_SetAlarm(APP_TEMPERATURE, &thresholds); break;
+	default:
+		Console_Printf("ERR channel\r\n");
+		return;
+	}
+	Console_Printf("OK\r\n");
+}
+
+/*!
+ * @brief CONTROL [OFF | H|T <setpoint> RAISE|LOWER | PID <kp> <ki> <kd> <slew>];
+ * without arguments, the settings, then duty in permille, steps run and the
+ * worst period jitter in cycles and us
+ */
+static void _control(int argc, char **argv) {
+	static const char *inputs[] = {"OFF", "H", "T"};
+	const Control_TypeDef *c = App_Controller();
+	Control_ConfigTypeDef settings = App_Config()->control;
+	int32_t setpoint;
+	uint32_t slew;
+
+	if (argc == 1) {
+		const Control_ConfigTypeDef *s = &c->config;
+		Console_Printf("CONTROL %s %s %d %.2f %.2f %.2f %u\r\n", inputs[s->input < 3U ? s->input : 0],
+				s->direction < 0 ? "LOWER" : "RAISE", s->setpoint, s->kp, s->ki, s->kd, s->slew);
+		Console_Printf("CONTROL DUTY %u %lu %lu %lu\r\n", (unsigned)(c->duty + 0.5f), (unsigned long)c->steps,
+				(unsigned long)c->jitter, (unsigned long)Cycles_ToMicros(c->jitter));
+		return;
+	}
+
+	if (argc == 2 && _same(argv[1], "OFF")) {
+		settings.input = CONTROL_OFF;
+	}
+	else if (argc == 4 && (_same(argv[1], "H") || _same(argv[1], "T")) && _signed(argv[2], &setpoint) &&
+			setpoint > INT16_MIN && setpoint <= INT16_MAX && (_same(argv[3], "RAISE") || _same(argv[3], "LOWER"))) {
+		settings.input = _same(argv[1], "H") ? CONTROL_HUMIDITY : CONTROL_TEMPERATURE;
+		settings.setpoint = (int16_t)setpoint;
+		settings.direction = _same(argv[3], "RAISE") ? 1 : -1;
+	}
+	else if (argc == 6 && _same(argv[1], "PID") && _real(argv[2], &settings.kp) && _real(argv[3], &settings.ki) &&
+			_real(argv[4], &settings.kd) && _number(argv[5], &slew) && slew <= 0xFFFFU) {
+		settings.slew = (uint16_t)slew;
+	}
+	else {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	App_SetControl(&settings);
+	Console_Printf("OK\r\n");
+}
+
+/*!
+ * @brief I2C [kHz]; without arguments, the SCL rate in Hz and TIMINGR.
+ * A new rate holds until reset
+ */
+static void _i2c(int argc, char **argv) {
+	I2C_HandleTypeDef *hi2c = &sensor._hi2c;
+	uint32_t clock = I2CTiming_Clock(hi2c->Instance);
+	I2CTiming_ConfigTypeDef config;
+	uint32_t khz;
+
+	if (argc == 1) {
+		uint32_t timing = hi2c->Instance->TIMINGR;
+		I2CTiming_Default(&config, 0);
+		config.analogFilter = !(hi2c->Instance->CR1 & I2C_CR1_ANFOFF);
+		config.digitalFilter = (uint8_t)((hi2c->Instance->CR1 & I2C_CR1_DNF) >> I2C_CR1_DNF_Pos);
+		Console_Printf("I2C %lu %08lX\r\n", (unsigned long)I2CTiming_Rate(clock, timing, &config),
+				(unsigned long)timing);
+		return;
+	}
+	if (argc != 2 || !_number(argv[1], &khz) || khz > I2C_TIMING_SPEED_MAX / 1000U) {
+		Console_Printf("ERR usage\r\n");
+		return;
+	}
+	switch (I2CTiming_SetSpeed(hi2c, khz * 1000U)) {
+	case HAL_OK: Console_Printf("OK\r\n"); break;
+	case HAL_BUSY: Console_Printf("ERR busy\r\n"); break;
+	default: Console_Printf("ERR speed\r\n"); break;
+	}
+}
+
+/*!
+ * @brief SENSORS; per additional sensor, bus, 7-bit address, mux address and
+ * channel (- if direct), humidity and temperature in 0.01 units, good reads
+ * and errors, breaker state (C/O/H), trips and skipped cycles; the breaker
+ * of the primary sensor; per mux, its control writes and the selects the
+ * cache saved; then the length of the last acquisition cycle in cycles and us
+ */
+static _Bool _sensorsLine(uint32_t k) {
+	if (k < acquire.count) {
+		const Acquire_DeviceTypeDef *d = &acquire.device[k];
+		char via[8] = "-";
+		if (d->mux)
+			snprintf(via, sizeof(via), "%02X:%u", d->mux->address >> 1, d->channel);
+		Console_Printf("SENSOR %lu I2C%u %02X %s %d %d %lu %lu %c %lu %lu\r\n", (unsigned long)k, d->bus, d->address >> 1,
+				via, d->humidity, d->temperature, (unsigned long)d->reads, (unsigned long)d->errors,
+				_breaker(&d->breaker), (unsigned long)d->breaker.trips, (unsigned long)d->breaker.skipped);
+		return 1;
+	}
+	k -= acquire.count;
+	if (k == 0) {
+		Console_Printf("BREAKER MAIN %c %lu %lu\r\n", _breaker(&sensor.breaker), (unsigned long)sensor.breaker.trips,
+				(unsigned long)sensor.breaker.skipped);
+		return 1;
+	}
+	k--;
+	if (k < acquire.muxes) {
+		const Mux_TypeDef *mux = acquire.mux[k];
+		Console_Printf("MUX %02X %lu %lu\r\n", mux->address >> 1, (unsigned long)mux->writes,
+				(unsigned long)mux->skipped);
+		return 1;
+	}
+	Console_Printf("SENSOR CYCLE %lu %lu\r\n", (unsigned long)acquire.cycles,
+			(unsigned long)Cycles_ToMicros(acquire.cycles));
+	return 0;
+}
+
+static void _sensors(int argc, char **argv) {
+	(void)argc;
+	(void)argv;
+	_list(_sensorsLine);
+}
+
+/*!
+ * @brief SCAN [NOW]; per device found, bus, 7-bit address, mux address and
+ * channel (- if direct), model and whether it answered in the last pass,
+ * then passes, length of the last one in ms, transfers and sensors added.
+ * NOW starts a pass without waiting for the period.
+ */
+static _Bool _scanLine(uint32_t k) {
+	static const char *const models[] = {"SIES", "SI7013", "SI7020", "SI7021"};
+
+	if (k < scan.count) {
+		const Scan_DeviceTypeDef *d = &scan.device[k];
+		const char *model = d->model == SCAN_MODEL_MUX ? "MUX" : d->model < 4U ? models[d->model] : "-";
+		char via[8] = "-";
+		if (d->mux)
+			snprintf(via, sizeof(via), "%02X:%u", d->mux, d->channel);
+		Console_Printf("FOUND I2C%u %02X %s %s %u\r\n", d->bus, d->address, via, model, Scan_Present(&scan, d));
+		return 1;
+	}
+	Console_Printf("SCAN %lu %lu %lu %lu\r\n", (unsigned long)scan.pass, (unsigned long)scan.duration,
+			(unsigned long)scan.probes, (unsigned long)scan.added);
+	return 0;
+}
+
+static void _scan(int argc, char **argv) {
+	if (argc > 1) {
+		if (!_same(argv[1], "NOW")) {
+			Console_Printf("ERR usage\r\n");
+			return;
+		}
+		Scan_Start(&scan);
+	}
+	_list(_scanLine);
+}
+
+static const Console_CommandTypeDef commands[] = {
+	{"DUMP",   _dump,   "DUMP R|F|S<n> <from> <to> [offset]"},
+	{"ACK",    _ack,    "ACK <offset>"},
+	{"RESUME", _resume, "RESUME [offset]"},
+	{"ABORT",  _abort,  "ABORT"},
+	{"TIME",   _time,   "TIME"},
+	{"FILTER", _filter, "FILTER H|T NONE|AVG <n>|EMA <alpha>|MEDIAN <n>|KALMAN <q> <r>"},
+	{"ANOMALY", _anomaly, "ANOMALY"},
+	{"RATE",   _rate,   "RATE"},
+	{"REPORT", _report, "REPORT [H|T <deadband> <heartbeat>]"},
+	{"WINDOW", _window, "WINDOW [seconds]"},
+	{"QUANTILE", _quantile, "QUANTILE [Y] [percent ...]"},
+	{"ROLLUP", _rollup, "ROLLUP <from> <to>"},
+	{"ALARM",  _alarm,  "ALARM [H|T <low> <high> <hysteresis>]"},
+	{"CONTROL", _control, "CONTROL [OFF|H|T <setpoint> RAISE|LOWER|PID <kp> <ki> <kd> <slew>]"},
+	{"I2C",    _i2c,    "I2C [kHz]"},
+	{"SENSORS", _sensors, "SENSORS"},
+	{"SCAN",   _scan,   "SCAN [NOW]"},
+	{"HELP",   _help,   "HELP"},
+};
+
+static _Bool _helpLine(uint32_t k) {
+	Console_Printf("%s\r\n", commands[k].usage);
+	return k + 1U < sizeof(commands) / sizeof(commands[0]);
+}
+
+static void _help(int argc, char **argv) {
+	(void)argc;
+	(void)argv;
+	_list(_helpLine);
+}
+
+/*!
+ * Static function definitions
+ */
+
+static _Bool _same(const char *a, const char *b) {
+	while (*a && *b) {
+		if (toupper((unsigned char)*a++) != *b++)
+			return 0;
+	}
+	return *a == *b;
+}
+
+/*!
+ * @brief Prints the lines of the listing under way while the ring has room
+ * for one more and a sample report
+ */
+static void _more(void) {
+	while (listing && Console_Free() >= _PRINT_MAX + APP_REPORT_MAX) {
+		if (!listing(listingLine++))
+			listing = 0;
+	}
+}
+
+/*!
+ * @brief Starts a listing, replacing one still under way
+ */
+static void _list(Console_ListingTypeDef lines) {
+	listing = lines;
+	listingLine = 0;
+	_more();
+}
+
+static void _dispatch(void) {
+	char *argv[CONSOLE_MAX_ARGS];
+	int argc = 0;
+	char *p = line;
+
+	while (*p && argc < (int)CONSOLE_MAX_ARGS) {
+		while (*p == ' ')
+			*p++ = '\0';
+		if (!*p)
+			break;
+		argv[argc++] = p;
+		while (*p && *p != ' ')
+			p++;
+	}
+	if (!argc)
+		return;
+
+	for (uint32_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+		if (_same(argv[0], commands[i].name)) {
+			commands[i].run(argc, argv);
+			return;
+		}
+	}
+	Console_Printf("ERR unknown\r\n");
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Attaches the console to a UART whose TX DMA is linked
+ */
+void Console_Init(UART_HandleTypeDef *huart) {
+	port = huart;
+	txHead = txTail = txInFlight = 0;
+	lineLen = 0;
+	lineOverflow = 0;
+	listing = 0;
+}
+
+/*!
+ * @brief Feeds one received byte; dispatches a command at end of line
+ */
+void Console_Input(uint8_t byte) {
+	if (byte == '\r' || byte == '\n') {
+		if (lineOverflow)
+			Console_Printf("ERR line\r\n");
+		else if (lineLen) {
+			line[lineLen] = '\0';
+			_dispatch();
+		}
+		lineLen = 0;
+		lineOverflow = 0;
+	}
+	else if (lineLen < CONSOLE_LINE_SIZE - 1U) {
+		line[lineLen++] = (char)byte;
+	}
+	else {
+		lineOverflow = 1;
+	}
+}
+
+/*!
+ * @brief Retires a finished DMA segment, prints more of a listing and
+ *        starts the next segment; call from the main loop
+ */
+void Console_Poll(void) {
+	if (txInFlight) {
+		if (port->gState != HAL_UART_STATE_READY)
+			return;
+		txTail += txInFlight;
+		txInFlight = 0;
+	}
+	_more();
+
+	uint32_t pending = txHead - txTail;
+	if (!pending)
+		return;
+
+	/* One contiguous run up to the end of the ring */
+	uint32_t start = txTail & _TX_MASK;
+	uint32_t len = CONSOLE_TX_SIZE - start;
+	if (len > pending)
+		len = pending;
+
+	if (HAL_UART_Transmit_DMA(port, &tx[start], (uint16_t)len) == HAL_OK)
+		txInFlight = len;
+}
+
+/*!
+ * @brief Waits until all queued output has left the UART
+ * @param timeout Milliseconds to wait at most
+ * @return True if the console is idle
+ */
+_Bool Console_Flush(uint32_t timeout) {
+	uint32_t start = HAL_GetTick();
+	for (;;) {
+		Console_Poll();
+		if (!txInFlight && txHead == txTail)
+			return 1;
+		if (HAL_GetTick() - start >= timeout)
+			return 0;
+	}
+}
+
+/*!
+ * @brief Bytes that Console_Write can accept right now
+ */
+uint32_t Console_Free(void) {
+	return CONSOLE_TX_SIZE - (txHead - txTail);
+}
+
+/*!
+ * @brief Queues bytes for output
+ * @return True if queued; false (nothing queued) if they do not fit
+ */
+_Bool Console_Write(const void *data, uint32_t len) {
+	const uint8_t *src = data;
+
+	if (len > Console_Free())
+		return 0;
+
+	uint32_t start = txHead & _TX_MASK;
+	uint32_t first = CONSOLE_TX_SIZE - start;
+	if (first > len)
+		first = len;
+	memcpy(&tx[start], src, first);
+	memcpy(tx, src + first, len - first);
+	txHead += len;
+	return 1;
+}
+
+/*!
+ * @brief Formats a line of at most CONSOLE_LINE_SIZE * 2 bytes and queues it
+ */
+_Bool Console_Printf(const char *format, ...) {
+	char buf[_PRINT_MAX];
+	va_list args;
+
+	va_start(args, format);
+	int n = vsnprintf(buf, sizeof(buf), format, args);
+	va_end(args);
+
+	if (n < 0)
+		return 0;
+	if (n > (int)sizeof(buf) - 1)
+		n = sizeof(buf) - 1;
+	return Console_Write(buf, (uint32_t)n);
+}
+
+/*! End of file console.c **/
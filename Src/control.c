@@ -0,0 +1,151 @@
+/*!
+ * @file control.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Fixed-rate PID loop. See control.h.
+ */
+
+#include "control.h"
+#include "cycles.h"
+
+#define _DT		(CONTROL_PERIOD_MS / 1000.0f)	/**< Nominal step in seconds **/
+
+/*!
+ * Static function definitions
+ */
+
+static float _limit(float x, float low, float high) {
+	if (x < low)
+		return low;
+	if (x > high)
+		return high;
+	return x;
+}
+
+/*!
+ * @brief Applies settings; a new input or direction also clears the state
+ */
+static void _apply(Control_TypeDef *c, const Control_ConfigTypeDef *config) {
+	if (config->input != c->config.input || config->direction != c->config.direction) {
+		c->integral = 0.0f;
+		c->derivative = 0.0f;
+		c->previous = SAMPLE_INVALID;
+	}
+	c->config = *config;
+	if (c->config.direction >= 0)
+		c->config.direction = 1;
+}
+
+/*!
+ * @brief Records the step's stamp and the worst deviation from the period
+ */
+static void _jitter(Control_TypeDef *c, uint32_t stamp) {
+	uint32_t nominal = SystemCoreClock / 1000U * CONTROL_PERIOD_MS;
+
+	if (c->steps) {
+		uint32_t interval = stamp - c->stamp;
+		uint32_t deviation = interval > nominal ? interval - nominal : nominal - interval;
+		if (deviation > c->jitter)
+			c->jitter = deviation;
+	}
+	c->stamp = stamp;
+	c->steps++;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets up the loop with the output off
+ */
+void Control_Init(Control_TypeDef *c, const Control_ConfigTypeDef *config) {
+	c->update = 0;
+	c->integral = 0.0f;
+	c->duty = 0.0f;
+	c->derivative = 0.0f;
+	c->previous = SAMPLE_INVALID;
+	c->steps = 0;
+	c->jitter = 0;
+	c->config.input = CONTROL_OFF;
+	c->config.direction = 0;
+	_apply(c, config);
+}
+
+/*!
+ * @brief Queues new settings for the next step; safe against the interrupt
+ */
+void Control_Configure(Control_TypeDef *c, const Control_ConfigTypeDef *config) {
+	c->update = 0;
+	__DMB();
+	c->pending = *config;
+	__DMB();
+	c->update = 1;
+}
+
+/*!
+ * @brief Runs one step of the loop
+ * @param *c Pointer to the loop
+ * @param *sample Latest filtered sample; its time tells a new one from a repeat
+ * @param stamp DWT cycle stamp of the step
+ * @return Duty in permille
+ */
+uint16_t Control_Step(Control_TypeDef *c, const Sample_TypeDef *sample, uint32_t stamp) {
+	const Control_ConfigTypeDef *cfg = &c->config;
+	float target = 0.0f;
+	int16_t value;
+
+	if (c->update) {
+		_apply(c, &c->pending);
+		c->update = 0;
+	}
+	_jitter(c, stamp);
+
+	switch (cfg->input) {
+	case CONTROL_HUMIDITY: value = sample->humidity; break;
+	case CONTROL_TEMPERATURE: value = sample->temperature; break;
+	default:
+		c->integral = 0.0f;
+		c->duty = 0.0f;
+		return 0;
+	}
+
+	if (value != SAMPLE_INVALID) {
+		float error = cfg->direction * (cfg->setpoint - value) / 100.0f;
+		float p = cfg->kp * error;
+
+		/* Several steps see the same sample; only a newer one moves the derivative */
+		if (c->previous == SAMPLE_INVALID) {
+			c->derivative = 0.0f;
+			c->previous = value;
+			c->previousTime = sample->time;
+		}
+		else if (sample->time != c->previousTime) {
+			float dt = (float)(sample->time - c->previousTime);
+			c->derivative = -cfg->kd * cfg->direction * (value - c->previous) / 100.0f / dt;
+			c->previous = value;
+			c->previousTime = sample->time;
+		}
+		float d = c->derivative;
+
+		/* Integrate only while that does not push further into a limit */
+		float integral = _limit(c->integral + cfg->ki * error * _DT, 0.0f, CONTROL_DUTY_MAX);
+		float trial = p + integral + d;
+		if ((trial < CONTROL_DUTY_MAX || error < 0.0f) && (trial > 0.0f || error > 0.0f))
+			c->integral = integral;
+
+		target = _limit(p + c->integral + d, 0.0f, CONTROL_DUTY_MAX);
+	}
+
+	if (cfg->slew) {
+		float step = cfg->slew * _DT;
+		target = _limit(target, c->duty - step, c->duty + step);
+	}
+	c->duty = target;
+	return (uint16_t)(c->duty + 0.5f);
+}
+
+/*! End of file control.c **/
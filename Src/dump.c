@@ -0,0 +1,364 @@
+/*!
+ * @file dump.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Resumable bulk export. See dump.h for the protocol.
+ *
+ * Source cursors are plain structs, so going back to an acknowledged offset
+ * is a copy of the cursor saved at the end of that frame rather than a
+ * decode from the start.
+ */
+
+#include "dump.h"
+#include "console.h"
+#include "flash_log.h"
+#include "stm32f7xx_hal.h"
+
+/*!
+ * @typedef Dump_StateTypeDef refers to enum of dump states
+ */
+typedef enum {
+	_IDLE,
+	_SEEK,			/**< Skipping to the start offset **/
+	_STREAM,
+	_PAUSED			/**< Out of retries, waiting for RESUME **/
+} Dump_StateTypeDef;
+
+/*!
+ * @typedef Dump_CursorTypeDef refers to a read position in either source
+ */
+typedef union {
+	Tsdb_CursorTypeDef ram;
+	FlashLog_CursorTypeDef flash;
+} Dump_CursorTypeDef;
+
+/*!
+ * @typedef Dump_FrameTypeDef refers to an unacknowledged frame
+ */
+typedef struct {
+	uint32_t end;					/**< Offset after its last sample **/
+	Dump_CursorTypeDef cursor;		/**< Source position after its last sample **/
+} Dump_FrameTypeDef;
+
+static const uint32_t _crcTable[16] = {
+	0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+	0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+	0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+	0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+static const Tsdb_TypeDef *ramStore;
+static const Tsdb_TypeDef *store;	/**< RAM store of the dump **/
+static Dump_StateTypeDef state;
+static _Bool configured;
+static Dump_SourceTypeDef source;
+static uint32_t from;
+static uint32_t to;
+
+static Dump_CursorTypeDef live;		/**< Next sample to send **/
+static Dump_CursorTypeDef base;		/**< Sample at the acknowledged offset **/
+static uint32_t acked;
+static uint32_t sent;
+static uint32_t target;				/**< Offset being sought **/
+static _Bool ended;					/**< Source ran out at offset sent **/
+static _Bool endSent;
+static uint32_t lastAck;
+static uint32_t retries;
+
+static Dump_FrameTypeDef frames[DUMP_WINDOW];
+static uint32_t frameCount;
+static uint8_t frame[DUMP_FRAME_MAX];
+
+/*!
+ * Static function definitions
+ */
+
+static void _begin(Dump_CursorTypeDef *c) {
+	if (source == DUMP_SOURCE_RAM)
+		Tsdb_Begin(store, &c->ram);
+	else
+		FlashLog_Begin(&c->flash);
+}
+
+/*!
+ * @brief Reads the next sample of the range
+ * @return 1 with a sample, 0 at the end of the range, -1 when out of budget
+ */
+static int _pull(Dump_CursorTypeDef *c, Sample_TypeDef *s, uint32_t *budget) {
+	while (*budget) {
+		(*budget)--;
+
+		if (source == DUMP_SOURCE_RAM) {
+			if (!Tsdb_Next(&c->ram, s))
+				return 0;
+		}
+		else {
+			FlashLog_RecordTypeDef r;
+			if (!FlashLog_Next(&c->flash, &r))
+				return 0;
+			s->time = r.time;
+			s->humidity = r.humidity;
+			s->temperature = r.temperature;
+		}
+
+		if (s->time < from)
+			continue;
+		return (s->time < to) ? 1 : 0;
+	}
+	return -1;
+}
+
+static void _le32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+/*!
+ * @brief Seals the frame being built and queues it on the console
+ * @return 1 if queued, 0 if the console ring had no room for it
+ */
+static _Bool _emit(uint8_t type, uint32_t count, uint32_t offset) {
+	uint32_t len = 8U + count * 8U;
+
+	frame[0] = DUMP_SYNC0;
+	frame[1] = DUMP_SYNC1;
+	frame[2] = type;
+	frame[3] = (uint8_t)count;
+	_le32(&frame[4], offset);
+	_le32(&frame[len], Dump_Crc32(0, &frame[2], len - 2U));
+	return Console_Write(frame, len + 4U);
+}
+
+static void _rewind(void) {
+	live = base;
+	sent = acked;
+	frameCount = 0;
+	ended = 0;
+	endSent = 0;
+	lastAck = HAL_GetTick();
+}
+
+static void _seek(uint32_t offset) {
+	_begin(&live);
+	sent = 0;
+	target = offset;
+	frameCount = 0;
+	ended = 0;
+	endSent = 0;
+	state = _SEEK;
+}
+
+static void _pollSeek(void) {
+	uint32_t budget = DUMP_BUDGET;
+	Sample_TypeDef s;
+
+	while (sent < target) {
+		int r = _pull(&live, &s, &budget);
+		if (r < 0)
+			return;
+		if (r == 0) {
+			ended = 1;
+			break;
+		}
+		sent++;
+	}
+
+	acked = sent;
+	base = live;
+	retries = 0;
+	lastAck = HAL_GetTick();
+	state = _STREAM;
+}
+
+static void _pollStream(void) {
+	uint32_t budget = DUMP_BUDGET;
+	Sample_TypeDef s;
+
+	/* The timer only runs while something is waiting to be acknowledged */
+	if ((frameCount || endSent) && HAL_GetTick() - lastAck >= DUMP_ACK_TIMEOUT_MS) {
+		if (++retries > DUMP_RETRIES) {
+			state = _PAUSED;
+			return;
+		}
+		_rewind();
+	}
+
+	while (!endSent && Console_Free() >= DUMP_FRAME_MAX) {
+		if (!ended) {
+			if (frameCount == DUMP_WINDOW)
+				return;
+
+			uint32_t count = 0;
+			int r = 1;
+			while (count < DUMP_CHUNK) {
+				r = _pull(&live, &s, &budget);
+				if (r <= 0)
+					break;
+				uint8_t *p = &frame[8U + count * 8U];
+				_le32(p, s.time);
+				p[4] = (uint8_t)s.humidity;
+				p[5] = (uint8_t)((uint16_t)s.humidity >> 8);
+				p[6] = (uint8_t)s.temperature;
+				p[7] = (uint8_t)((uint16_t)s.temperature >> 8);
+				count++;
+			}
+
+			if (count) {
+				if (!frameCount)
+					lastAck = HAL_GetTick();
+				_emit('D', count, sent);
+				sent += count;
+				frames[frameCount].end = sent;
+				frames[frameCount].cursor = live;
+				frameCount++;
+			}
+			if (r < 0)
+				return;
+			if (r == 0)
+				ended = 1;
+		}
+		if (ended) {
+			/* The data frame just queued may have left no room; retry next poll */
+			if (!_emit('E', 0, sent))
+				return;
+			if (!frameCount)
+				lastAck = HAL_GetTick();
+			endSent = 1;
+		}
+	}
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets the RAM store dumped by source R
+ */
+void Dump_Init(const Tsdb_TypeDef *ram) {
+	ramStore = ram;
+	state = _IDLE;
+	configured = 0;
+}
+
+/*!
+ * @brief Starts a dump, replacing any dump in progress
+ * @param src Store to read
+ * @param rangeFrom First time included
+ * @param rangeTo First time excluded
+ * @param offset Offset of the first sample to send
+ */
+void Dump_Start(Dump_SourceTypeDef src, uint32_t rangeFrom, uint32_t rangeTo, uint32_t offset) {
+	source = src;
+	store = ramStore;
+	from = rangeFrom;
+	to = rangeTo;
+	configured = 1;
+	_seek(offset);
+}
+
+/*!
+ * @brief Starts a dump of another RAM store, e.g. an additional sensor's history
+ * @param *db Store to read
+ * @param rangeFrom First time included
+ * @param rangeTo First time excluded
+ * @param offset Offset of the first sample to send
+ */
+void Dump_StartStore(const Tsdb_TypeDef *db, uint32_t rangeFrom, uint32_t rangeTo, uint32_t offset) {
+	source = DUMP_SOURCE_RAM;
+	store = db;
+	from = rangeFrom;
+	to = rangeTo;
+	configured = 1;
+	_seek(offset);
+}
+
+/*!
+ * @brief Acknowledges every sample before offset; must be a frame end
+ */
+void Dump_Ack(uint32_t offset) {
+	if (state != _STREAM && state != _PAUSED)
+		return;
+
+	for (uint32_t k = 0; k < frameCount; k++) {
+		if (frames[k].end == offset) {
+			base = frames[k].cursor;
+			acked = offset;
+			for (uint32_t j = k + 1U; j < frameCount; j++) {
+				frames[j - k - 1U] = frames[j];
+			}
+			frameCount -= k + 1U;
+			retries = 0;
+			lastAck = HAL_GetTick();
+			break;
+		}
+	}
+
+	if (endSent && acked == sent && offset == sent)
+		state = _IDLE;
+}
+
+/*!
+ * @brief Continues the last dump
+ * @param seek False to continue from the acknowledged offset, true to use offset
+ * @param offset Offset to continue from when seek is set
+ * @return False if there is no dump to continue
+ */
+_Bool Dump_Resume(_Bool seek, uint32_t offset) {
+	if (!configured)
+		return 0;
+
+	if ((seek && offset != acked) || state == _SEEK) {
+		_seek(seek ? offset : target);
+	}
+	else {
+		_rewind();
+		retries = 0;
+		state = _STREAM;
+	}
+	return 1;
+}
+
+void Dump_Abort(void) {
+	state = _IDLE;
+	configured = 0;
+}
+
+/*!
+ * @brief True while frames are being sent or sought
+ */
+_Bool Dump_Active(void) {
+	return state == _SEEK || state == _STREAM;
+}
+
+/*!
+ * @brief Advances the dump; call from the main loop
+ */
+void Dump_Poll(void) {
+	switch (state) {
+	case _SEEK: _pollSeek(); break;
+	case _STREAM: _pollStream(); break;
+	default: break;
+	}
+}
+
+/*!
+ * @brief CRC-32 as used by zlib, nibble-table version (64 bytes of table)
+ * @param crc 0, or a previous result to continue
+ */
+uint32_t Dump_Crc32(uint32_t crc, const uint8_t *data, uint32_t len) {
+	crc = ~crc;
+	while (len--) {
+		crc ^= *data++;
+		crc = (crc >> 4) ^ _crcTable[crc & 0x0FU];
+		crc = (crc >> 4) ^ _crcTable[crc & 0x0FU];
+	}
+	return ~crc;
+}
+
+/*! End of file dump.c **/
@@ -0,0 +1,84 @@
+/*!
+ * @file event_queue.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Lock-free SPSC event ring. See event_queue.h for the usage rules.
+ *
+ * Ordering: the producer fills the slot, issues a DMB and only then
+ * publishes head; the consumer reads head, issues a DMB before reading the
+ * slot, and another before publishing tail so the slot is not reused while
+ * it is still being copied out.
+ */
+
+#include "event_queue.h"
+
+/*!
+ * @brief Attaches storage to a queue and empties it
+ * @param *q Pointer to the queue
+ * @param *storage Array of capacity events
+ * @param capacity Number of slots, a power of two
+ */
+void EventQueue_Init(EventQueue_TypeDef *q, Event_TypeDef *storage, uint32_t capacity) {
+	q->head = 0;
+	q->tail = 0;
+	q->dropped = 0;
+	q->mask = capacity - 1U;
+	q->slot = storage;
+}
+
+/*!
+ * @brief Appends an event; producer side only
+ * @param *q Pointer to the queue
+ * @param id Event_IdTypeDef of the event
+ * @param source Raising instance
+ * @param arg Type-specific payload
+ * @param timestamp Time the event was raised
+ * @return True if queued, false if the ring was full
+ */
+_Bool EventQueue_Push(EventQueue_TypeDef *q, uint8_t id, uint8_t source, uint16_t arg, uint32_t timestamp) {
+	uint32_t head = q->head;
+	if (head - q->tail > q->mask) {
+		q->dropped++;
+		return 0;
+	}
+
+	Event_TypeDef *e = &q->slot[head & q->mask];
+	e->id = id;
+	e->source = source;
+	e->arg = arg;
+	e->timestamp = timestamp;
+
+	__DMB();
+	q->head = head + 1U;
+	return 1;
+}
+
+/*!
+ * @brief Removes the oldest event; consumer side only
+ * @param *q Pointer to the queue
+ * @param *e Receives the event
+ * @return True if an event was returned, false if the ring was empty
+ */
+_Bool EventQueue_Pop(EventQueue_TypeDef *q, Event_TypeDef *e) {
+	uint32_t tail = q->tail;
+	if (tail == q->head)
+		return 0;
+
+	__DMB();
+	*e = q->slot[tail & q->mask];
+	__DMB();
+	q->tail = tail + 1U;
+	return 1;
+}
+
+/*!
+ * @brief Number of events waiting; exact on the consumer side
+ */
+uint32_t EventQueue_Count(EventQueue_TypeDef *q) {
+	return q->head - q->tail;
+}
+
+/*! End of file event_queue.c **/
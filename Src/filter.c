@@ -0,0 +1,161 @@
+/*!
+ * @file filter.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Streaming filters. See filter.h.
+ */
+
+#include "filter.h"
+
+#define _FRAC			8		/**< Fractional bits of acc for EMA/KALMAN **/
+#define _P_MAX			0xFFFFU
+
+/*!
+ * Static function definitions
+ */
+
+static int16_t _round(int32_t acc) {
+	return (int16_t)((acc + (1 << (_FRAC - 1))) >> _FRAC);
+}
+
+static int16_t _average(Filter_TypeDef *f, int16_t x) {
+	if (f->count == f->config.window) {
+		f->acc -= f->ring[f->next];
+	}
+	else {
+		f->count++;
+	}
+	f->acc += x;
+	f->ring[f->next] = x;
+	if (++f->next == f->config.window)
+		f->next = 0;
+
+	int32_t half = (int32_t)(f->count / 2U);
+	return (int16_t)((f->acc + (f->acc < 0 ? -half : half)) / (int32_t)f->count);
+}
+
+static int16_t _ema(Filter_TypeDef *f, int16_t x) {
+	int32_t target = (int32_t)x * (1 << _FRAC);
+
+	if (!f->count++)
+		f->acc = target;
+	else
+		f->acc += (int32_t)(((int64_t)(target - f->acc) * f->config.alpha) >> 16);
+	return _round(f->acc);
+}
+
+/*!
+ * @brief Swaps the value at i into its place in the otherwise sorted window
+ */
+static void _settle(int16_t *s, uint32_t n, uint32_t i) {
+	int16_t v = s[i];
+	while (i > 0 && s[i - 1U] > v) {
+		s[i] = s[i - 1U];
+		i--;
+	}
+	while (i + 1U < n && s[i + 1U] < v) {
+		s[i] = s[i + 1U];
+		i++;
+	}
+	s[i] = v;
+}
+
+static int16_t _median(Filter_TypeDef *f, int16_t x) {
+	uint32_t i;
+
+	if (f->count == f->config.window) {
+		int16_t old = f->ring[f->next];
+		for (i = 0; f->sorted[i] != old; i++) {
+		}
+	}
+	else {
+		i = f->count++;
+	}
+	f->sorted[i] = x;
+	_settle(f->sorted, f->count, i);
+
+	f->ring[f->next] = x;
+	if (++f->next == f->config.window)
+		f->next = 0;
+
+	uint32_t mid = f->count / 2U;
+	if (f->count & 1U)
+		return f->sorted[mid];
+	return (int16_t)(((int32_t)f->sorted[mid - 1U] + f->sorted[mid]) / 2);
+}
+
+static int16_t _kalman(Filter_TypeDef *f, int16_t x) {
+	int32_t z = (int32_t)x * (1 << _FRAC);
+
+	if (!f->count++) {
+		f->acc = z;
+		f->p = f->config.r;
+		return x;
+	}
+
+	/* Predict, then weigh the measurement by k = p / (p + r) in Q16 */
+	f->p += f->config.q;
+	if (f->p > _P_MAX)
+		f->p = _P_MAX;
+	uint32_t den = f->p + f->config.r;
+	uint32_t k = den ? (f->p << 16) / den : 0x10000U;
+
+	f->acc += (int32_t)(((int64_t)(z - f->acc) * k) >> 16);
+	f->p -= (uint32_t)(((uint64_t)f->p * k) >> 16);
+	return _round(f->acc);
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Configures a filter and clears its history
+ * @param *f Pointer to the filter
+ * @param *config Settings; windows are clamped to 1..FILTER_WINDOW_MAX and a
+ * zero alpha to 1
+ */
+void Filter_Init(Filter_TypeDef *f, const Filter_ConfigTypeDef *config) {
+	f->config = *config;
+	if (f->config.window < 1U)
+		f->config.window = 1U;
+	if (f->config.window > FILTER_WINDOW_MAX)
+		f->config.window = FILTER_WINDOW_MAX;
+	if (!f->config.alpha)
+		f->config.alpha = 1U;
+	Filter_Reset(f);
+}
+
+/*!
+ * @brief Clears the history; the next sample starts the filter afresh
+ */
+void Filter_Reset(Filter_TypeDef *f) {
+	f->count = 0;
+	f->next = 0;
+	f->acc = 0;
+	f->p = 0;
+}
+
+/*!
+ * @brief Filters one sample
+ * @param *f Pointer to the filter
+ * @param value Sample in hundredths
+ * @return Filtered value in hundredths, SAMPLE_INVALID for an invalid input
+ */
+int16_t Filter_Update(Filter_TypeDef *f, int16_t value) {
+	if (value == SAMPLE_INVALID)
+		return SAMPLE_INVALID;
+
+	switch (f->config.kind) {
+	case FILTER_AVERAGE: return _average(f, value);
+	case FILTER_EMA: return _ema(f, value);
+	case FILTER_MEDIAN: return _median(f, value);
+	case FILTER_KALMAN: return _kalman(f, value);
+	default: return value;
+	}
+}
+
+/*! End of file filter.c **/
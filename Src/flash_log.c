@@ -0,0 +1,439 @@
+/*!
+ * @file flash_log.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Wear-leveled sample log in four flash sectors, in bank 2 when the device
+ * is in dual-bank mode. See flash_log.h for the layout and rotation scheme.
+ *
+ * Everything except the erase completion callbacks runs in the main loop.
+ * While an erase is in flight the HAL holds the flash lock, so FlashLog_Poll()
+ * leaves records in the RAM queue until the FLASH interrupt reports the
+ * sector done.
+ */
+
+#include "flash_log.h"
+#include <string.h>
+
+#define _ERASED			0xFFFFFFFFU
+#define _VOID			0U				/**< Time of a slot that failed or was torn **/
+#define _PENDING_MASK	(FLASH_LOG_PENDING - 1U)
+
+const static uint32_t _IRQ_PRIORITY = 15; // below everything time-critical
+
+static FlashLog_RecordTypeDef pending[FLASH_LOG_PENDING];
+static uint32_t pendingHead;
+static uint32_t pendingTail;
+
+static uint32_t logBase;		/**< Address of the first log sector **/
+static uint32_t sectorSize;
+static uint32_t firstSector;	/**< HAL sector number of the first log sector **/
+static uint32_t perSector;		/**< Records per sector **/
+
+static uint32_t active;			/**< Ring index of the sector being written **/
+static uint32_t activeSeq;
+static uint32_t fill;			/**< Records already in the active sector **/
+static uint32_t timeBase;		/**< Log time at boot **/
+static uint32_t lastTime;		/**< Log time of the newest record **/
+static _Bool haveLast;
+static _Bool mounted;
+
+static volatile _Bool eraseBusy;
+static volatile _Bool nextReady;	/**< Sector after active is verified blank **/
+
+static FlashLog_StatsTypeDef stats;
+
+/*!
+ * Static function definitions
+ */
+
+static uint32_t _sectorBase(uint32_t sector) {
+	return logBase + sector * sectorSize;
+}
+
+static const FlashLog_RecordTypeDef *_record(uint32_t sector, uint32_t index) {
+	return (const FlashLog_RecordTypeDef *)(_sectorBase(sector) + FLASH_LOG_HEADER_SIZE + index * FLASH_LOG_RECORD_SIZE);
+}
+
+static _Bool _headerValid(uint32_t sector, uint32_t *seq) {
+	const volatile uint32_t *h = (const volatile uint32_t *)_sectorBase(sector);
+	if (h[0] != FLASH_LOG_MAGIC)
+		return 0;
+	if (seq)
+		*seq = h[1];
+	return 1;
+}
+
+/*!
+ * @brief Finds the first erased record in a sector
+ *
+ * Records are only ever appended, so the written ones form a prefix and a
+ * binary search needs at most log2(32767) + 1 = 16 reads.
+ */
+static uint32_t _fill(uint32_t sector) {
+	uint32_t lo = 0;
+	uint32_t hi = perSector;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2U;
+		if (_record(sector, mid)->time == _ERASED)
+			hi = mid;
+		else
+			lo = mid + 1U;
+	}
+	return lo;
+}
+
+static _Bool _blank(uint32_t sector) {
+	const volatile uint32_t *p = (const volatile uint32_t *)_sectorBase(sector);
+	for (uint32_t i = 0; i < sectorSize / 4U; i++) {
+		if (p[i] != _ERASED)
+			return 0;
+	}
+	return 1;
+}
+
+/*!
+ * @brief Programs a record or header
+ *
+ * The high word goes first and the low word (time or magic), which marks
+ * the slot as used, last, so a reset in between leaves a slot that still
+ * reads as erased and is voided at the next mount.
+ */
+static HAL_StatusTypeDef _program(uint32_t address, uint32_t lo, uint32_t hi) {
+	HAL_StatusTypeDef status;
+
+	HAL_FLASH_Unlock();
+#if FLASH_LOG_PROGRAM_DOUBLEWORD
+	status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, address, ((uint64_t)hi << 32) | lo);
+#else
+	status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + 4U, hi);
+	if (status == HAL_OK)
+		status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, lo);
+#endif
+	HAL_FLASH_Lock();
+
+	if (status != HAL_OK)
+		stats.errors++;
+	return status;
+}
+
+/*!
+ * @brief Marks a slot as used but empty so the written records stay a prefix
+ *
+ * Clearing bits needs no erase, so the all-zero time can go over whatever a
+ * failed or interrupted program left behind.
+ * @return False if even that failed; the caller then gives up on the sector
+ */
+static _Bool _void(uint32_t address) {
+	HAL_StatusTypeDef status;
+
+	HAL_FLASH_Unlock();
+	status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, _VOID);
+	HAL_FLASH_Lock();
+
+	if (status != HAL_OK)
+		stats.errors++;
+	return status == HAL_OK;
+}
+
+/*!
+ * @brief Time of the newest real record among the first n of a sector
+ */
+static _Bool _lastTime(uint32_t sector, uint32_t n, uint32_t *time) {
+	while (n--) {
+		uint32_t t = _record(sector, n)->time;
+		if (t != _VOID) {
+			*time = t;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void _startErase(uint32_t sector) {
+	FLASH_EraseInitTypeDef erase = {0};
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Sector = firstSector + sector;
+	erase.NbSectors = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	HAL_FLASH_Unlock();
+	eraseBusy = 1;
+	if (HAL_FLASHEx_Erase_IT(&erase) != HAL_OK) {
+		eraseBusy = 0;
+		HAL_FLASH_Lock();
+		stats.errors++;
+		return;
+	}
+	stats.erases++;
+}
+
+/*!
+ * @brief Moves the active sector on to the next (pre-erased) one
+ * @return True if the new sector is ready for records
+ */
+static _Bool _rotate(void) {
+	uint32_t next = (active + 1U) % FLASH_LOG_SECTORS;
+	if (_program(_sectorBase(next), FLASH_LOG_MAGIC, activeSeq + 1U) != HAL_OK)
+		return 0;
+	active = next;
+	activeSeq++;
+	fill = 0;
+	nextReady = 0;
+	return 1;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Mounts the log, formatting the first sector if none is valid
+ * @param now Current sample time, App_Time()
+ * @return True on success, false if flash fails
+ */
+_Bool FlashLog_Init(uint32_t now) {
+	uint32_t seq;
+	_Bool found = 0;
+
+	/* In dual-bank mode the log sits in bank 2 and erases don't stall bank 1 */
+	if ((FLASH->OPTCR & FLASH_OPTCR_nDBANK) == 0) {
+		logBase = FLASH_LOG_BANK2_BASE;
+		sectorSize = FLASH_LOG_BANK2_SECTOR_SIZE;
+		firstSector = FLASH_LOG_BANK2_FIRST_SECTOR;
+	}
+	else {
+		logBase = FLASH_LOG_BASE;
+		sectorSize = FLASH_LOG_SECTOR_SIZE;
+		firstSector = FLASH_LOG_FIRST_SECTOR;
+	}
+	perSector = FLASH_LOG_RECORDS_PER_SECTOR(sectorSize);
+
+	for (uint32_t s = 0; s < FLASH_LOG_SECTORS; s++) {
+		if (_headerValid(s, &seq) && (!found || seq > activeSeq)) {
+			active = s;
+			activeSeq = seq;
+			found = 1;
+		}
+	}
+
+	if (!found) {
+		FLASH_EraseInitTypeDef erase = {0};
+		uint32_t sectorError;
+		erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+		erase.Sector = firstSector;
+		erase.NbSectors = 1;
+		erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+		HAL_FLASH_Unlock();
+		HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &sectorError);
+		HAL_FLASH_Lock();
+		if (status != HAL_OK)
+			return 0;
+
+		active = 0;
+		activeSeq = 1;
+		if (_program(_sectorBase(active), FLASH_LOG_MAGIC, activeSeq) != HAL_OK)
+			return 0;
+	}
+
+	fill = _fill(active);
+
+	/* A reset between the two words of a record leaves its values behind */
+	if (fill < perSector && ((const volatile uint32_t *)_record(active, fill))[1] != _ERASED) {
+		if (_void((uint32_t)_record(active, fill)))
+			fill++;
+		else
+			fill = perSector;
+	}
+
+	/* Continue the time base from the newest record, wherever it is */
+	haveLast = _lastTime(active, fill, &lastTime);
+	if (!haveLast) {
+		uint32_t prev = (active + FLASH_LOG_SECTORS - 1U) % FLASH_LOG_SECTORS;
+		if (_headerValid(prev, &seq) && seq == activeSeq - 1U)
+			haveLast = _lastTime(prev, _fill(prev), &lastTime);
+	}
+	/* A new log starts at 1 so that no real record has the void time */
+	timeBase = (haveLast ? lastTime : 0U) + 1U - now;
+
+	/* A reset during an erase can leave the next sector half-done */
+	nextReady = _blank((active + 1U) % FLASH_LOG_SECTORS);
+	eraseBusy = 0;
+	pendingHead = pendingTail = 0;
+
+	HAL_NVIC_SetPriority(FLASH_IRQn, _IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(FLASH_IRQn);
+
+	mounted = 1;
+	return 1;
+}
+
+/*!
+ * @brief Queues a sample for the log, at most one per FLASH_LOG_INTERVAL_S
+ * @param *sample Pointer to the sample; time is App_Time()
+ */
+void FlashLog_Append(const Sample_TypeDef *sample) {
+	if (!mounted)
+		return;
+
+	uint32_t time = FlashLog_Time(sample->time);
+	if (haveLast && time - lastTime < FLASH_LOG_INTERVAL_S)
+		return;
+
+	if (pendingHead - pendingTail > _PENDING_MASK) {
+		stats.dropped++;
+		return;
+	}
+
+	FlashLog_RecordTypeDef *r = &pending[pendingHead & _PENDING_MASK];
+	r->time = time;
+	r->humidity = sample->humidity;
+	r->temperature = sample->temperature;
+	pendingHead++;
+
+	lastTime = time;
+	haveLast = 1;
+}
+
+/*!
+ * @brief Writes queued records and schedules erase-ahead; call from the main loop
+ */
+void FlashLog_Poll(void) {
+	if (!mounted || eraseBusy)
+		return;
+
+	while (pendingTail != pendingHead) {
+		if (fill >= perSector) {
+			if (!nextReady) {
+				_startErase((active + 1U) % FLASH_LOG_SECTORS);
+				return;
+			}
+			if (!_rotate())
+				return;
+		}
+
+		const FlashLog_RecordTypeDef *r = &pending[pendingTail & _PENDING_MASK];
+		uint32_t address = (uint32_t)_record(active, fill);
+		uint32_t hi = (uint16_t)r->humidity | ((uint32_t)(uint16_t)r->temperature << 16);
+
+		/* A failed slot is voided and skipped rather than retried forever */
+		if (_program(address, r->time, hi) == HAL_OK) {
+			stats.appended++;
+			fill++;
+		}
+		else if (_void(address))
+			fill++;
+		else
+			fill = perSector;	// the rest stays erased, so the prefix holds
+		pendingTail++;
+	}
+
+	if (!nextReady && fill >= perSector / 2U)
+		_startErase((active + 1U) % FLASH_LOG_SECTORS);
+}
+
+/*!
+ * @brief Converts sample time to log time
+ */
+uint32_t FlashLog_Time(uint32_t time) {
+	return timeBase + time;
+}
+
+/*!
+ * @brief Number of records currently readable, counting any voided slots
+ */
+uint32_t FlashLog_Count(void) {
+	FlashLog_CursorTypeDef cursor;
+	uint32_t n = 0;
+
+	if (!mounted)
+		return 0;
+
+	/* Whole sectors are counted by search, not by walking every record */
+	FlashLog_Begin(&cursor);
+	while (cursor.remaining) {
+		uint32_t s = cursor.sector;
+		uint32_t seq;
+		if (!(eraseBusy && s == (active + 1U) % FLASH_LOG_SECTORS) && _headerValid(s, &seq))
+			n += (s == active) ? fill : _fill(s);
+		cursor.sector = (s + 1U) % FLASH_LOG_SECTORS;
+		cursor.remaining--;
+	}
+	return n;
+}
+
+/*!
+ * @brief Positions a cursor on the oldest record
+ */
+void FlashLog_Begin(FlashLog_CursorTypeDef *cursor) {
+	cursor->sector = (active + 1U) % FLASH_LOG_SECTORS;
+	cursor->record = 0;
+	cursor->remaining = mounted ? FLASH_LOG_SECTORS : 0;
+}
+
+/*!
+ * @brief Reads the record under the cursor and advances it, oldest first
+ * @param *cursor Pointer to a cursor set up by FlashLog_Begin
+ * @param *record Receives the record
+ * @return True if a record was returned, false at the end of the log
+ */
+_Bool FlashLog_Next(FlashLog_CursorTypeDef *cursor, FlashLog_RecordTypeDef *record) {
+	while (cursor->remaining) {
+		uint32_t s = cursor->sector;
+		uint32_t seq;
+		uint32_t limit = (s == active) ? fill : perSector;
+		_Bool readable = !(eraseBusy && s == (active + 1U) % FLASH_LOG_SECTORS) && _headerValid(s, &seq);
+
+		while (readable && cursor->record < limit) {
+			const FlashLog_RecordTypeDef *r = _record(s, cursor->record);
+			if (r->time == _ERASED)
+				break;
+			cursor->record++;
+			if (r->time != _VOID) {
+				memcpy(record, r, sizeof(*record));
+				return 1;
+			}
+		}
+
+		cursor->sector = (s + 1U) % FLASH_LOG_SECTORS;
+		cursor->record = 0;
+		cursor->remaining--;
+	}
+	return 0;
+}
+
+/*!
+ * @brief Log counters since boot
+ */
+const FlashLog_StatsTypeDef *FlashLog_Stats(void) {
+	return &stats;
+}
+
+/*!
+ * Callback function definitions
+ */
+
+/*!
+ * @brief Flash interrupt completion; 0xFFFFFFFF marks the end of an erase
+ */
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue) {
+	if (ReturnValue == 0xFFFFFFFFU && eraseBusy) {
+		HAL_FLASH_Lock();
+		nextReady = 1;
+		eraseBusy = 0;
+	}
+}
+
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue) {
+	(void)ReturnValue;
+	if (eraseBusy) {
+		HAL_FLASH_Lock();
+		stats.errors++;
+		eraseBusy = 0;
+	}
+}
+
+/*! End of file flash_log.c **/
@@ -0,0 +1,484 @@
+/*!
+ * @file i2c_reg.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Register-level I2C master transfers. See i2c_reg.h.
+ */
+
+#include "i2c_reg.h"
+#include "cycles.h"
+
+#define _MAX_BYTES		255U		/**< NBYTES without RELOAD **/
+#define _MAX_TIMEOUT	10000U		/**< ms; CYCCNT wraps after ~19.9 s **/
+#define _ERRORS			(I2C_ISR_NACKF | I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR)
+#define _CLEAR_ALL		(I2C_ICR_NACKCF | I2C_ICR_STOPCF | I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF)
+#define _IRQS			(I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_NACKIE | I2C_CR1_STOPIE | I2C_CR1_ERRIE)
+#define _DMA_CLEAR0		(DMA_LIFCR_CFEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTCIF0)
+#define _DMA_CLEAR6		(DMA_HIFCR_CFEIF6 | DMA_HIFCR_CDMEIF6 | DMA_HIFCR_CTEIF6 | DMA_HIFCR_CHTIF6 | DMA_HIFCR_CTCIF6)
+
+/*!
+ * @typedef I2CReg_BusTypeDef refers to the interrupt-driven transfer of one instance
+ */
+typedef struct {
+	uint8_t *data;
+	uint16_t left;
+	_Bool queued;				/**< Completion goes to the queue, not a waiting caller **/
+	uint32_t tag;
+	volatile uint32_t error;	/**< HAL_I2C_ERROR_* bits **/
+	volatile _Bool busy;
+	volatile uint32_t received;	/**< DWT stamp of the last byte read **/
+	I2CReg_CompletionTypeDef queue[I2C_REG_QUEUE];
+	volatile uint32_t head;		/**< Written by the interrupt **/
+	volatile uint32_t tail;		/**< Written by the thread **/
+} I2CReg_BusTypeDef;
+
+static I2CReg_BusTypeDef buses[I2C_REG_BUSES];
+static I2C_TypeDef *const instances[I2C_REG_BUSES] = {I2C1, I2C2, I2C3, I2C4};
+static const IRQn_Type eventIrqs[I2C_REG_BUSES] = {I2C1_EV_IRQn, I2C2_EV_IRQn, I2C3_EV_IRQn, I2C4_EV_IRQn};
+static const IRQn_Type errorIrqs[I2C_REG_BUSES] = {I2C1_ER_IRQn, I2C2_ER_IRQn, I2C3_ER_IRQn, I2C4_ER_IRQn};
+
+/*!
+ * Static function definitions
+ */
+
+static I2CReg_BusTypeDef *_bus(const I2C_TypeDef *i2c) {
+	for (uint32_t b = 0; b < I2C_REG_BUSES; b++) {
+		if (instances[b] == i2c)
+			return &buses[b];
+	}
+	return 0;
+}
+
+static uint32_t _errorCode(uint32_t isr) {
+	uint32_t error = HAL_I2C_ERROR_NONE;
+	if (isr & I2C_ISR_NACKF)
+		error |= HAL_I2C_ERROR_AF;
+	if (isr & I2C_ISR_BERR)
+		error |= HAL_I2C_ERROR_BERR;
+	if (isr & I2C_ISR_ARLO)
+		error |= HAL_I2C_ERROR_ARLO;
+	if (isr & I2C_ISR_OVR)
+		error |= HAL_I2C_ERROR_OVR;
+	return error;
+}
+
+static _Bool _expired(uint32_t start, uint32_t limit) {
+	return Cycles_Now() - start > limit;
+}
+
+static _Bool _dmaUsed(const I2C_TypeDef *i2c) {
+	return I2C_REG_MODE == I2C_REG_DMA && i2c == I2C1;
+}
+
+static void _dmaStop(void) {
+#if I2C_REG_MODE == I2C_REG_DMA
+	DMA1_Stream0->CR &= ~DMA_SxCR_EN;
+	DMA1_Stream6->CR &= ~DMA_SxCR_EN;
+#endif
+}
+
+/*!
+ * @brief Leaves the peripheral idle and clean after a failed transfer
+ * @return HAL_TIMEOUT for a timeout, HAL_ERROR otherwise
+ */
+static HAL_StatusTypeDef _abort(I2C_HandleTypeDef *hi2c, uint32_t error) {
+	I2C_TypeDef *i2c = hi2c->Instance;
+
+	i2c->CR1 &= ~(_IRQS | I2C_CR1_TXDMAEN | I2C_CR1_RXDMAEN);
+	if (_dmaUsed(i2c))
+		_dmaStop();
+	if (error & HAL_I2C_ERROR_TIMEOUT) {
+		/* Software reset; PE has to stay low for three APB clocks */
+		i2c->CR1 &= ~I2C_CR1_PE;
+		for (uint32_t k = 0; k < 3U; k++) {
+			(void)i2c->CR1;
+		}
+		i2c->CR1 |= I2C_CR1_PE;
+	}
+	i2c->ICR = _CLEAR_ALL;
+	i2c->ISR = I2C_ISR_TXE;			/* flushes TXDR */
+	i2c->CR2 = 0;
+	hi2c->ErrorCode |= error;
+	return (error & HAL_I2C_ERROR_TIMEOUT) ? HAL_TIMEOUT : HAL_ERROR;
+}
+
+/*!
+ * @brief Waits for the bus to be free
+ */
+static _Bool _idle(I2C_TypeDef *i2c, uint32_t start, uint32_t limit) {
+	while (i2c->ISR & I2C_ISR_BUSY) {
+		if (_expired(start, limit))
+			return 0;
+	}
+	return 1;
+}
+
+/*!
+ * @brief Starts a transfer: address, count and direction in one CR2 write
+ */
+static void _go(I2C_TypeDef *i2c, uint16_t address, uint16_t len, _Bool rx) {
+	i2c->CR2 = (address & I2C_CR2_SADD) | ((uint32_t)len << I2C_CR2_NBYTES_Pos) |
+			(rx ? I2C_CR2_RD_WRN : 0U) | I2C_CR2_AUTOEND | I2C_CR2_START;
+}
+
+/*!
+ * @brief Waits for any of the given ISR flags
+ * @return HAL_I2C_ERROR_NONE once one is set, else the error bits
+ */
+static uint32_t _wait(I2C_TypeDef *i2c, uint32_t flags, uint32_t start, uint32_t limit) {
+	for (;;) {
+		uint32_t isr = i2c->ISR;
+		if (isr & _ERRORS) {
+			/* AUTOEND sends STOP after a NACK; let it go out before cleaning up */
+			while ((isr & I2C_ISR_NACKF) && !(i2c->ISR & I2C_ISR_STOPF) && !_expired(start, limit)) {
+			}
+			return _errorCode(isr);
+		}
+		if (isr & flags)
+			return HAL_I2C_ERROR_NONE;
+		if (_expired(start, limit))
+			return HAL_I2C_ERROR_TIMEOUT;
+	}
+}
+
+/*!
+ * @brief Polled transfer, any instance
+ */
+static HAL_StatusTypeDef _poll(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len,
+		_Bool rx, uint32_t start, uint32_t limit) {
+	I2C_TypeDef *i2c = hi2c->Instance;
+	uint32_t error;
+
+	_go(i2c, address, len, rx);
+	for (uint16_t i = 0; i < len; i++) {
+		error = _wait(i2c, rx ? I2C_ISR_RXNE : I2C_ISR_TXIS, start, limit);
+		if (error)
+			return _abort(hi2c, error);
+		if (rx)
+			data[i] = (uint8_t)i2c->RXDR;
+		else
+			i2c->TXDR = data[i];
+	}
+	if (rx && _bus(i2c))
+		_bus(i2c)->received = Cycles_Now();
+
+	error = _wait(i2c, I2C_ISR_STOPF, start, limit);
+	if (error)
+		return _abort(hi2c, error);
+	i2c->ICR = I2C_ICR_STOPCF;
+	i2c->CR2 = 0;
+	return HAL_OK;
+}
+
+#if I2C_REG_MODE == I2C_REG_DMA
+/*!
+ * @brief Arms the I2C1 DMA stream for one transfer
+ */
+static void _dma(I2C_TypeDef *i2c, _Bool rx, uint8_t *data, uint16_t len) {
+	DMA_Stream_TypeDef *s = rx ? DMA1_Stream0 : DMA1_Stream6;
+
+	s->CR &= ~DMA_SxCR_EN;
+	while (s->CR & DMA_SxCR_EN) {
+	}
+	if (rx)
+		DMA1->LIFCR = _DMA_CLEAR0;
+	else
+		DMA1->HIFCR = _DMA_CLEAR6;
+	s->PAR = (uint32_t)(rx ? &i2c->RXDR : &i2c->TXDR);
+	s->M0AR = (uint32_t)data;
+	s->NDTR = len;
+	s->FCR = 0;						/* direct mode */
+	s->CR = (1U << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | (rx ? 0U : DMA_SxCR_DIR_0) | DMA_SxCR_EN;
+}
+#endif
+
+/*!
+ * @brief Hands a transfer to the interrupt (and on I2C1 in DMA mode, the DMA)
+ */
+static void _begin(I2CReg_BusTypeDef *bus, I2C_TypeDef *i2c, uint16_t address, uint8_t *data, uint16_t len,
+		_Bool rx) {
+	uint32_t enable = _IRQS;
+
+	bus->data = data;
+	bus->left = len;
+	bus->error = HAL_I2C_ERROR_NONE;
+	bus->busy = 1;
+#if I2C_REG_MODE == I2C_REG_DMA
+	if (_dmaUsed(i2c)) {
+		enable = I2C_CR1_NACKIE | I2C_CR1_STOPIE | I2C_CR1_ERRIE;
+		if (len) {
+			_dma(i2c, rx, data, len);
+			enable |= rx ? I2C_CR1_RXDMAEN : I2C_CR1_TXDMAEN;
+		}
+	}
+#endif
+	i2c->CR1 |= enable;
+	_go(i2c, address, len, rx);
+}
+
+/*!
+ * @brief Closes a bus's transfer from its interrupt
+ */
+static void _end(I2CReg_BusTypeDef *bus, I2C_TypeDef *i2c) {
+	i2c->CR1 &= ~(_IRQS | I2C_CR1_TXDMAEN | I2C_CR1_RXDMAEN);
+	if (_dmaUsed(i2c))
+		_dmaStop();
+	if (bus->queued && bus->head - bus->tail < I2C_REG_QUEUE) {
+		I2CReg_CompletionTypeDef *c = &bus->queue[bus->head % I2C_REG_QUEUE];
+		c->tag = bus->tag;
+		c->error = bus->error;
+		c->stamp = Cycles_Now();
+		__DMB();
+		bus->head++;
+	}
+	bus->busy = 0;
+}
+
+#if I2C_REG_MODE != I2C_REG_POLL
+/*!
+ * @brief Interrupt or DMA transfer; sleeps until STOP
+ */
+static HAL_StatusTypeDef _interrupt(I2C_HandleTypeDef *hi2c, I2CReg_BusTypeDef *bus, uint16_t address,
+		uint8_t *data, uint16_t len, _Bool rx, uint32_t start, uint32_t limit) {
+	I2C_TypeDef *i2c = hi2c->Instance;
+
+	bus->queued = 0;
+	_begin(bus, i2c, address, data, len, rx);
+
+	/* PRIMASK keeps the completion from slipping in between test and WFI */
+	while (bus->busy) {
+		if (_expired(start, limit))
+			break;
+		__disable_irq();
+		if (bus->busy)
+			__WFI();
+		__enable_irq();
+	}
+
+	if (bus->busy) {
+		bus->busy = 0;
+		return _abort(hi2c, HAL_I2C_ERROR_TIMEOUT);
+	}
+	if (bus->error)
+		return _abort(hi2c, bus->error);
+	i2c->CR2 = 0;
+	return HAL_OK;
+}
+#endif
+
+static HAL_StatusTypeDef _transfer(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len,
+		_Bool rx, uint32_t timeout) {
+	uint32_t start = Cycles_Now();
+	uint32_t limit = (timeout > _MAX_TIMEOUT ? _MAX_TIMEOUT : timeout) * (SystemCoreClock / 1000U);
+	I2CReg_BusTypeDef *bus = _bus(hi2c->Instance);
+
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	if (len > _MAX_BYTES)
+		return HAL_ERROR;
+	if ((bus && bus->busy) || !_idle(hi2c->Instance, start, limit))
+		return HAL_BUSY;
+#if I2C_REG_MODE != I2C_REG_POLL
+	if (bus)
+		return _interrupt(hi2c, bus, address, data, len, rx, start, limit);
+#endif
+	return _poll(hi2c, address, data, len, rx, start, limit);
+}
+
+/*!
+ * @brief Event interrupt: moves bytes unless DMA does, ends the transfer on STOP
+ */
+static void _event(I2CReg_BusTypeDef *bus, I2C_TypeDef *i2c) {
+	uint32_t isr = i2c->ISR;
+	uint32_t cr1 = i2c->CR1;
+
+	if (isr & I2C_ISR_NACKF) {
+		i2c->ICR = I2C_ICR_NACKCF;
+		bus->error |= HAL_I2C_ERROR_AF;
+	}
+	if ((cr1 & I2C_CR1_RXIE) && (isr & I2C_ISR_RXNE) && bus->left) {
+		*bus->data++ = (uint8_t)i2c->RXDR;
+		if (!--bus->left)
+			bus->received = Cycles_Now();
+	}
+	if ((cr1 & I2C_CR1_TXIE) && (isr & I2C_ISR_TXIS) && bus->left) {
+		i2c->TXDR = *bus->data++;
+		bus->left--;
+	}
+	if (isr & I2C_ISR_STOPF) {
+		/* The DMA took the bytes; STOP is the first the CPU hears of the last one */
+		if (_dmaUsed(i2c) && (i2c->CR2 & I2C_CR2_RD_WRN))
+			bus->received = Cycles_Now();
+		i2c->ICR = I2C_ICR_STOPCF;
+		_end(bus, i2c);
+	}
+}
+
+/*!
+ * @brief Error interrupt: bus error, arbitration loss or overrun ends the transfer
+ */
+static void _error(I2CReg_BusTypeDef *bus, I2C_TypeDef *i2c) {
+	uint32_t isr = i2c->ISR;
+
+	i2c->ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+	bus->error |= _errorCode(isr & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR));
+	_end(bus, i2c);
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Prepares register-level transfers on an initialized I2C handle
+ * @param *hi2c Pointer to the handle, after MX_I2Cx_Init
+ *
+ * Starts the DWT cycle counter if nothing has yet and enables the
+ * instance's interrupts (and for I2C1 in DMA mode, the DMA1 clock).
+ */
+void I2CReg_Init(I2C_HandleTypeDef *hi2c) {
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+		Cycles_Init();
+	for (uint32_t b = 0; b < I2C_REG_BUSES; b++) {
+		if (instances[b] != hi2c->Instance)
+			continue;
+		if (_dmaUsed(hi2c->Instance))
+			__HAL_RCC_DMA1_CLK_ENABLE();
+		buses[b].busy = 0;
+		buses[b].head = buses[b].tail = 0;
+		HAL_NVIC_SetPriority(eventIrqs[b], I2C_REG_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(eventIrqs[b]);
+		HAL_NVIC_SetPriority(errorIrqs[b], I2C_REG_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(errorIrqs[b]);
+	}
+}
+
+/*!
+ * @brief Writes bytes to a device, like HAL_I2C_Master_Transmit
+ * @param *hi2c Pointer to the I2C handle
+ * @param address 7-bit address in [7:1]
+ * @param *data Bytes to send
+ * @param len Number of bytes, 0-255; 0 only addresses the device
+ * @param timeout Timeout in ms, capped at 10 s
+ * @return HAL status; hi2c->ErrorCode has the HAL_I2C_ERROR_* bits
+ */
+HAL_StatusTypeDef I2CReg_Transmit(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, uint32_t timeout) {
+	return _transfer(hi2c, address, data, len, 0, timeout);
+}
+
+/*!
+ * @brief Reads bytes from a device, like HAL_I2C_Master_Receive
+ * @param *hi2c Pointer to the I2C handle
+ * @param address 7-bit address in [7:1]
+ * @param *data Buffer for the bytes
+ * @param len Number of bytes, 1-255
+ * @param timeout Timeout in ms, capped at 10 s
+ * @return HAL status; hi2c->ErrorCode has the HAL_I2C_ERROR_* bits
+ */
+HAL_StatusTypeDef I2CReg_Receive(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, uint32_t timeout) {
+	return _transfer(hi2c, address, data, len, 1, timeout);
+}
+
+/*!
+ * @brief When the last byte of the latest blocking receive on a bus arrived
+ * @param *hi2c Pointer to the I2C handle
+ * @return DWT stamp of the last RXNE; in DMA mode, of the STOP that ends the read
+ */
+uint32_t I2CReg_Received(I2C_HandleTypeDef *hi2c) {
+	I2CReg_BusTypeDef *bus = _bus(hi2c->Instance);
+	return bus ? bus->received : Cycles_Now();
+}
+
+/*!
+ * @brief Starts a transfer and returns; the result arrives in the bus's queue
+ * @param *hi2c Pointer to the I2C handle, after I2CReg_Init
+ * @param address 7-bit address in [7:1]
+ * @param *data Bytes to send or buffer for the bytes, valid until completion
+ * @param len Number of bytes, 0-255
+ * @param rx 0: write, 1: read
+ * @param tag Returned with the completion
+ * @return HAL_OK once started, HAL_BUSY while the bus is in use
+ */
+HAL_StatusTypeDef I2CReg_Start(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t len, _Bool rx, uint32_t tag) {
+	I2CReg_BusTypeDef *bus = _bus(hi2c->Instance);
+
+	if (!bus || len > _MAX_BYTES)
+		return HAL_ERROR;
+	if (bus->busy || (hi2c->Instance->ISR & I2C_ISR_BUSY))
+		return HAL_BUSY;
+	bus->queued = 1;
+	bus->tag = tag;
+	_begin(bus, hi2c->Instance, address, data, len, rx);
+	return HAL_OK;
+}
+
+/*!
+ * @brief Takes the oldest completion off a bus's queue
+ * @param *hi2c Pointer to the I2C handle
+ * @param *completion Filled in with tag, HAL_I2C_ERROR_* bits and DWT stamp
+ * @return 1 if there was one, 0 if the queue is empty
+ *
+ * A failed transfer is cleaned up here, leaving the peripheral idle.
+ */
+_Bool I2CReg_Complete(I2C_HandleTypeDef *hi2c, I2CReg_CompletionTypeDef *completion) {
+	I2CReg_BusTypeDef *bus = _bus(hi2c->Instance);
+
+	if (!bus || bus->tail == bus->head)
+		return 0;
+	__DMB();
+	*completion = bus->queue[bus->tail % I2C_REG_QUEUE];
+	hi2c->ErrorCode = completion->error;
+	if (completion->error)
+		_abort(hi2c, HAL_I2C_ERROR_NONE);
+	bus->tail++;
+	return 1;
+}
+
+/*!
+ * @brief Abandons a started transfer that has not completed, with a bus reset
+ * @param *hi2c Pointer to the I2C handle
+ */
+void I2CReg_Abort(I2C_HandleTypeDef *hi2c) {
+	I2CReg_BusTypeDef *bus = _bus(hi2c->Instance);
+
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	_abort(hi2c, HAL_I2C_ERROR_TIMEOUT);
+	if (bus)
+		bus->busy = 0;
+}
+
+void I2C1_EV_IRQHandler(void) {
+	_event(&buses[0], I2C1);
+}
+
+void I2C1_ER_IRQHandler(void) {
+	_error(&buses[0], I2C1);
+}
+
+void I2C2_EV_IRQHandler(void) {
+	_event(&buses[1], I2C2);
+}
+
+void I2C2_ER_IRQHandler(void) {
+	_error(&buses[1], I2C2);
+}
+
+void I2C3_EV_IRQHandler(void) {
+	_event(&buses[2], I2C3);
+}
+
+void I2C3_ER_IRQHandler(void) {
+	_error(&buses[2], I2C3);
+}
+
+void I2C4_EV_IRQHandler(void) {
+	_event(&buses[3], I2C4);
+}
+
+void I2C4_ER_IRQHandler(void) {
+	_error(&buses[3], I2C4);
+}
+
+/*! End of file i2c_reg.c **/
@@ -0,0 +1,276 @@
+/*!
+ * @file i2c_timing.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * TIMINGR calculator. See i2c_timing.h.
+ *
+ * All times are in picoseconds so a kernel clock period (4.6 ns at
+ * 216 MHz) keeps its fraction; the longest interval handled, one SCL
+ * period at 10 kHz, still fits an int32_t.
+ */
+
+#include "i2c_timing.h"
+
+#define _PS_PER_S		1000000000000ULL
+#define _PS_PER_NS		1000
+#define _AF_MIN			(50 * _PS_PER_NS)	/**< Analog filter delay **/
+#define _AF_MAX			(260 * _PS_PER_NS)
+#define _FIELD_MAX		15
+#define _SCL_MAX		255
+
+/*!
+ * @typedef I2CTiming_ModeTypeDef refers to I2C-bus specification limits, ns
+ */
+typedef struct {
+	uint32_t rate;			/**< Fastest rate of the mode, Hz **/
+	uint16_t riseMax;
+	uint16_t fallMax;
+	uint16_t validMax;		/**< tVD;DAT **/
+	uint16_t setupMin;		/**< tSU;DAT **/
+	uint16_t lowMin;
+	uint16_t highMin;
+} I2CTiming_ModeTypeDef;
+
+static const I2CTiming_ModeTypeDef modes[] = {
+	{100000U,  1000, 300, 3450, 250, 4700, 4000},
+	{400000U,  300,  300, 900,  100, 1300, 600},
+	{1000000U, 120,  120, 450,  50,  500,  260},
+};
+
+/*!
+ * Static function definitions
+ */
+
+static int32_t _ceilDiv(int32_t a, int32_t b) {
+	return a <= 0 ? 0 : (a + b - 1) / b;
+}
+
+static int32_t _abs(int32_t x) {
+	return x < 0 ? -x : x;
+}
+
+static const I2CTiming_ModeTypeDef *_mode(uint32_t speed) {
+	for (uint32_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+		if (speed <= modes[m].rate)
+			return &modes[m];
+	}
+	return 0;
+}
+
+/*!
+ * @brief Delay of the input filters plus the two-clock synchronization
+ */
+static int32_t _sync(int32_t clk, const I2CTiming_ConfigTypeDef *config) {
+	return (config->analogFilter ? _AF_MIN : 0) + (config->digitalFilter + 2) * clk;
+}
+
+/*!
+ * @brief SYSCFG_PMC bit switching Fast-mode Plus drive on an instance's pins
+ */
+static uint32_t _fastModePlus(const I2C_TypeDef *instance) {
+	if (instance == I2C1)
+		return I2C_FASTMODEPLUS_I2C1;
+	if (instance == I2C2)
+		return I2C_FASTMODEPLUS_I2C2;
+	if (instance == I2C3)
+		return I2C_FASTMODEPLUS_I2C3;
+	return I2C_FASTMODEPLUS_I2C4;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Fills in the board defaults from i2c_timing.h for a rate
+ * @param *config Settings to fill in
+ * @param speed SCL rate, Hz
+ */
+void I2CTiming_Default(I2CTiming_ConfigTypeDef *config, uint32_t speed) {
+	config->speed = speed;
+	config->rise = I2C_TIMING_RISE_NS;
+	config->fall = I2C_TIMING_FALL_NS;
+	/* In Fast-mode Plus the filter's 260 ns worst case leaves no data hold
+	 * within tVD;DAT from a 54 MHz PCLK1 */
+	config->analogFilter = speed <= modes[1].rate;
+	config->digitalFilter = I2C_TIMING_DIGITAL_FILTER;
+}
+
+/*!
+ * @brief Finds TIMINGR for a kernel clock and bus settings
+ * @param clock I2C kernel clock, Hz
+ * @param *config Rate, rise/fall times and filters
+ * @return TIMINGR value, or 0 if the settings cannot meet the specification;
+ * below the slowest rate the clock reaches, the setting for that rate
+ */
+uint32_t I2CTiming_Compute(uint32_t clock, const I2CTiming_ConfigTypeDef *config) {
+	const I2CTiming_ModeTypeDef *m = _mode(config->speed);
+
+	if (!m || !clock || config->speed < I2C_TIMING_SPEED_MIN || config->digitalFilter > _FIELD_MAX ||
+			config->rise > m->riseMax || config->fall > m->fallMax)
+		return 0;
+
+	int32_t clk = (int32_t)(_PS_PER_S / clock);
+	int32_t rise = config->rise * _PS_PER_NS;
+	int32_t fall = config->fall * _PS_PER_NS;
+	int32_t afMin = config->analogFilter ? _AF_MIN : 0;
+	int32_t afMax = config->analogFilter ? _AF_MAX : 0;
+	int32_t dnf = config->digitalFilter * clk;
+	int32_t sync = _sync(clk, config);
+	int32_t lowMin = m->lowMin * _PS_PER_NS;
+	int32_t highMin = m->highMin * _PS_PER_NS;
+	int32_t target = (int32_t)(_PS_PER_S / config->speed);
+
+	/* Longer than PRESC, SCLL and SCLH can stretch to: take the slowest there is */
+	int32_t longest = 2 * ((_FIELD_MAX + 1) * (_SCL_MAX + 1) * clk + sync) + rise + fall;
+	if (target > longest)
+		target = longest;
+	int32_t slowest = target + target / 4;
+
+	/* Data hold must cover the fall time yet stay within the valid time;
+	 * data setup must cover the rise time */
+	int32_t sdaMin = fall - afMin - (config->digitalFilter + 3) * clk;
+	int32_t sdaMax = m->validMax * _PS_PER_NS - rise - afMax - (config->digitalFilter + 4) * clk;
+	int32_t sclMin = rise + m->setupMin * _PS_PER_NS;
+
+	/* Ideal tLOW share of the time SCL is driven */
+	int32_t ideal = (int32_t)((int64_t)(target - rise - fall) * lowMin / (lowMin + highMin));
+
+	uint32_t best = 0;
+	int32_t bestError = INT32_MAX;
+	int32_t bestBalance = INT32_MAX;
+
+	for (int32_t presc = 0; presc <= _FIELD_MAX; presc++) {
+		int32_t tpresc = (presc + 1) * clk;
+		int32_t scldel = _ceilDiv(sclMin, tpresc) - 1;
+		int32_t sdadel = _ceilDiv(sdaMin - clk, tpresc);
+
+		if (scldel < 0)
+			scldel = 0;
+		if (scldel > _FIELD_MAX || sdadel > _FIELD_MAX || sdadel * tpresc + clk > sdaMax)
+			continue;
+
+		for (int32_t l = 0; l <= _SCL_MAX; l++) {
+			int32_t low = (l + 1) * tpresc + sync;
+			if (low < lowMin || low - afMin - dnf <= 4 * clk)
+				continue;
+
+			int32_t need = target - low - rise - fall;
+			if (need < highMin)
+				need = highMin;
+			int32_t h = _ceilDiv(need - sync, tpresc) - 1;
+			if (h < 0)
+				h = 0;
+			if (h > _SCL_MAX)
+				continue;
+
+			int32_t high = (h + 1) * tpresc + sync;
+			int32_t period = low + high + rise + fall;
+			if (high <= clk || period > slowest)
+				continue;
+
+			int32_t error = period - target;
+			int32_t balance = _abs(low - ideal);
+			if (error < bestError || (error == bestError && balance < bestBalance)) {
+				bestError = error;
+				bestBalance = balance;
+				best = ((uint32_t)presc << I2C_TIMINGR_PRESC_Pos) | ((uint32_t)scldel << I2C_TIMINGR_SCLDEL_Pos) |
+						((uint32_t)sdadel << I2C_TIMINGR_SDADEL_Pos) | ((uint32_t)h << I2C_TIMINGR_SCLH_Pos) |
+						((uint32_t)l << I2C_TIMINGR_SCLL_Pos);
+			}
+		}
+	}
+	return best;
+}
+
+/*!
+ * @brief SCL rate a TIMINGR value gives
+ * @param clock I2C kernel clock, Hz
+ * @param timing TIMINGR value
+ * @param *config Rise/fall times and filters; the rate is not used
+ * @return SCL rate, Hz
+ */
+uint32_t I2CTiming_Rate(uint32_t clock, uint32_t timing, const I2CTiming_ConfigTypeDef *config) {
+	if (!clock)
+		return 0;
+	int64_t clk = (int64_t)(_PS_PER_S / clock);
+	int64_t tpresc = (((timing & I2C_TIMINGR_PRESC) >> I2C_TIMINGR_PRESC_Pos) + 1) * clk;
+	int64_t l = ((timing & I2C_TIMINGR_SCLL) >> I2C_TIMINGR_SCLL_Pos) + 1;
+	int64_t h = ((timing & I2C_TIMINGR_SCLH) >> I2C_TIMINGR_SCLH_Pos) + 1;
+	int64_t period = (l + h) * tpresc + 2 * _sync((int32_t)clk, config) +
+			(int64_t)(config->rise + config->fall) * _PS_PER_NS;
+
+	return (uint32_t)(_PS_PER_S / (uint64_t)period);
+}
+
+/*!
+ * @brief Kernel clock of an I2C instance from its RCC_DCKCFGR2 selection
+ * @param *instance I2C1-I2C4
+ * @return Clock in Hz
+ */
+uint32_t I2CTiming_Clock(const I2C_TypeDef *instance) {
+	uint32_t pos = RCC_DCKCFGR2_I2C1SEL_Pos;
+
+	if (instance == I2C2)
+		pos = RCC_DCKCFGR2_I2C2SEL_Pos;
+	else if (instance == I2C3)
+		pos = RCC_DCKCFGR2_I2C3SEL_Pos;
+	else if (instance == I2C4)
+		pos = RCC_DCKCFGR2_I2C4SEL_Pos;
+
+	switch ((RCC->DCKCFGR2 >> pos) & 0x3U) {
+	case 1: return HAL_RCC_GetSysClockFreq();
+	case 2: return HSI_VALUE;
+	default: return HAL_RCC_GetPCLK1Freq();
+	}
+}
+
+/*!
+ * @brief Reprograms an initialized instance for new bus settings
+ * @param *hi2c Pointer to the I2C handle, idle
+ * @param *config Rate, rise/fall times and filters
+ * @return HAL_OK, HAL_BUSY if a transfer is under way, HAL_ERROR if no
+ * setting meets the specification (the old one stays)
+ */
+HAL_StatusTypeDef I2CTiming_Apply(I2C_HandleTypeDef *hi2c, const I2CTiming_ConfigTypeDef *config) {
+	uint32_t timing = I2CTiming_Compute(I2CTiming_Clock(hi2c->Instance), config);
+
+	if (!timing)
+		return HAL_ERROR;
+	if (hi2c->State != HAL_I2C_STATE_READY || (hi2c->Instance->ISR & I2C_ISR_BUSY))
+		return HAL_BUSY;
+
+	if (config->speed > modes[1].rate)
+		HAL_I2CEx_EnableFastModePlus(_fastModePlus(hi2c->Instance));
+	else
+		HAL_I2CEx_DisableFastModePlus(_fastModePlus(hi2c->Instance));
+
+	/* TIMINGR only takes a write while PE is clear */
+	__HAL_I2C_DISABLE(hi2c);
+	hi2c->Init.Timing = timing;
+	hi2c->Instance->TIMINGR = timing;
+	__HAL_I2C_ENABLE(hi2c);
+
+	if (HAL_I2CEx_ConfigAnalogFilter(hi2c, config->analogFilter ? I2C_ANALOGFILTER_ENABLE : I2C_ANALOGFILTER_DISABLE) != HAL_OK ||
+			HAL_I2CEx_ConfigDigitalFilter(hi2c, config->digitalFilter) != HAL_OK)
+		return HAL_ERROR;
+	return HAL_OK;
+}
+
+/*!
+ * @brief Reprograms an instance for a new rate with the board defaults
+ * @param *hi2c Pointer to the I2C handle, idle
+ * @param speed SCL rate, Hz, I2C_TIMING_SPEED_MIN-I2C_TIMING_SPEED_MAX
+ * @return See I2CTiming_Apply
+ */
+HAL_StatusTypeDef I2CTiming_SetSpeed(I2C_HandleTypeDef *hi2c, uint32_t speed) {
+	I2CTiming_ConfigTypeDef config;
+
+	I2CTiming_Default(&config, speed);
+	return I2CTiming_Apply(hi2c, &config);
+}
+
+/*! End of file i2c_timing.c **/
@@ -0,0 +1,104 @@
+/*!
+ * @file i2c_trace.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Fixed-size lock-free ring of I2C transfer records. See i2c_trace.h for the
+ * memory layout and dump format.
+ */
+
+#include "i2c_trace.h"
+#include "cycles.h"
+#include <stdio.h>
+
+#if (I2C_TRACE_DEPTH & (I2C_TRACE_DEPTH - 1U)) != 0
+#error "I2C_TRACE_DEPTH must be a power of two"
+#endif
+
+const static uint32_t _DUMP_TIMEOUT = 100; // per-line UART timeout in ms
+
+I2CTrace_TypeDef i2cTrace;
+
+/*!
+ * @brief Clears the ring and starts the cycle counter used for stamps
+ */
+void I2CTrace_Init(void) {
+	Cycles_Init();
+	i2cTrace.head = 0;
+	i2cTrace.magic = I2C_TRACE_MAGIC;
+}
+
+/*!
+ * @brief Appends one transfer to the ring
+ * @param addr 8-bit slave address
+ * @param read Nonzero for a receive, zero for a transmit
+ * @param len Requested transfer length
+ * @param status HAL status returned by the transfer
+ * @param error hi2c.ErrorCode after the transfer
+ * @param start Cycle stamp taken before the transfer was issued
+ *
+ * The end stamp is taken here, so call this immediately after the HAL call
+ * returns. A slot is claimed atomically before it is filled, so concurrent
+ * writers (thread and ISR) never share an entry.
+ */
+void I2CTrace_Record(uint8_t addr, uint8_t read, uint16_t len, HAL_StatusTypeDef status, uint32_t error, uint32_t start) {
+	uint32_t end = Cycles_Now();
+	uint32_t slot;
+
+	do {
+		slot = __LDREXW(&i2cTrace.head);
+	} while (__STREXW(slot + 1U, &i2cTrace.head) != 0U);
+
+	I2CTrace_EntryTypeDef *e = &i2cTrace.entry[slot & (I2C_TRACE_DEPTH - 1U)];
+	e->start = start;
+	e->end = end;
+	e->error = error;
+	e->len = len;
+	e->addr = addr;
+	e->flags = (read ? I2C_TRACE_READ : 0U) | ((uint8_t)status & I2C_TRACE_STATUS_MASK);
+}
+
+/*!
+ * @brief Provides the total number of transfers recorded since init
+ * @return Record count, including entries already overwritten
+ */
+uint32_t I2CTrace_Count(void) {
+	return i2cTrace.head;
+}
+
+/*!
+ * @brief Writes the ring contents as CSV, oldest entry first
+ * @param *huart Pointer to the UART handle to dump to
+ *
+ * Columns: seq,addr,dir,len,status,error,start,end,cycles. Addresses are the
+ * 7-bit form. Transmit failures are ignored so this is usable from
+ * Error_Handler().
+ */
+void I2CTrace_Dump(UART_HandleTypeDef *huart) {
+	char line[80];
+	uint32_t head = i2cTrace.head;
+	uint32_t first = (head > I2C_TRACE_DEPTH) ? head - I2C_TRACE_DEPTH : 0U;
+
+	int n = snprintf(line, sizeof(line), "#I2CT,%lu,%lu\r\nseq,addr,dir,len,status,error,start,end,cycles\r\n",
+			(unsigned long)head, (unsigned long)(head - first));
+	HAL_UART_Transmit(huart, (uint8_t *)line, (uint16_t)n, _DUMP_TIMEOUT);
+
+	for (uint32_t seq = first; seq != head; seq++) {
+		const I2CTrace_EntryTypeDef *e = &i2cTrace.entry[seq & (I2C_TRACE_DEPTH - 1U)];
+		n = snprintf(line, sizeof(line), "%lu,0x%02X,%c,%u,%u,0x%lX,%lu,%lu,%lu\r\n",
+				(unsigned long)seq,
+				e->addr >> 1,
+				(e->flags & I2C_TRACE_READ) ? 'R' : 'W',
+				e->len,
+				e->flags & I2C_TRACE_STATUS_MASK,
+				(unsigned long)e->error,
+				(unsigned long)e->start,
+				(unsigned long)e->end,
+				(unsigned long)(e->end - e->start));
+		HAL_UART_Transmit(huart, (uint8_t *)line, (uint16_t)n, _DUMP_TIMEOUT);
+	}
+}
+
+/*! End of file i2c_trace.c **/
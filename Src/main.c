@@ -21,13 +21,25 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "i2c.h"
+#include "tim.h"
 #include "usart.h"
 #include "gpio.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include <stdio.h>
-#include "si7021.h"
+#include "acquire.h"
+#include "scan.h"
+#include "app.h"
+#include "bench.h"
+#include "bkp_state.h"
+#include "console.h"
+#include "dump.h"
+#include "event_queue.h"
+#include "flash_log.h"
+#include "i2c_reg.h"
+#include "i2c_timing.h"
+#include "i2c_trace.h"
+#include "cycles.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -38,6 +50,10 @@
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
 #define DEBOUNCE_MS			(50U)
+#define TICK_PERIOD_MS		(500U)	/* Until the first sample picks the period */
+#define TICK_QUEUE_DEPTH	(4U)
+#define BUTTON_QUEUE_DEPTH	(8U)
+#define UART_QUEUE_DEPTH	(64U)
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -48,20 +64,28 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-static volatile _Bool tick_500ms = 0;
-static volatile _Bool buttonPressed = 0;
-static volatile uint32_t buttonStartTime = 0;
-static volatile uint32_t buttonStopTime = 0;
-
-Si7021_TypeDef sensor;
-uint8_t obufH[32];
-uint8_t obufT[32];
-uint8_t obufS[32];
+/* One queue per interrupt source: SysTick, EXTI and UART4 RX each own a producer side */
+static Event_TypeDef tickEvents[TICK_QUEUE_DEPTH];
+static Event_TypeDef buttonEvents[BUTTON_QUEUE_DEPTH];
+static Event_TypeDef uartEvents[UART_QUEUE_DEPTH];
+static EventQueue_TypeDef tickQueue;
+static EventQueue_TypeDef buttonQueue;
+static EventQueue_TypeDef uartQueue;
+static uint8_t rxByte;
+/* Set when the RX interrupt could not rearm reception, e.g. with the UART locked by a TX start */
+static volatile _Bool rxRearm = 0;
+static uint32_t buttonStartTime = 0;
+/* Written by the main loop after each sample, read by SysTick */
+static volatile uint32_t samplePeriod = TICK_PERIOD_MS;
+static uint32_t lastTickTime = 0;
+/* I2C1 carries the primary sensor; sensors on the others go through acquire */
+static I2C_HandleTypeDef *const buses[] = {&hi2c1, &hi2c2, &hi2c3, &hi2c4};
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
+static void ButtonEvent(const Event_TypeDef *e);
 
 /* USER CODE END PFP */
 
@@ -78,8 +102,11 @@ void SysTick_Handler(void)
 	HAL_IncTick();
 
 
-	if (HAL_GetTick() % 500 == 0) {
-		tick_500ms = 1;
+	/* A shorter period applies at once, counted from the last tick */
+	uint32_t now = HAL_GetTick();
+	if (now - lastTickTime >= samplePeriod) {
+		lastTickTime = now;
+		EventQueue_Push(&tickQueue, EVENT_TICK, 0, 0, now);
 	}
 
 	/* USER CODE BEGIN SysTick_IRQn 1 */
@@ -95,7 +122,11 @@ void SysTick_Handler(void)
 int main(void)
 {
 	/* USER CODE BEGIN 1 */
+	Event_TypeDef event;
 
+	EventQueue_Init(&tickQueue, tickEvents, TICK_QUEUE_DEPTH);
+	EventQueue_Init(&buttonQueue, buttonEvents, BUTTON_QUEUE_DEPTH);
+	EventQueue_Init(&uartQueue, uartEvents, UART_QUEUE_DEPTH);
 	/* USER CODE END 1 */
 
 
@@ -112,16 +143,57 @@ int main(void)
 	SystemClock_Config();
 
 	/* USER CODE BEGIN SysInit */
+	I2CTrace_Init();
 
 	/* USER CODE END SysInit */
 
 	/* Initialize all configured peripherals */
 	MX_GPIO_Init();
 	MX_I2C1_Init();
+	MX_I2C2_Init();
+	MX_I2C3_Init();
+	MX_I2C4_Init();
 	MX_UART4_Init();
+	MX_TIM3_Init();
+	MX_TIM7_Init();
 	/* USER CODE BEGIN 2 */
-	Si7021_Init(&sensor, &hi2c1, SI7021_DEFAULT_ADDRESS);
-	if (Si7021_Begin(&sensor) != 1) {
+	/* Settings, counters and the last samples from before a reset */
+	BkpState_Init();
+	/* TIMINGR from the kernel clock, in place of the CubeMX constant; a bus
+	 * held busy by a stuck device keeps the CubeMX 100 kHz setting */
+	Acquire_Init(&acquire);
+	Scan_Init(&scan, &acquire);
+	for (uint32_t b = 0; b < sizeof(buses) / sizeof(buses[0]); b++) {
+		I2CTiming_SetSpeed(buses[b], I2C_TIMING_SPEED);
+		I2CReg_Init(buses[b]);
+		/* The sensors on I2C2-I2C4 are found by the background scan */
+		if (b) {
+			Scan_AddBus(&scan, buses[b]);
+		}
+	}
+	App_Init(&hi2c1);
+	BkpState_Restore();
+	if (App_Config()->heater) {
+		GPIOB->BSRR = GPIO_PIN_7;
+	}
+
+	/* A failed mount only leaves logging off; sampling carries on */
+	FlashLog_Init(App_Time());
+#if BENCH_AT_BOOT
+	/* The acquire.* items need the sensors the first pass finds */
+	while (!Scan_Poll(&scan)) {
+		Acquire_Poll(&acquire);
+	}
+	Bench_Run(&sensor, &huart4);
+#endif
+
+	Console_Init(&huart4);
+	Dump_Init(&history);
+	HAL_UART_Receive_IT(&huart4, &rxByte, 1);
+
+	/* Actuator PWM starts at 0 % duty; the control loop runs off TIM7 */
+	if (HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_1) != HAL_OK ||
+			HAL_TIM_Base_Start_IT(&htim7) != HAL_OK) {
 		Error_Handler();
 	}
 
@@ -132,29 +204,39 @@ int main(void)
 	/* USER CODE BEGIN WHILE */
 	while (1)
 	{
-		if(tick_500ms) {
-			HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_0);
-
-			float hum = Si7021_ReadHumidity(&sensor);
-			float temp = Si7021_ReadPrevTemperature(&sensor);
-			uint8_t heat = Si7021_HeaterStatus(&sensor);
+		while (EventQueue_Pop(&buttonQueue, &event)) {
+			ButtonEvent(&event);
+		}
 
-			sprintf((char *)obufH, "Humidity: %.1f%%\r\n", hum);
-			if (HAL_UART_Transmit(&huart4, obufH, (uint16_t)sizeof(obufH), HAL_MAX_DELAY) != HAL_OK) {
-				Error_Handler();
-			}
+		while (EventQueue_Pop(&uartQueue, &event)) {
+			Console_Input((uint8_t)event.arg);
+		}
 
-			sprintf((char *)obufT, "PrevTemperature: %.1f C\r\n", temp);
-			if (HAL_UART_Transmit(&huart4, obufT, (uint16_t)sizeof(obufT), HAL_MAX_DELAY) != HAL_OK) {
-				Error_Handler();
-			}
+		if (EventQueue_Pop(&tickQueue, &event)) {
+			HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_0);
 
-			sprintf((char *)obufS, "Heater: %d\r\n\n", heat);
-			if (HAL_UART_Transmit(&huart4, obufS, (uint16_t)sizeof(obufS), HAL_MAX_DELAY) != HAL_OK) {
-				Error_Handler();
-			}
+			/* The report goes on the console ring; skip it while a dump streams or the ring is short */
+			App_SetReport(!Dump_Active() && Console_Free() >= APP_REPORT_MAX);
+			/* The other buses convert while the primary read blocks */
+			Acquire_Start(&acquire, ACQUIRE_ALL);
+			App_Sample();
+			samplePeriod = App_Cadence()->period;
+			FlashLog_Append(App_LastSample());
+			BkpState_Sample(App_LastSample());
+			BkpState_Config(App_Config());
+		}
 
-			tick_500ms = 0;
+		Acquire_Poll(&acquire);
+		Acquire_Store(&acquire, App_Time());
+		Scan_Poll(&scan);
+		BkpState_Commit();
+		FlashLog_Poll();
+		Dump_Poll();
+		Console_Poll();
+		if (rxRearm && huart4.RxState == HAL_UART_STATE_READY) {
+			rxRearm = 0;
+			if (HAL_UART_Receive_IT(&huart4, &rxByte, 1) != HAL_OK)
+				rxRearm = 1;
 		}
 
 
@@ -213,9 +295,14 @@ void SystemClock_Config(void)
 	{
 		Error_Handler();
 	}
-	PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_UART4|RCC_PERIPHCLK_I2C1;
+	PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_UART4|RCC_PERIPHCLK_I2C1
+			|RCC_PERIPHCLK_I2C2|RCC_PERIPHCLK_I2C3
+			|RCC_PERIPHCLK_I2C4;
 	PeriphClkInitStruct.Uart4ClockSelection = RCC_UART4CLKSOURCE_PCLK1;
 	PeriphClkInitStruct.I2c1ClockSelection = RCC_I2C1CLKSOURCE_PCLK1;
+	PeriphClkInitStruct.I2c2ClockSelection = RCC_I2C2CLKSOURCE_PCLK1;
+	PeriphClkInitStruct.I2c3ClockSelection = RCC_I2C3CLKSOURCE_PCLK1;
+	PeriphClkInitStruct.I2c4ClockSelection = RCC_I2C4CLKSOURCE_PCLK1;
 	if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct) != HAL_OK)
 	{
 		Error_Handler();
@@ -226,25 +313,69 @@ void SystemClock_Config(void)
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
 	if (GPIO_Pin == GPIO_PIN_13) {
-		if (HAL_GPIO_ReadPin(GPIOC, GPIO_Pin) == GPIO_PIN_SET) {
-			buttonStartTime = HAL_GetTick();
+		uint16_t pressed = (HAL_GPIO_ReadPin(GPIOC, GPIO_Pin) == GPIO_PIN_SET);
+		EventQueue_Push(&buttonQueue, EVENT_BUTTON, 0, pressed, HAL_GetTick());
+	}
+}
+
+/**
+ * @brief  Queues a received console byte and rearms reception, or leaves
+ *         that to the main loop if the UART is locked.
+ * @param  huart: UART handle
+ * @retval None
+ */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+	if (huart->Instance == UART4) {
+		EventQueue_Push(&uartQueue, EVENT_UART_RX, 0, rxByte, HAL_GetTick());
+		if (HAL_UART_Receive_IT(huart, &rxByte, 1) != HAL_OK)
+			rxRearm = 1;
+	}
+}
+
+/**
+ * @brief  Runs one control loop step per TIM7 update and sets the PWM duty.
+ * @param  htim: TIM handle
+ * @retval None
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+	if (htim->Instance == TIM7) {
+		uint32_t duty = App_Control(Cycles_Now());
+		__HAL_TIM_SET_COMPARE(&htim3, TIM_CHANNEL_1, duty * (htim3.Init.Period + 1U) / CONTROL_DUTY_MAX);
+	}
+}
+
+/**
+ * @brief  Rearms console reception after an overrun or framing error.
+ * @param  huart: UART handle
+ * @retval None
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	if (huart->Instance == UART4 && huart->RxState == HAL_UART_STATE_READY &&
+			HAL_UART_Receive_IT(huart, &rxByte, 1) != HAL_OK) {
+		rxRearm = 1;
+	}
+}
+
+/**
+ * @brief  Debounces user button edges and toggles the heater on release.
+ *         Runs in thread context so the I2C traffic stays out of the ISR.
+ * @param  e: button event popped from buttonQueue
+ * @retval None
+ */
+static void ButtonEvent(const Event_TypeDef *e)
+{
+	if (e->arg) {
+		buttonStartTime = e->timestamp;
+	}
+	else if (e->timestamp - buttonStartTime >= DEBOUNCE_MS) {
+		if (App_ToggleHeater()) {
+			GPIOB->BSRR = GPIO_PIN_7;
 		}
 		else {
-			buttonStopTime = HAL_GetTick();
-			if (buttonStopTime - buttonStartTime >= DEBOUNCE_MS) {
-				if (sensor.heater) {
-					if (Si7021_HeaterOff(&sensor) != 1) {
-						Error_Handler();
-					}
-					GPIOB->BSRR = GPIO_PIN_7 << 16;
-				}
-				else {
-					if (Si7021_HeaterOn(&sensor, 8) != 1) {
-						Error_Handler();
-					}
-					GPIOB->BSRR = GPIO_PIN_7;
-				}
-			}
+			GPIOB->BSRR = GPIO_PIN_7 << 16;
 		}
 	}
 }
@@ -257,6 +388,18 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 void Error_Handler(void)
 {
 	/* USER CODE BEGIN Error_Handler_Debug */
+	static _Bool dumping = 0;
+
+	/* Leave the I2C history on the console once; UART errors are ignored */
+	if (!dumping) {
+		dumping = 1;
+		I2CTrace_Dump(&huart4);
+	}
+
+	/* Stop the control loop and leave the actuator off */
+	HAL_NVIC_DisableIRQ(TIM7_IRQn);
+	TIM3->CCR1 = 0;
+
 	/* Turn on red Nucleo LED, turn off blue and green */
 	while(1) {
 		GPIOB->BSRR = (GPIO_PIN_14) | (GPIO_PIN_0|GPIO_PIN_7) << 16;
@@ -0,0 +1,91 @@
+/*!
+ * @file mux.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * TCA9548A I2C multiplexer with a cached control register. See mux.h.
+ */
+
+#include "mux.h"
+#include "i2c_reg.h"
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Initializes the handle; the control register is unknown until the first select
+ * @param *mux Pointer to the handle
+ * @param *hi2c Pointer to the bus, after I2CReg_Init
+ * @param address 7-bit address in [7:1], MUX_DEFAULT_ADDRESS << 1 with A2-A0 low
+ */
+void Mux_Init(Mux_TypeDef *mux, I2C_HandleTypeDef *hi2c, uint8_t address) {
+	mux->hi2c = hi2c;
+	mux->address = address;
+	mux->control = 0;
+	mux->known = 0;
+	mux->writes = mux->skipped = 0;
+}
+
+/*!
+ * @brief Control register value connecting a channel
+ * @param channel 0-7, or MUX_OFF
+ * @return Control value
+ */
+uint8_t Mux_Control(uint8_t channel) {
+	return channel < MUX_CHANNELS ? (uint8_t)(1U << channel) : 0;
+}
+
+/*!
+ * @brief Tells whether a channel is known to be the one connected
+ * @param *mux Pointer to the handle
+ * @param channel 0-7, or MUX_OFF
+ * @return 1 if no write is needed
+ */
+_Bool Mux_Current(const Mux_TypeDef *mux, uint8_t channel) {
+	return mux->known && mux->control == Mux_Control(channel);
+}
+
+/*!
+ * @brief Connects one channel, or none, writing only on a change
+ * @param *mux Pointer to the handle
+ * @param channel 0-7, or MUX_OFF
+ * @return HAL status of the write, HAL_OK when skipped
+ */
+HAL_StatusTypeDef Mux_Select(Mux_TypeDef *mux, uint8_t channel) {
+	uint8_t control = Mux_Control(channel);
+
+	if (Mux_Current(mux, channel)) {
+		mux->skipped++;
+		return HAL_OK;
+	}
+	HAL_StatusTypeDef status = I2CReg_Transmit(mux->hi2c, mux->address, &control, 1, MUX_TIMEOUT_MS);
+	if (status == HAL_OK)
+		Mux_Written(mux, control);
+	else
+		Mux_Invalidate(mux);
+	return status;
+}
+
+/*!
+ * @brief Records a control write made outside Mux_Select, e.g. with I2CReg_Start
+ * @param *mux Pointer to the handle
+ * @param control Value the device acknowledged
+ */
+void Mux_Written(Mux_TypeDef *mux, uint8_t control) {
+	mux->control = control;
+	mux->known = 1;
+	mux->writes++;
+}
+
+/*!
+ * @brief Forgets the cached control register, forcing a write on the next select
+ * @param *mux Pointer to the handle
+ */
+void Mux_Invalidate(Mux_TypeDef *mux) {
+	mux->known = 0;
+}
+
+/*! End of file mux.c **/
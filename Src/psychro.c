@@ -0,0 +1,145 @@
+/*!
+ * @file psychro.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Derived psychrometric metrics. See psychro.h.
+ */
+
+#include "psychro.h"
+#include <string.h>
+
+#define _MAGNUS_A		17.62f
+#define _MAGNUS_B		243.12f		/**< C **/
+#define _ES0			6.112f		/**< hPa at 0 C **/
+#define _LN2			0.693147181f
+#define _LOG2E			1.44269504f
+#define _AH_FACTOR		216.679f	/**< g K / (m3 hPa), from Mw / R **/
+#define _KELVIN			273.15f
+
+/*!
+ * Static function definitions
+ */
+
+/*!
+ * @brief log2(x) for normal x > 0, absolute error < 1.5e-5
+ */
+static float _log2(float x) {
+	uint32_t u;
+	float m;
+
+	memcpy(&u, &x, sizeof(u));
+	int32_t e = (int32_t)((u >> 23) & 0xFFU) - 127;
+	u = (u & 0x007FFFFFU) | 0x3F800000U;
+	memcpy(&m, &u, sizeof(m));
+	m -= 1.0f;
+
+	/* Least-squares fit of log2(1 + m) on [0, 1) at Chebyshev nodes */
+	float p = 0.0439295708f;
+	p = p * m - 0.189836406f;
+	p = p * m + 0.411566809f;
+	p = p * m - 0.707256362f;
+	p = p * m + 1.44159271f;
+	p = p * m + 1.43541059e-05f;
+	return (float)e + p;
+}
+
+/*!
+ * @brief 2^x for |x| < 126, relative error < 3.6e-6
+ */
+static float _exp2(float x) {
+	int32_t i = (int32_t)x;
+	if (x < (float)i)
+		i--;
+	float f = x - (float)i;
+
+	/* Least-squares fit of 2^f on [0, 1) at Chebyshev nodes */
+	float p = 0.0136839965f;
+	p = p * f + 0.0517178265f;
+	p = p * f + 0.241621163f;
+	p = p * f + 0.692969621f;
+	p = p * f + 1.00000359f;
+
+	uint32_t u;
+	memcpy(&u, &p, sizeof(u));
+	u += (uint32_t)i << 23;
+	memcpy(&p, &u, sizeof(p));
+	return p;
+}
+
+/*!
+ * @brief Converts to hundredths, saturating instead of wrapping
+ */
+static int16_t _fixed(float value) {
+	if (value * 100.0f >= (float)INT16_MAX)
+		return INT16_MAX;
+	if (value * 100.0f <= (float)-INT16_MAX)
+		return -INT16_MAX;
+	return Sample_FromFloat(value);
+}
+
+/*!
+ * @brief NWS heat index
+ * @param t Temperature in C
+ * @param rh Relative humidity in %
+ * @return Heat index in C
+ */
+static float _heatIndex(float t, float rh) {
+	float f = t * 1.8f + 32.0f;
+	float hi = 0.5f * (f + 61.0f + (f - 68.0f) * 1.2f + rh * 0.094f);
+
+	if ((hi + f) * 0.5f >= 80.0f) {
+		hi = -42.379f + 2.04901523f * f + 10.14333127f * rh
+				- 0.22475541f * f * rh - 6.83783e-3f * f * f - 5.481717e-2f * rh * rh
+				+ 1.22874e-3f * f * f * rh + 8.5282e-4f * f * rh * rh
+				- 1.99e-6f * f * f * rh * rh;
+		if (rh < 13.0f && f >= 80.0f && f <= 112.0f)
+			hi -= (13.0f - rh) * 0.25f * sqrtf((17.0f - fabsf(f - 95.0f)) * (1.0f / 17.0f));
+		else if (rh > 85.0f && f >= 80.0f && f <= 87.0f)
+			hi += (rh - 85.0f) * 0.1f * (87.0f - f) * 0.2f;
+	}
+
+	return (hi - 32.0f) * (1.0f / 1.8f);
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Derives dew point, absolute humidity and heat index
+ * @param humidity Relative humidity in 0.01 %, clamped to 0..100 %
+ * @param temperature Temperature in 0.01 C
+ * @param *out Receives the metrics
+ */
+void Psychro_Compute(int16_t humidity, int16_t temperature, Psychro_TypeDef *out) {
+	if (humidity == SAMPLE_INVALID || temperature == SAMPLE_INVALID) {
+		out->dewPoint = SAMPLE_INVALID;
+		out->absHumidity = SAMPLE_INVALID;
+		out->heatIndex = SAMPLE_INVALID;
+		return;
+	}
+
+	float rh = (humidity < 0) ? 0.0f : (humidity > 10000) ? 100.0f : humidity * 0.01f;
+	float t = temperature * 0.01f;
+
+	/* ln(es / es0), shared by the vapour pressure and the dew point */
+	float k = _MAGNUS_A * t / (_MAGNUS_B + t);
+	float e = rh * (_ES0 * 0.01f) * _exp2(k * _LOG2E);
+	float ah = _AH_FACTOR * e / (_KELVIN + t);
+
+	out->absHumidity = _fixed(ah);
+	out->heatIndex = _fixed(_heatIndex(t, rh));
+
+	if (rh > 0.0f) {
+		float gamma = _LN2 * _log2(rh * 0.01f) + k;
+		out->dewPoint = Sample_FromFloat(_MAGNUS_B * gamma / (_MAGNUS_A - gamma));
+	}
+	else {
+		out->dewPoint = SAMPLE_INVALID;
+	}
+}
+
+/*! End of file psychro.c **/
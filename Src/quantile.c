@@ -0,0 +1,125 @@
+/*!
+ * @file quantile.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Daily histogram percentiles. See quantile.h.
+ */
+
+#include "quantile.h"
+
+#define _EMPTY		0xFFFFFFFFU		/**< day of a never-used histogram **/
+
+/*!
+ * Static function definitions
+ */
+
+static void _clear(Quantile_HistogramTypeDef *h, uint32_t day) {
+	h->day = day;
+	h->count = 0;
+	for (uint32_t i = 0; i < QUANTILE_BINS; i++) {
+		h->bins[i] = 0;
+	}
+}
+
+/*!
+ * @brief Histogram of today or yesterday, NULL if that day was not seen
+ */
+static const Quantile_HistogramTypeDef *_histogram(const Quantile_TypeDef *q, Quantile_DayTypeDef which) {
+	uint32_t day = q->today - (uint32_t)which;
+	const Quantile_HistogramTypeDef *h = &q->days[day % QUANTILE_DAYS];
+	if (q->today < (uint32_t)which || h->day != day)
+		return 0;
+	return h;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets a channel's range and empties both days
+ */
+void Quantile_Init(Quantile_TypeDef *q, const Quantile_ConfigTypeDef *config) {
+	q->config = *config;
+	if (!q->config.width)
+		q->config.width = 1;
+	q->today = 0;
+	for (uint32_t d = 0; d < QUANTILE_DAYS; d++) {
+		q->days[d].day = _EMPTY;
+	}
+}
+
+/*!
+ * @brief Counts one value in its day's histogram
+ * @param *q Pointer to the estimator
+ * @param time Sample time in seconds
+ * @param value Value in 0.01 units; SAMPLE_INVALID is skipped
+ */
+void Quantile_Add(Quantile_TypeDef *q, uint32_t time, int16_t value) {
+	if (value == SAMPLE_INVALID)
+		return;
+
+	uint32_t day = time / 86400U;
+	Quantile_HistogramTypeDef *h = &q->days[day % QUANTILE_DAYS];
+	if (h->day != day) {
+		if (h->day != _EMPTY && h->day > day)
+			return;					/* older than anything kept */
+		_clear(h, day);
+	}
+	if (day > q->today)
+		q->today = day;
+
+	int32_t bin = ((int32_t)value - q->config.min) / q->config.width;
+	if (bin < 0)
+		bin = 0;
+	else if (bin >= (int32_t)QUANTILE_BINS)
+		bin = QUANTILE_BINS - 1;
+	h->bins[bin]++;
+	h->count++;
+}
+
+/*!
+ * @brief Number of values counted on a day
+ */
+uint32_t Quantile_Count(const Quantile_TypeDef *q, Quantile_DayTypeDef day) {
+	const Quantile_HistogramTypeDef *h = _histogram(q, day);
+	return h ? h->count : 0;
+}
+
+/*!
+ * @brief Estimates a percentile of one day's values
+ * @param *q Pointer to the estimator
+ * @param day QUANTILE_TODAY or QUANTILE_YESTERDAY
+ * @param permille Rank in 0.1 % steps, 0-1000 (500 is the median)
+ * @return Value in 0.01 units, SAMPLE_INVALID if the day has no values
+ */
+int16_t Quantile_Get(const Quantile_TypeDef *q, Quantile_DayTypeDef day, uint32_t permille) {
+	const Quantile_HistogramTypeDef *h = _histogram(q, day);
+	if (!h || !h->count)
+		return SAMPLE_INVALID;
+	if (permille > 1000U)
+		permille = 1000U;
+
+	/* Ranks are kept in thousandths of a sample to stay in integers */
+	uint64_t target = (uint64_t)permille * h->count;
+	uint64_t below = 0;
+	uint32_t i = 0;
+	for (; i < QUANTILE_BINS - 1U; i++) {
+		uint64_t here = (uint64_t)h->bins[i] * 1000U;
+		if (here && below + here >= target)
+			break;
+		below += here;
+	}
+
+	int32_t value = q->config.min + (int32_t)(i * q->config.width);
+	if (h->bins[i])
+		value += (int32_t)((target - below) * q->config.width / ((uint64_t)h->bins[i] * 1000U));
+	if (value > INT16_MAX)
+		value = INT16_MAX;
+	return (int16_t)value;
+}
+
+/*! End of file quantile.c **/
@@ -0,0 +1,62 @@
+/*!
+ * @file report.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Change-only reporting policy. See report.h.
+ */
+
+#include "report.h"
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets a channel's policy; the next sample is always due
+ */
+void Report_Init(Report_TypeDef *r, const Report_ConfigTypeDef *config) {
+	r->config = *config;
+	r->started = 0;
+	r->sent = 0;
+	r->suppressed = 0;
+}
+
+/*!
+ * @brief Decides whether a sample goes out, and records it if so
+ * @param *r Pointer to the channel's state
+ * @param time Sample time in seconds
+ * @param value Sample value in 0.01 units
+ * @param status SAMPLE_* bits of the sample
+ * @return True if the sample should be reported
+ */
+_Bool Report_Due(Report_TypeDef *r, uint32_t time, int16_t value, uint8_t status) {
+	_Bool due = !r->started || status != r->status ||
+			(r->config.heartbeat && time - r->time >= r->config.heartbeat);
+
+	if (!due) {
+		_Bool valid = value != SAMPLE_INVALID;
+		if (valid != (r->value != SAMPLE_INVALID)) {
+			due = 1;
+		}
+		else if (valid) {
+			int32_t moved = (int32_t)value - r->value;
+			due = (moved < 0 ? -moved : moved) > r->config.deadband;
+		}
+	}
+
+	if (!due) {
+		r->suppressed++;
+		return 0;
+	}
+	r->started = 1;
+	r->value = value;
+	r->status = status;
+	r->time = time;
+	r->sent++;
+	return 1;
+}
+
+/*! End of file report.c **/
@@ -0,0 +1,201 @@
+/*!
+ * @file rollup.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Rollup tiers for history queries. See rollup.h.
+ */
+
+#include "rollup.h"
+
+#define _EMPTY		0xFFFFFFFFU		/**< period of a never-used slot **/
+
+/*!
+ * @typedef Rollup_TierInfoTypeDef refers to the shape of one tier
+ */
+typedef struct {
+	uint32_t seconds;
+	uint32_t size;
+} Rollup_TierInfoTypeDef;
+
+static const Rollup_TierInfoTypeDef tiers[ROLLUP_TIERS] = {
+	{60U,    ROLLUP_MINUTES},
+	{3600U,  ROLLUP_HOURS},
+	{86400U, ROLLUP_DAYS},
+};
+
+/*!
+ * Static function definitions
+ */
+
+static Rollup_BucketTypeDef *_ring(Rollup_TypeDef *r, uint32_t tier) {
+	switch (tier) {
+	case ROLLUP_MINUTE: return r->minute;
+	case ROLLUP_HOUR: return r->hour;
+	default: return r->day;
+	}
+}
+
+static const Rollup_BucketTypeDef *_slot(const Rollup_TypeDef *r, uint32_t tier, uint32_t period) {
+	return &_ring((Rollup_TypeDef *)r, tier)[period % tiers[tier].size];
+}
+
+static void _clear(Rollup_StatTypeDef *s) {
+	s->sum = 0;
+	s->count = 0;
+	s->min = INT16_MAX;
+	s->max = INT16_MIN;
+}
+
+static void _add(Rollup_StatTypeDef *s, int16_t value) {
+	if (value == SAMPLE_INVALID)
+		return;
+	s->sum += value;
+	s->count++;
+	if (value < s->min)
+		s->min = value;
+	if (value > s->max)
+		s->max = value;
+}
+
+static void _merge(Rollup_StatTypeDef *s, const Rollup_StatTypeDef *from) {
+	if (!from->count)
+		return;
+	s->sum += from->sum;
+	s->count += from->count;
+	if (from->min < s->min)
+		s->min = from->min;
+	if (from->max > s->max)
+		s->max = from->max;
+}
+
+/*!
+ * @brief True if the tier still holds the given period
+ */
+static _Bool _retained(const Rollup_TypeDef *r, uint32_t tier, uint32_t period) {
+	uint32_t newest = r->last / tiers[tier].seconds;
+	return period <= newest && newest - period < tiers[tier].size;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Empties every tier
+ */
+void Rollup_Init(Rollup_TypeDef *r) {
+	r->last = 0;
+	r->started = 0;
+	for (uint32_t k = 0; k < ROLLUP_TIERS; k++) {
+		Rollup_BucketTypeDef *ring = _ring(r, k);
+		for (uint32_t i = 0; i < tiers[k].size; i++) {
+			ring[i].period = _EMPTY;
+		}
+	}
+}
+
+/*!
+ * @brief Adds a sample to the current bucket of every tier
+ * @param *r Pointer to the rollups
+ * @param *sample Pointer to the sample; invalid channels are skipped
+ */
+void Rollup_Add(Rollup_TypeDef *r, const Sample_TypeDef *sample) {
+	for (uint32_t k = 0; k < ROLLUP_TIERS; k++) {
+		uint32_t period = sample->time / tiers[k].seconds;
+		Rollup_BucketTypeDef *b = &_ring(r, k)[period % tiers[k].size];
+		if (b->period != period) {
+			b->period = period;
+			_clear(&b->humidity);
+			_clear(&b->temperature);
+		}
+		_add(&b->humidity, sample->humidity);
+		_add(&b->temperature, sample->temperature);
+	}
+
+	if (!r->started || sample->time > r->last)
+		r->last = sample->time;
+	r->started = 1;
+}
+
+/*!
+ * @brief Aggregates [from, to) from the coarsest buckets that cover it
+ * @param *r Pointer to the rollups
+ * @param from Start time, rounded down to a minute
+ * @param to End time (exclusive), rounded down to a minute
+ * @param *result Receives min/max/sum/count per channel; period is unused
+ * @param *covered Receives the span answered; from == to if none of it was
+ * @return Number of buckets merged
+ */
+uint32_t Rollup_Query(const Rollup_TypeDef *r, uint32_t from, uint32_t to, Rollup_BucketTypeDef *result,
+		Rollup_SpanTypeDef *covered) {
+	uint32_t t = from - from % 60U;
+	uint32_t end = to - to % 60U;
+	uint32_t merged = 0;
+	uint32_t skipped = 0;			/**< Unanswered seconds since the last bucket used **/
+
+	result->period = 0;
+	_clear(&result->humidity);
+	_clear(&result->temperature);
+	covered->from = covered->to = t;
+	covered->missing = 0;
+	if (!r->started)
+		return 0;
+
+	/* Nothing is kept before the oldest day bucket */
+	uint32_t newestDay = r->last / 86400U;
+	if (newestDay >= ROLLUP_DAYS) {
+		uint32_t oldest = (newestDay - ROLLUP_DAYS + 1U) * 86400U;
+		if (t < oldest)
+			t = oldest;
+	}
+
+	while (t < end && t <= r->last) {
+		uint32_t step = 0;
+		for (int32_t k = ROLLUP_TIERS - 1; k >= 0; k--) {
+			uint32_t seconds = tiers[k].seconds;
+			uint32_t period = t / seconds;
+			if (t % seconds || end - t < seconds || !_retained(r, (uint32_t)k, period))
+				continue;
+
+			const Rollup_BucketTypeDef *b = _slot(r, (uint32_t)k, period);
+			if (b->period == period) {
+				_merge(&result->humidity, &b->humidity);
+				_merge(&result->temperature, &b->temperature);
+				merged++;
+			}
+			step = seconds;
+			break;
+		}
+
+		/* No tier keeps this minute on its own; it only counts as missing between used buckets */
+		if (!step) {
+			skipped += 60U;
+			t += 60U;
+			continue;
+		}
+		if (covered->from == covered->to)
+			covered->from = t;
+		else
+			covered->missing += skipped;
+		skipped = 0;
+		t += step;
+		covered->to = t;
+	}
+
+	return merged;
+}
+
+/*!
+ * @brief Mean of a channel aggregate
+ * @return Mean in %RH or C, NAN if the aggregate is empty
+ */
+float Rollup_Mean(const Rollup_StatTypeDef *stat) {
+	if (!stat->count)
+		return NAN;
+	return (float)((double)stat->sum / stat->count) / 100.0f;
+}
+
+/*! End of file rollup.c **/
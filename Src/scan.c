@@ -0,0 +1,440 @@
+/*!
+ * @file scan.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Background bus and multiplexer scan with Si70xx identification. See scan.h.
+ */
+
+#include "scan.h"
+#include "si7021.h"
+
+Scan_TypeDef scan;
+
+/*!
+ * Static function definitions
+ */
+
+static uint8_t _busNumber(const I2C_TypeDef *i2c) {
+	if (i2c == I2C2)
+		return 2;
+	if (i2c == I2C3)
+		return 3;
+	if (i2c == I2C4)
+		return 4;
+	return 1;
+}
+
+static _Bool _isMux(uint32_t address) {
+	return address >= SCAN_MUX_FIRST && address <= SCAN_MUX_LAST;
+}
+
+/*!
+ * @brief Si70xx addresses: 0x40, and 0x41 for a Si7013 with AD0 high
+ */
+static _Bool _isSensor(uint32_t address) {
+	return address == SI7021_DEFAULT_ADDRESS || address == SI7021_DEFAULT_ADDRESS + 1U;
+}
+
+static Mux_TypeDef *_walked(Scan_TypeDef *s, const Scan_BusTypeDef *b) {
+	return b->mux == SCAN_DIRECT ? 0 : &s->mux[b->mux];
+}
+
+/*!
+ * @brief Notes the device at the bus's current position in the table
+ */
+static void _record(Scan_TypeDef *s, const Scan_BusTypeDef *b, uint8_t model) {
+	uint8_t mux = b->mux == SCAN_DIRECT ? 0 : s->mux[b->mux].address >> 1;
+	uint8_t channel = b->mux == SCAN_DIRECT ? 0 : b->channel;
+	Scan_DeviceTypeDef *d = 0;
+
+	for (uint32_t k = 0; k < s->count && !d; k++) {
+		Scan_DeviceTypeDef *e = &s->device[k];
+		if (e->bus == b->bus && e->address == b->address && e->mux == mux && e->channel == channel)
+			d = e;
+	}
+	if (!d) {
+		if (s->count >= SCAN_FOUND)
+			return;
+		d = &s->device[s->count++];
+		d->bus = b->bus;
+		d->address = b->address;
+		d->mux = mux;
+		d->channel = channel;
+	}
+	d->model = model;
+	d->seen = s->pass;
+}
+
+/*!
+ * @brief Takes a mux that acknowledged the write of 0 into the pool, all channels off
+ */
+static void _muxFound(Scan_TypeDef *s, Scan_BusTypeDef *b) {
+	uint8_t address = (uint8_t)(b->address << 1);
+	uint32_t m = 0;
+
+	while (m < s->muxes && (s->mux[m].hi2c != b->hi2c || s->mux[m].address != address))
+		m++;
+	if (m == s->muxes) {
+		if (m >= SCAN_MUXES)
+			return;
+		Mux_Init(&s->mux[s->muxes++], b->hi2c, address);
+	}
+	Mux_Written(&s->mux[m], 0);
+	b->muxes |= 1U << m;
+}
+
+static void _muxLost(Scan_TypeDef *s, const Scan_BusTypeDef *b) {
+	uint8_t address = (uint8_t)(b->address << 1);
+
+	for (uint32_t m = 0; m < s->muxes; m++) {
+		if (s->mux[m].hi2c == b->hi2c && s->mux[m].address == address)
+			Mux_Invalidate(&s->mux[m]);
+	}
+}
+
+/*!
+ * @brief Moves the mux walk on to the next channel, or the next mux
+ * @return 0 when the walk is over
+ */
+static _Bool _nextChannel(Scan_TypeDef *s, Scan_BusTypeDef *b) {
+	uint32_t m = b->mux;
+
+	if (m != SCAN_DIRECT && (b->muxes & (1U << m)) && ++b->channel < MUX_CHANNELS)
+		return 1;
+	for (m = (m == SCAN_DIRECT) ? 0 : m + 1; m < s->muxes; m++) {
+		if (b->muxes & (1U << m)) {
+			b->mux = (uint8_t)m;
+			b->channel = 0;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*!
+ * @brief Moves on to the next address worth probing
+ *
+ * Behind a mux, the addresses that answered directly are skipped: they
+ * would answer on every channel.
+ */
+static void _next(Scan_TypeDef *s, Scan_BusTypeDef *b) {
+	b->state = SCAN_PROBE;
+	for (;;) {
+		if (++b->address > SCAN_LAST) {
+			if (!_nextChannel(s, b)) {
+				b->state = SCAN_DONE;
+				return;
+			}
+			b->address = SCAN_FIRST;
+		}
+		if (_isMux(b->address))
+			continue;
+		if (b->mux != SCAN_DIRECT && (b->direct[b->address >> 5] & (1U << (b->address & 31U))))
+			continue;
+		return;
+	}
+}
+
+/*!
+ * @brief Finds the mux write needed before the bus's next transfer
+ * @param *channel Set to the channel to select, MUX_OFF for another mux
+ * @return The mux to write, 0 if the transfer can go out as is
+ */
+static Mux_TypeDef *_switch(Scan_TypeDef *s, const Scan_BusTypeDef *b, uint8_t *channel) {
+	Mux_TypeDef *own = _walked(s, b);
+
+	for (uint32_t m = 0; m < s->muxes; m++) {
+		Mux_TypeDef *mux = &s->mux[m];
+		if (mux != own && (b->muxes & (1U << m)) && !Mux_Current(mux, MUX_OFF)) {
+			*channel = MUX_OFF;
+			return mux;
+		}
+	}
+	if (own && !Mux_Current(own, b->channel)) {
+		*channel = b->channel;
+		return own;
+	}
+	return 0;
+}
+
+/*!
+ * @brief Starts the bus's next transfer, unless the bus is taken
+ */
+static void _issue(Scan_TypeDef *s, Scan_BusTypeDef *b, uint32_t tag, uint32_t now) {
+	uint16_t address = (uint16_t)(b->address << 1);
+	uint16_t len = 0;
+	_Bool rx = 0;
+	uint8_t channel;
+	Mux_TypeDef *mux = 0;
+
+	switch (b->state) {
+	case SCAN_MUX:
+		b->data[0] = 0;
+		len = 1;
+		break;
+	case SCAN_PROBE:
+		break;
+	case SCAN_ID_COMMAND:
+		b->data[0] = SI7021_ID2_CMD >> 8;
+		b->data[1] = SI7021_ID2_CMD & 0xFF;
+		len = 2;
+		break;
+	case SCAN_ID_READ:
+		len = 1;
+		rx = 1;
+		break;
+	default:
+		return;
+	}
+
+	if (b->state != SCAN_MUX)
+		mux = _switch(s, b, &channel);
+	if (mux) {
+		b->data[0] = Mux_Control(channel);
+		address = mux->address;
+		len = 1;
+		rx = 0;
+	}
+	if (I2CReg_Start(b->hi2c, address, b->data, len, rx, tag) != HAL_OK)
+		return;
+	b->switching = mux;
+	b->wire = 1;
+	b->started = now;
+	s->probes++;
+}
+
+/*!
+ * @brief Hands an identified sensor to the acquisition, unless it has it already
+ */
+static void _register(Scan_TypeDef *s, Scan_BusTypeDef *b) {
+	Acquire_TypeDef *a = s->acquire;
+	Mux_TypeDef *mux = _walked(s, b);
+	uint8_t address = (uint8_t)(b->address << 1);
+
+	for (uint32_t k = 0; k < a->count; k++) {
+		const Acquire_DeviceTypeDef *d = &a->device[k];
+		if (d->hi2c == b->hi2c && d->mux == mux && d->address == address && (!mux || d->channel == b->channel)) {
+			_next(s, b);
+			return;
+		}
+	}
+	if (mux ? Acquire_AddMuxed(a, mux, b->channel, address) : Acquire_Add(a, b->hi2c, address))
+		s->added++;
+	_next(s, b);
+}
+
+/*!
+ * @brief Moves a bus on after the outcome of its step's transfer
+ */
+static void _result(Scan_TypeDef *s, Scan_BusTypeDef *b, uint32_t error) {
+	Si_SensorTypeDef model;
+
+	switch (b->state) {
+	case SCAN_MUX:
+		if (error) {
+			_muxLost(s, b);
+		}
+		else {
+			_muxFound(s, b);
+			_record(s, b, SCAN_MODEL_MUX);
+		}
+		if (++b->address > SCAN_MUX_LAST) {
+			b->address = SCAN_FIRST - 1U;
+			_next(s, b);
+		}
+		break;
+	case SCAN_PROBE:
+		if (error) {
+			_next(s, b);
+			break;
+		}
+		if (b->mux == SCAN_DIRECT)
+			b->direct[b->address >> 5] |= 1U << (b->address & 31U);
+		if (_isSensor(b->address)) {
+			b->state = SCAN_ID_COMMAND;
+			break;
+		}
+		_record(s, b, SCAN_MODEL_OTHER);
+		_next(s, b);
+		break;
+	case SCAN_ID_COMMAND:
+		if (!error) {
+			b->state = SCAN_ID_READ;
+			break;
+		}
+		_record(s, b, SCAN_MODEL_OTHER);
+		_next(s, b);
+		break;
+	case SCAN_ID_READ:
+		model = error ? SI_UNKNOWN : Si7021_ModelFromId(b->data[0]);
+		_record(s, b, model == SI_UNKNOWN ? SCAN_MODEL_OTHER : (uint8_t)model);
+		if (model == SI_UNKNOWN)
+			_next(s, b);
+		else
+			b->state = SCAN_ADD;
+		break;
+	default:
+		break;
+	}
+}
+
+/*!
+ * @brief Ends a bus's transfer: a mux write updates the cache, a step moves on
+ */
+static void _finish(Scan_TypeDef *s, Scan_BusTypeDef *b, uint32_t error) {
+	Mux_TypeDef *mux = b->switching;
+
+	b->wire = 0;
+	b->switching = 0;
+	if (!mux) {
+		_result(s, b, error);
+		return;
+	}
+	if (!error) {
+		Mux_Written(mux, b->data[0]);
+		return;
+	}
+	/* The mux went away mid-pass; a walk of it ends with the next probe */
+	Mux_Invalidate(mux);
+	b->muxes &= ~(1U << (uint32_t)(mux - s->mux));
+	if (mux == _walked(s, b)) {
+		b->address = SCAN_LAST;
+		_next(s, b);
+	}
+}
+
+/*!
+ * @brief Takes the scan's completions off the acquisition's queues
+ */
+static void _completed(void *context, I2C_HandleTypeDef *hi2c, const I2CReg_CompletionTypeDef *completion) {
+	Scan_TypeDef *s = context;
+	uint32_t b = completion->tag & ~ACQUIRE_TAG_FOREIGN;
+
+	(void)hi2c;
+	if (b < s->buses && s->bus[b].wire)
+		_finish(s, &s->bus[b], completion->error);
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Clears the scanner and hooks it to the acquisition's completion queues
+ * @param *s Pointer to the scanner
+ * @param *acquire Acquisition found sensors are added to, after Acquire_Init
+ *
+ * The first pass starts with the first Scan_Poll().
+ */
+void Scan_Init(Scan_TypeDef *s, Acquire_TypeDef *acquire) {
+	s->acquire = acquire;
+	s->buses = 0;
+	s->muxes = 0;
+	s->count = 0;
+	s->running = 0;
+	s->pass = 0;
+	s->next = HAL_GetTick();
+	s->duration = 0;
+	s->probes = 0;
+	s->added = 0;
+	Acquire_SetListener(acquire, _completed, s);
+}
+
+/*!
+ * @brief Adds a bus to scan
+ * @param *s Pointer to the scanner
+ * @param *hi2c Pointer to the bus, after I2CReg_Init; not the primary sensor's
+ * @return 1 if added, 0 if the list of buses is full
+ */
+_Bool Scan_AddBus(Scan_TypeDef *s, I2C_HandleTypeDef *hi2c) {
+	if (s->buses >= I2C_REG_BUSES || !Acquire_AddBus(s->acquire, hi2c))
+		return 0;
+	Scan_BusTypeDef *b = &s->bus[s->buses++];
+	b->hi2c = hi2c;
+	b->bus = _busNumber(hi2c->Instance);
+	b->state = SCAN_IDLE;
+	b->wire = 0;
+	b->switching = 0;
+	return 1;
+}
+
+/*!
+ * @brief Starts a pass now, unless one is running
+ * @param *s Pointer to the scanner
+ */
+void Scan_Start(Scan_TypeDef *s) {
+	if (s->running)
+		return;
+	s->running = 1;
+	s->pass++;
+	s->start = HAL_GetTick();
+	for (uint32_t k = 0; k < s->buses; k++) {
+		Scan_BusTypeDef *b = &s->bus[k];
+		b->state = SCAN_MUX;
+		b->address = SCAN_MUX_FIRST;
+		b->mux = SCAN_DIRECT;
+		b->channel = 0;
+		b->muxes = 0;
+		for (uint32_t w = 0; w < 4; w++)
+			b->direct[w] = 0;
+	}
+}
+
+/*!
+ * @brief Starts a pass when due and moves the running one on; call from the main loop
+ * @param *s Pointer to the scanner
+ * @return 1 when no pass is running
+ *
+ * Completions arrive through Acquire_Poll(), which has to be called too.
+ */
+_Bool Scan_Poll(Scan_TypeDef *s) {
+	uint32_t now = HAL_GetTick();
+	_Bool done = 1;
+
+	if (!s->running) {
+		if ((int32_t)(now - s->next) < 0)
+			return 1;
+		Scan_Start(s);
+	}
+
+	for (uint32_t k = 0; k < s->buses; k++) {
+		Scan_BusTypeDef *b = &s->bus[k];
+
+		if (b->wire) {
+			if (now - b->started > SCAN_TIMEOUT_MS) {
+				I2CReg_Abort(b->hi2c);
+				_finish(s, b, HAL_I2C_ERROR_TIMEOUT);
+			}
+		}
+		else if (!s->acquire->active) {
+			if (b->state == SCAN_ADD)
+				_register(s, b);
+			_issue(s, b, ACQUIRE_TAG_FOREIGN | k, now);
+		}
+		if (b->state != SCAN_DONE)
+			done = 0;
+	}
+
+	if (done) {
+		s->running = 0;
+		s->duration = now - s->start;
+		s->next = now + SCAN_PERIOD_MS;
+	}
+	return done;
+}
+
+/*!
+ * @brief Tells whether a device answered in the last complete pass, or already in this one
+ * @param *s Pointer to the scanner
+ * @param *device Entry of s->device
+ * @return 1 if present
+ */
+_Bool Scan_Present(const Scan_TypeDef *s, const Scan_DeviceTypeDef *device) {
+	uint32_t complete = s->running ? s->pass - 1U : s->pass;
+	return device->seen >= complete && complete > 0;
+}
+
+/*! End of file scan.c **/
@@ -13,6 +13,11 @@
  */
 
 #include "si7021.h"
+#include "i2c_trace.h"
+#include "cycles.h"
+#if SI7021_REGISTER_I2C
+#include "i2c_reg.h"
+#endif
 #include <math.h>
 
 const static uint32_t _TRANSACTION_TIMEOUT = 100; // Wire NAK/Busy timeout in ms
@@ -20,64 +25,161 @@ const static uint32_t _TRANSACTION_TIMEOUT = 100; // Wire NAK/Busy timeout in ms
 /*!
  * Static function prototypes
  */
-static uint8_t _readRegister8(Si7021_TypeDef *si7021, uint8_t reg);
-static void _writeRegister8(Si7021_TypeDef *si7021, uint8_t reg, uint8_t value);
-static void _readRevision(Si7021_TypeDef *si7021);
-void _readSerialNumber(Si7021_TypeDef *si7021);
+static HAL_StatusTypeDef _transmit(Si7021_TypeDef *si7021, uint8_t *data, uint16_t len);
+static HAL_StatusTypeDef _receive(Si7021_TypeDef *si7021, uint8_t *data, uint16_t len);
+static _Bool _available(Si7021_TypeDef *si7021);
+static void _outcome(Si7021_TypeDef *si7021, HAL_StatusTypeDef status);
+static HAL_StatusTypeDef _readRegister8(Si7021_TypeDef *si7021, uint8_t reg, uint8_t *value);
+static HAL_StatusTypeDef _writeRegister8(Si7021_TypeDef *si7021, uint8_t reg, uint8_t value);
+static HAL_StatusTypeDef _readRevision(Si7021_TypeDef *si7021);
+static void _converted(Si7021_TypeDef *si7021, Si_ChannelTypeDef channel, uint16_t code);
+HAL_StatusTypeDef _readSerialNumber(Si7021_TypeDef *si7021);
 
 /*!
  * Static function definitions
  */
 
+/*!
+ * @brief Asks the breaker whether a transfer may go on the bus
+ * @param *si7021 Pointer to the handle of the target device
+ * @return 1 if it may; a half-open breaker is probed first and only passes
+ * if the device acknowledges its address
+ */
+static _Bool _available(Si7021_TypeDef *si7021) {
+	uint32_t now = HAL_GetTick();
+
+	if (!Breaker_Allow(&si7021->breaker, now))
+		return 0;
+	if (si7021->breaker.state == BREAKER_HALF_OPEN &&
+			HAL_I2C_IsDeviceReady(&(si7021->_hi2c), si7021->_i2caddr, 1, SI7021_PROBE_TIMEOUT_MS) != HAL_OK) {
+		Breaker_Failure(&si7021->breaker, now);
+		return 0;
+	}
+	return 1;
+}
+
+/*!
+ * @brief Reports the outcome of a transfer to the breaker
+ */
+static void _outcome(Si7021_TypeDef *si7021, HAL_StatusTypeDef status) {
+	if (status == HAL_OK)
+		Breaker_Success(&si7021->breaker);
+	else
+		Breaker_Failure(&si7021->breaker, HAL_GetTick());
+}
+
+/*!
+ * @brief Transmits to the device and records the transfer in the I2C trace
+ * @param *si7021 Pointer to the handle of the target device
+ * @param *data Bytes to send
+ * @param len Number of bytes to send
+ * @return HAL status of the transfer, HAL_ERROR at once while the breaker is open
+ */
+static HAL_StatusTypeDef _transmit(Si7021_TypeDef *si7021, uint8_t *data, uint16_t len) {
+	if (!_available(si7021))
+		return HAL_ERROR;
+#if I2C_TRACE_ENABLED
+	uint32_t start = Cycles_Now();
+#endif
+#if SI7021_REGISTER_I2C
+	HAL_StatusTypeDef status = I2CReg_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, data, len, _TRANSACTION_TIMEOUT);
+#else
+	HAL_StatusTypeDef status = HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, data, len, _TRANSACTION_TIMEOUT);
+#endif
+#if I2C_TRACE_ENABLED
+	I2CTrace_Record(si7021->_i2caddr, 0, len, status, si7021->_hi2c.ErrorCode, start);
+#endif
+	_outcome(si7021, status);
+	return status;
+}
+
+/*!
+ * @brief Receives from the device and records the transfer in the I2C trace
+ * @param *si7021 Pointer to the handle of the target device
+ * @param *data Buffer for the received bytes
+ * @param len Number of bytes to receive
+ * @return HAL status of the transfer, HAL_ERROR at once while the breaker is open
+ */
+static HAL_StatusTypeDef _receive(Si7021_TypeDef *si7021, uint8_t *data, uint16_t len) {
+	if (!_available(si7021))
+		return HAL_ERROR;
+#if I2C_TRACE_ENABLED
+	uint32_t start = Cycles_Now();
+#endif
+#if SI7021_REGISTER_I2C
+	HAL_StatusTypeDef status = I2CReg_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, data, len, _TRANSACTION_TIMEOUT);
+	si7021->_received = I2CReg_Received(&(si7021->_hi2c));
+#else
+	HAL_StatusTypeDef status = HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, data, len, _TRANSACTION_TIMEOUT);
+	si7021->_received = Cycles_Now();	/* the HAL returns on the STOP after the last byte */
+#endif
+#if I2C_TRACE_ENABLED
+	I2CTrace_Record(si7021->_i2caddr, 1, len, status, si7021->_hi2c.ErrorCode, start);
+#endif
+	_outcome(si7021, status);
+	return status;
+}
+
+/*!
+ * @brief Hands a fresh conversion code to the callback, if one is set
+ * @param *si7021 Pointer to the handle of the target device
+ * @param channel Channel the code belongs to
+ * @param code Raw 16-bit code as received
+ */
+static void _converted(Si7021_TypeDef *si7021, Si_ChannelTypeDef channel, uint16_t code) {
+	if (si7021->conversion) {
+		si7021->conversion(si7021, channel, code, si7021->_received);
+	}
+}
+
 /*!
  * @brief Reads 8 bits from the specified register
  * @param *si7021 Pointer to the handle of the target device
  * @param reg Register to be read
- * @return value Acquired data as uint8_t
+ * @param *value Acquired data
+ * @return HAL status of the first failed transfer, or HAL_OK
  */
-static uint8_t _readRegister8(Si7021_TypeDef *si7021, uint8_t reg) {
+static HAL_StatusTypeDef _readRegister8(Si7021_TypeDef *si7021, uint8_t reg, uint8_t *value) {
 	uint8_t cmd[] = {reg};
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 1, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
-	}
-
-	uint8_t value[] = {0};
-	if (HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, value, 1, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
+	HAL_StatusTypeDef status = _transmit(si7021, cmd, 1);
+	if (status != HAL_OK) {
+		return status;
 	}
 
-	return value[0];
+	return _receive(si7021, value, 1);
 }
 
 /*!
  * @brief Writes 8 bits to the specified register
  * @param si7021 Pointer to the handle of the target device
  * @param reg Register to be written
+ * @return HAL status of the transfer
  *
  * Note there is no bitmasking protection. It is currently left to the user to
  * first read the register, do any necessary masking, and apply that to the
  * byte to be written.
  */
-static void _writeRegister8(Si7021_TypeDef *si7021, uint8_t reg, uint8_t value) {
+static HAL_StatusTypeDef _writeRegister8(Si7021_TypeDef *si7021, uint8_t reg, uint8_t value) {
 	uint8_t cmd[] = {reg, value};
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 2, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
-	}
+	return _transmit(si7021, cmd, 2);
 }
 
 /*!
  * @brief Reads firmware revision from device and updates struct
  * @param si7021 Pointer to the handle of the target device
+ * @return HAL status of the first failed transfer, or HAL_OK
  */
-static void _readRevision(Si7021_TypeDef *si7021) {
+static HAL_StatusTypeDef _readRevision(Si7021_TypeDef *si7021) {
 	uint8_t cmd[] = {SI7021_FIRMVERS_CMD >> 8, SI7021_FIRMVERS_CMD & 0xFF};
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 2, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
+	HAL_StatusTypeDef status = _transmit(si7021, cmd, 2);
+	if (status != HAL_OK) {
+		return status;
 	}
 
 	uint8_t firmvers;
-	if (HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, &firmvers, 1, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
+	status = _receive(si7021, &firmvers, 1);
+	if (status != HAL_OK) {
+		return status;
 	}
 
 	switch (firmvers) {
@@ -90,54 +192,44 @@ static void _readRevision(Si7021_TypeDef *si7021) {
 	default:
 		si7021->_revision = 0;
 	}
+	return HAL_OK;
 }
 
 /*!
  * @brief Reads serial number and updates properties of target structure
  * @param *si7021 Pointer to the handle of the target device
+ * @return HAL status of the first failed transfer, or HAL_OK
  */
-void _readSerialNumber(Si7021_TypeDef *si7021) {
+HAL_StatusTypeDef _readSerialNumber(Si7021_TypeDef *si7021) {
 	uint8_t cmd[] = {SI7021_ID1_CMD >> 8, SI7021_ID1_CMD & 0xFF};
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 2, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
+	HAL_StatusTypeDef status = _transmit(si7021, cmd, 2);
+	if (status != HAL_OK) {
+		return status;
 	}
 
 	uint8_t sernum[8];
-	if (HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, sernum, 8, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
+	status = _receive(si7021, sernum, 8);
+	if (status != HAL_OK) {
+		return status;
 	}
 
 	si7021->sernum_a = (sernum[0]<<24 | sernum[1]<<16 | sernum[2]<<8 | sernum[3]);
 
 	cmd[0] = SI7021_ID2_CMD >> 8;
 	cmd[1] = SI7021_ID2_CMD & 0xFF;
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 2, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
+	status = _transmit(si7021, cmd, 2);
+	if (status != HAL_OK) {
+		return status;
 	}
 
-	if (HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, sernum, 8, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler(); // TODO: Handle gracefully
+	status = _receive(si7021, sernum, 8);
+	if (status != HAL_OK) {
+		return status;
 	}
 
 	si7021->sernum_b = (sernum[0]<<24 | sernum[1]<<16 | sernum[2]<<8 | sernum[3]);
-
-	switch(si7021->sernum_b >> 24) {
-	case 0:
-	case 0xFF:
-		si7021->_model = SI_Engineering_Samples;
-		break;
-	case 0x0D:
-		si7021->_model = SI_7013;
-		break;
-	case 0x14:
-		si7021->_model = SI_7020;
-		break;
-	case 0x15:
-		si7021->_model = SI_7021;
-		break;
-	default:
-		si7021->_model = SI_UNKNOWN;
-	}
+	si7021->_model = Si7021_ModelFromId(si7021->sernum_b >> 24);
+	return HAL_OK;
 }
 
 /*!
@@ -150,12 +242,14 @@ void _readSerialNumber(Si7021_TypeDef *si7021) {
  * @return Returns true if set up is successful
  */
 _Bool Si7021_Begin(Si7021_TypeDef *si7021) {
-	Si7021_Reset(si7021);
-	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD) != 0x3AU)
+	uint8_t usr_val;
+	if (!Si7021_Reset(si7021))
+		return 0;
+	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD, &usr_val) != HAL_OK || usr_val != 0x3AU)
 		return 0;
 
-	_readSerialNumber(si7021);
-	_readRevision(si7021);
+	if (_readSerialNumber(si7021) != HAL_OK || _readRevision(si7021) != HAL_OK)
+		return 0;
 
 	return 1;
 }
@@ -167,16 +261,19 @@ _Bool Si7021_Begin(Si7021_TypeDef *si7021) {
  * @return True if successful, otherwise false
  */
 _Bool Si7021_HeaterOn(Si7021_TypeDef *si7021, uint8_t level) {
-	uint8_t usr_val = _readRegister8(si7021, SI7021_READRHT_REG_CMD);
+	uint8_t usr_val, check;
+	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD, &usr_val) != HAL_OK) {
+		return 0;
+	}
 	usr_val |= SI7021_HTRE_MASK;
 
-	_writeRegister8(si7021, SI7021_WRITERHT_REG_CMD, usr_val);
-	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD) != usr_val) {
+	if (_writeRegister8(si7021, SI7021_WRITERHT_REG_CMD, usr_val) != HAL_OK ||
+			_readRegister8(si7021, SI7021_READRHT_REG_CMD, &check) != HAL_OK || check != usr_val) {
 		return 0;
 	}
 	level &= SI7021_HEATLVL_MASK; /** [7:4] are reserved bits in heater register **/
-	_writeRegister8(si7021, SI7021_WRITEHEATER_REG_CMD, level);
-	if (_readRegister8(si7021, SI7021_READHEATER_REG_CMD) != level) {
+	if (_writeRegister8(si7021, SI7021_WRITEHEATER_REG_CMD, level) != HAL_OK ||
+			_readRegister8(si7021, SI7021_READHEATER_REG_CMD, &check) != HAL_OK || check != level) {
 		return 0;
 	}
 
@@ -190,11 +287,14 @@ _Bool Si7021_HeaterOn(Si7021_TypeDef *si7021, uint8_t level) {
  * @return True if successful, otherwise false
  */
 _Bool Si7021_HeaterOff(Si7021_TypeDef *si7021) {
-	uint8_t usr_val = _readRegister8(si7021, SI7021_READRHT_REG_CMD);
+	uint8_t usr_val, check;
+	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD, &usr_val) != HAL_OK) {
+		return 0;
+	}
 	usr_val &= ~SI7021_HTRE_MASK;
 
-	_writeRegister8(si7021, SI7021_WRITERHT_REG_CMD, usr_val);
-	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD) != usr_val) {
+	if (_writeRegister8(si7021, SI7021_WRITERHT_REG_CMD, usr_val) != HAL_OK ||
+			_readRegister8(si7021, SI7021_READRHT_REG_CMD, &check) != HAL_OK || check != usr_val) {
 		return 0;
 	}
 
@@ -220,12 +320,15 @@ _Bool Si7021_HeaterOff(Si7021_TypeDef *si7021) {
  * |______________|__________|_______|_________|
  */
 _Bool Si7021_SetResolution(Si7021_TypeDef *si7021, Si_ResolutionTypeDef res) {
-	uint8_t usr_val = _readRegister8(si7021, SI7021_READRHT_REG_CMD);
+	uint8_t usr_val, check;
+	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD, &usr_val) != HAL_OK) {
+		return 0;
+	}
 	uint8_t resolution = ((res << 6) | res) & SI7021_RHT_RES_MASK; /**< move MSB to 7 and blank [6:1] **/
 	usr_val = resolution | (usr_val & ~SI7021_RHT_RES_MASK);
 
-	_writeRegister8(si7021, SI7021_WRITERHT_REG_CMD, usr_val);
-	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD) != usr_val) {
+	if (_writeRegister8(si7021, SI7021_WRITERHT_REG_CMD, usr_val) != HAL_OK ||
+			_readRegister8(si7021, SI7021_READRHT_REG_CMD, &check) != HAL_OK || check != usr_val) {
 		return 0;
 	}
 	si7021->_res = res;
@@ -240,24 +343,20 @@ _Bool Si7021_SetResolution(Si7021_TypeDef *si7021, Si_ResolutionTypeDef res) {
  */
 float Si7021_ReadHumidity(Si7021_TypeDef *si7021) {
 	uint8_t cmd[] = {SI7021_MEASRH_HOLD_CMD};
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 1, _TRANSACTION_TIMEOUT) != HAL_OK) {
+	if (_transmit(si7021, cmd, 1) != HAL_OK) {
 		return NAN;
 	}
 
 	uint8_t resp[3];
-	HAL_StatusTypeDef rxStatus = HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, resp, 3, _TRANSACTION_TIMEOUT);
+	HAL_StatusTypeDef rxStatus = _receive(si7021, resp, 3);
 	if(rxStatus != HAL_OK) {
 		return NAN;
 	}
 	uint16_t hum = resp[0] << 8 | resp[1];
 	// uint8_t chxsum = resp[2];
+	_converted(si7021, SI_HUMIDITY, hum);
 
-	float humidity = hum;
-	humidity *= 125;
-	humidity /= 65536;
-	humidity -= 6;
-
-	return humidity;
+	return Si7021_ConvertHumidity(hum);
 }
 
 /*!
@@ -270,22 +369,19 @@ float Si7021_ReadHumidity(Si7021_TypeDef *si7021) {
  */
 float Si7021_ReadPrevTemperature(Si7021_TypeDef *si7021) {
 	uint8_t cmd[] = {SI7021_READPREVTEMP_CMD};
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 1, _TRANSACTION_TIMEOUT) != HAL_OK) {
+	if (_transmit(si7021, cmd, 1) != HAL_OK) {
 		return NAN;
 	}
 
 	uint8_t resp[2];
-	HAL_StatusTypeDef rxStatus = HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, resp, 2, _TRANSACTION_TIMEOUT);
+	HAL_StatusTypeDef rxStatus = _receive(si7021, resp, 2);
 	if(rxStatus != HAL_OK) {
 		return NAN;
 	}
 	uint16_t temp = resp[0] << 8 | resp[1];
+	_converted(si7021, SI_TEMPERATURE, temp);
 
-	float temperature = temp;
-	temperature *= 175.72;
-	temperature /= 65536;
-	temperature -= 46.85;
-	return temperature;
+	return Si7021_ConvertTemperature(temp);
 }
 
 /*!
@@ -295,19 +391,60 @@ float Si7021_ReadPrevTemperature(Si7021_TypeDef *si7021) {
  */
 float Si7021_ReadTemperature(Si7021_TypeDef *si7021) {
 	uint8_t cmd[] = {SI7021_MEASTEMP_HOLD_CMD};
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, cmd, 1, _TRANSACTION_TIMEOUT) != HAL_OK) {
+	if (_transmit(si7021, cmd, 1) != HAL_OK) {
 		return NAN;
 	}
 
 	uint8_t resp[3];
-	HAL_StatusTypeDef rxStatus = HAL_I2C_Master_Receive(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, resp, 3, _TRANSACTION_TIMEOUT);
+	HAL_StatusTypeDef rxStatus = _receive(si7021, resp, 3);
 	if(rxStatus != HAL_OK) {
 		return NAN;
 	}
 	uint16_t temp = resp[0] << 8 | resp[1];
 	// uint8_t chxsum = resp[2];
+	_converted(si7021, SI_TEMPERATURE, temp);
+
+	return Si7021_ConvertTemperature(temp);
+}
 
-	float temperature = temp;
+/*!
+ * @brief Reads user register 1
+ * @param *si7021 Pointer to the handle of the target device
+ * @return Register contents, 0 if the link failed
+ *
+ * Single register read through the same path every configuration call
+ * uses. Mostly useful for probing and for timing a minimal round trip.
+ */
+uint8_t Si7021_ReadUserRegister(Si7021_TypeDef *si7021) {
+	uint8_t value = 0;
+	_readRegister8(si7021, SI7021_READRHT_REG_CMD, &value);
+	return value;
+}
+
+/*!
+ * @brief Converts a raw RH code to relative humidity
+ * @param code 16-bit code as returned by the sensor
+ * @return humidity Relative humidity in %
+ *
+ * 125/65536 is exact in single precision and code * 125 stays below 2^24,
+ * so the single multiply-add gives the same bits as the datasheet sequence
+ * (multiply by 125, divide by 65536, subtract 6). Sim/Src/bench_kernels.c
+ * checks this over the full code range.
+ */
+float Si7021_ConvertHumidity(uint16_t code) {
+	return (float)code * (125.0f / 65536.0f) - 6.0f;
+}
+
+/*!
+ * @brief Converts a raw temperature code to degrees Celsius
+ * @param code 16-bit code as returned by the sensor
+ * @return temperature Temperature in C
+ *
+ * The intermediate steps use double constants, as they always have; the
+ * rounding of those steps is part of the reference output.
+ */
+float Si7021_ConvertTemperature(uint16_t code) {
+	float temperature = code;
 	temperature *= 175.72;
 	temperature /= 65536;
 	temperature -= 46.85;
@@ -323,6 +460,27 @@ Si_SensorTypeDef Si7021_GetModel(Si7021_TypeDef *si7021) {
 	return si7021->_model;
 }
 
+/*!
+ * @brief Tells the Si70xx variant from its electronic ID
+ * @param snb3 SNB_3, the first byte returned for the ID 2 command
+ * @return Model typedef
+ */
+Si_SensorTypeDef Si7021_ModelFromId(uint8_t snb3) {
+	switch (snb3) {
+	case 0:
+	case 0xFF:
+		return SI_Engineering_Samples;
+	case 0x0D:
+		return SI_7013;
+	case 0x14:
+		return SI_7020;
+	case 0x15:
+		return SI_7021;
+	default:
+		return SI_UNKNOWN;
+	}
+}
+
 /*!
  * @brief Provides the caller with the conversion resolution configuration
  * @param *si7021 Pointer to the handle of the target device
@@ -348,6 +506,7 @@ uint8_t Si7021_GetRevision(Si7021_TypeDef *si7021) {
  *
  * status bit 4 is enable status -- 0:off, 1:on
  * status bits [3:0] represent heater level 0-15, lowest-highest
+ * If the link fails, bit 4 is the last state set and the level reads 0.
  *
  * @example
  * Enable/disable status = status >> 4
@@ -355,11 +514,16 @@ uint8_t Si7021_GetRevision(Si7021_TypeDef *si7021) {
  */
 uint8_t Si7021_HeaterStatus(Si7021_TypeDef *si7021) {
 	uint8_t status = 0x00;
-	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD) & SI7021_HTRE_MASK) {
-		status |= (1U << 4); /** heater enabled **/
+	uint8_t usr_val, level;
+	if (_readRegister8(si7021, SI7021_READRHT_REG_CMD, &usr_val) != HAL_OK ||
+			_readRegister8(si7021, SI7021_READHEATER_REG_CMD, &level) != HAL_OK) {
+		return si7021->heater ? (1U << 4) : 0x00;
 	}
 
-	status |= (_readRegister8(si7021, SI7021_READHEATER_REG_CMD) & SI7021_HEATLVL_MASK);
+	if (usr_val & SI7021_HTRE_MASK) {
+		status |= (1U << 4); /** heater enabled **/
+	}
+	status |= (level & SI7021_HEATLVL_MASK);
 
 	return status;
 }
@@ -379,19 +543,31 @@ void Si7021_Init(Si7021_TypeDef *si7021, I2C_HandleTypeDef *hi2c, uint8_t i2cadd
 	si7021->_i2caddr = i2caddr << 1; /**< 7b address as MSB **/
 	si7021->sernum_a = 0;
 	si7021->sernum_b = 0;
-	// TODO: add address as param
+	si7021->conversion = 0;
+	Breaker_Init(&si7021->breaker);
 }
 
 /*!
  * @brief Sends the reset command to Si7021
  * @param *si7021 Pointer to the handle of the target device
+ * @return True if the device took the command
  */
-void Si7021_Reset(Si7021_TypeDef *si7021) {
+_Bool Si7021_Reset(Si7021_TypeDef *si7021) {
 	uint8_t cmd = SI7021_RESET_CMD;
-	if (HAL_I2C_Master_Transmit(&(si7021->_hi2c), (uint16_t)si7021->_i2caddr, &cmd, 1, _TRANSACTION_TIMEOUT) != HAL_OK) {
-		Error_Handler();
+	if (_transmit(si7021, &cmd, 1) != HAL_OK) {
+		return 0;
 	}
 	HAL_Delay(50);
+	return 1;
+}
+
+/*!
+ * @brief Sets the hook run on every conversion result, NULL to remove it
+ * @param *si7021 Pointer to the handle of the target device
+ * @param callback Function to call; keep it short, it runs in the read path
+ */
+void Si7021_SetConversionCallback(Si7021_TypeDef *si7021, Si_ConversionCallbackTypeDef callback) {
+	si7021->conversion = callback;
 }
 
 /*! End of file si7021.c **/
@@ -0,0 +1,368 @@
+/*!
+ * @file tsdb.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Compressed time-series store. See tsdb.h for the record format.
+ *
+ * Space rule: a pending run always fits in the head block. A change record
+ * is only written while TSDB_RUN_BITS + TSDB_CHANGE_BITS are free, so after
+ * it at least TSDB_RUN_BITS remain for the run that may follow; otherwise
+ * the run is flushed and the sample opens a new block.
+ */
+
+#include "tsdb.h"
+
+/*!
+ * Static function definitions
+ */
+
+/*!
+ * @brief Quantizes a value, holding the previous step while within hysteresis
+ */
+static int16_t _quantize(int16_t value, int16_t previous) {
+	if (value == SAMPLE_INVALID)
+		return SAMPLE_INVALID;
+	int32_t v = value;
+	if (previous != SAMPLE_INVALID) {
+		int32_t error = v - (int32_t)previous * TSDB_QUANTUM;
+		if (error >= -TSDB_HYSTERESIS && error <= TSDB_HYSTERESIS)
+			return previous;
+	}
+	v += (v >= 0) ? TSDB_QUANTUM / 2 : -(TSDB_QUANTUM / 2);
+	return (int16_t)(v / TSDB_QUANTUM);
+}
+
+static int16_t _dequantize(int16_t value) {
+	if (value == SAMPLE_INVALID)
+		return SAMPLE_INVALID;
+	return (int16_t)(value * TSDB_QUANTUM);
+}
+
+static uint32_t _zigzag(int32_t v) {
+	return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t _unzigzag(uint32_t v) {
+	return (int32_t)(v >> 1) ^ -(int32_t)(v & 1U);
+}
+
+static Tsdb_BlockTypeDef *_head(Tsdb_TypeDef *db) {
+	return &db->block[(db->next - 1U) % db->capacity];
+}
+
+static uint32_t _free(const Tsdb_BlockTypeDef *b) {
+	return TSDB_PAYLOAD_BITS - b->bits;
+}
+
+/*!
+ * @brief Appends the low n bits of value, most significant first (n <= 32)
+ *
+ * Bytes are cleared as they are first touched, so a recycled block needs no
+ * memset.
+ */
+static void _put(Tsdb_BlockTypeDef *b, uint32_t value, uint32_t n) {
+	uint32_t pos = b->bits;
+	while (n) {
+		uint32_t room = 8U - (pos & 7U);
+		uint32_t take = (n < room) ? n : room;
+		uint8_t chunk = (uint8_t)((value >> (n - take)) & ((1U << take) - 1U));
+		uint8_t *p = &b->payload[pos >> 3];
+		*p = (uint8_t)(((room == 8U) ? 0U : *p) | (chunk << (room - take)));
+		pos += take;
+		n -= take;
+	}
+	b->bits = (uint16_t)pos;
+}
+
+static uint32_t _get(const Tsdb_BlockTypeDef *b, uint32_t *pos, uint32_t n) {
+	uint32_t value = 0;
+	while (n) {
+		uint32_t room = 8U - (*pos & 7U);
+		uint32_t take = (n < room) ? n : room;
+		uint32_t chunk = (b->payload[*pos >> 3] >> (room - take)) & ((1U << take) - 1U);
+		value = (value << take) | chunk;
+		*pos += take;
+		n -= take;
+	}
+	return value;
+}
+
+/*!
+ * @brief Counts leading one bits, stopping at a zero or after max
+ */
+static uint32_t _prefix(const Tsdb_BlockTypeDef *b, uint32_t *pos, uint32_t max) {
+	uint32_t ones = 0;
+	while (ones < max && _get(b, pos, 1))
+		ones++;
+	return ones;
+}
+
+static void _flushRun(Tsdb_TypeDef *db, Tsdb_BlockTypeDef *b) {
+	uint32_t n = db->run;
+	if (!n)
+		return;
+	uint32_t width = 31U - (uint32_t)__builtin_clz(n);
+	_put(b, 0, 1U + width);			/* run tag, then gamma zeros */
+	_put(b, n, width + 1U);
+	db->run = 0;
+}
+
+static void _putValue(Tsdb_BlockTypeDef *b, int32_t delta) {
+	uint32_t zz = _zigzag(delta);
+	if (zz == 0)
+		_put(b, 0x0, 1);
+	else if (zz <= 4U)
+		_put(b, (0x2U << 2) | (zz - 1U), 4);
+	else if (zz < (1U << 5))
+		_put(b, (0x6U << 5) | zz, 8);
+	else if (zz < (1U << 9))
+		_put(b, (0xEU << 9) | zz, 13);
+	else {
+		_put(b, 0xF, 4);
+		_put(b, zz, 17);
+	}
+}
+
+static int32_t _getValue(const Tsdb_BlockTypeDef *b, uint32_t *pos) {
+	switch (_prefix(b, pos, 4)) {
+	case 0: return 0;
+	case 1: return _unzigzag(_get(b, pos, 2) + 1U);
+	case 2: return _unzigzag(_get(b, pos, 5));
+	case 3: return _unzigzag(_get(b, pos, 9));
+	default: return _unzigzag(_get(b, pos, 17));
+	}
+}
+
+static void _putChange(Tsdb_TypeDef *db, Tsdb_BlockTypeDef *b, uint32_t delta, int16_t h, int16_t t) {
+	int32_t dod = (int32_t)(delta - db->delta);
+	uint32_t zz = _zigzag(dod);
+
+	_put(b, 1, 1);
+	if (dod == 0)
+		_put(b, 0x0, 1);
+	else if (zz < (1U << 7))
+		_put(b, (0x2U << 7) | zz, 9);
+	else if (zz < (1U << 14))
+		_put(b, (0x6U << 14) | zz, 17);
+	else {
+		_put(b, 0x7, 3);
+		_put(b, delta, 32);
+	}
+	_putValue(b, (int32_t)h - db->humidity);
+	_putValue(b, (int32_t)t - db->temperature);
+}
+
+/*!
+ * @brief Starts a new head block with one sample, recycling the oldest if full
+ */
+static void _open(Tsdb_TypeDef *db, uint32_t time, int16_t h, int16_t t) {
+	if (db->next - db->first == db->capacity) {
+		Tsdb_BlockTypeDef *old = &db->block[db->first % db->capacity];
+		db->dropped += old->count;
+		db->count -= old->count;
+		db->first++;
+	}
+
+	Tsdb_BlockTypeDef *b = &db->block[db->next % db->capacity];
+	db->next++;
+	b->time = time;
+	b->count = 1;
+	b->humidity = h;
+	b->temperature = t;
+	b->bits = 0;
+
+	db->count++;
+	db->run = 0;
+	db->delta = 0;
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Attaches block storage to a store and empties it
+ * @param *db Pointer to the store
+ * @param *storage Array of capacity blocks
+ * @param capacity Number of blocks, at least 2
+ */
+void Tsdb_Init(Tsdb_TypeDef *db, Tsdb_BlockTypeDef *storage, uint32_t capacity) {
+	db->block = storage;
+	db->capacity = capacity;
+	db->first = 0;
+	db->next = 0;
+	db->count = 0;
+	db->dropped = 0;
+	db->run = 0;
+	db->time = 0;
+	db->delta = 0;
+	db->humidity = 0;
+	db->temperature = 0;
+}
+
+/*!
+ * @brief Appends a sample
+ * @param *db Pointer to the store
+ * @param *sample Pointer to the sample; its time must be after the last one
+ * @return True if stored, false if the sample was not newer
+ */
+_Bool Tsdb_Append(Tsdb_TypeDef *db, const Sample_TypeDef *sample) {
+	_Bool empty = db->next == db->first;
+	int16_t h = _quantize(sample->humidity, empty ? SAMPLE_INVALID : db->humidity);
+	int16_t t = _quantize(sample->temperature, empty ? SAMPLE_INVALID : db->temperature);
+	uint32_t time = sample->time;
+
+	if (empty) {
+		_open(db, time, h, t);
+	}
+	else {
+		if ((int32_t)(time - db->time) <= 0)
+			return 0;
+
+		Tsdb_BlockTypeDef *b = _head(db);
+		uint32_t delta = time - db->time;
+		_Bool same = delta == db->delta && h == db->humidity && t == db->temperature;
+
+		if (same && db->run == TSDB_RUN_MAX)
+			_flushRun(db, b);
+
+		if (same ? (db->run || _free(b) >= TSDB_RUN_BITS) : _free(b) >= TSDB_RUN_BITS + TSDB_CHANGE_BITS) {
+			if (same) {
+				db->run++;
+			}
+			else {
+				_flushRun(db, b);
+				_putChange(db, b, delta, h, t);
+				db->delta = delta;
+			}
+			b->count++;
+			db->count++;
+		}
+		else {
+			_flushRun(db, b);
+			_open(db, time, h, t);
+		}
+	}
+
+	db->time = time;
+	db->humidity = h;
+	db->temperature = t;
+	return 1;
+}
+
+/*!
+ * @brief Positions a cursor on the oldest sample
+ */
+void Tsdb_Begin(const Tsdb_TypeDef *db, Tsdb_CursorTypeDef *cursor) {
+	cursor->db = db;
+	cursor->seq = db->first;
+	cursor->bit = 0;
+	cursor->run = 0;
+	cursor->taken = 0;
+	cursor->state = 0;
+}
+
+/*!
+ * @brief Decodes the next sample, oldest first
+ *
+ * At the end of the head block the cursor also returns the store's pending
+ * run and remembers how much of it it took, so when that run is later
+ * written out those samples are not returned twice.
+ *
+ * @param *cursor Pointer to a cursor set up by Tsdb_Begin
+ * @param *sample Receives the sample, values in 0.01 units
+ * @return True if a sample was returned, false if there is nothing newer yet
+ */
+_Bool Tsdb_Next(Tsdb_CursorTypeDef *cursor, Sample_TypeDef *sample) {
+	const Tsdb_TypeDef *db = cursor->db;
+
+	for (;;) {
+		if ((int32_t)(cursor->seq - db->first) < 0) {
+			cursor->seq = db->first;
+			cursor->taken = 0;
+			cursor->state = 0;
+		}
+		if (cursor->seq == db->next)
+			return 0;
+
+		const Tsdb_BlockTypeDef *b = &db->block[cursor->seq % db->capacity];
+
+		if (cursor->state == 0) {
+			cursor->time = b->time;
+			cursor->humidity = b->humidity;
+			cursor->temperature = b->temperature;
+			cursor->delta = 0;
+			cursor->bit = 0;
+			cursor->run = 0;
+			cursor->state = 1;
+			break;
+		}
+		if (cursor->run) {
+			cursor->run--;
+			cursor->time += cursor->delta;
+			break;
+		}
+		if (cursor->bit < b->bits) {
+			if (_get(b, &cursor->bit, 1) == 0) {
+				uint32_t width = 0;
+				while (_get(b, &cursor->bit, 1) == 0)
+					width++;
+				cursor->run = ((1U << width) | _get(b, &cursor->bit, width)) - cursor->taken;
+				cursor->taken = 0;
+				continue;
+			}
+
+			switch (_prefix(b, &cursor->bit, 3)) {
+			case 0: break;
+			case 1: cursor->delta += (uint32_t)_unzigzag(_get(b, &cursor->bit, 7)); break;
+			case 2: cursor->delta += (uint32_t)_unzigzag(_get(b, &cursor->bit, 14)); break;
+			default: cursor->delta = _get(b, &cursor->bit, 32); break;
+			}
+			cursor->time += cursor->delta;
+			cursor->humidity = (int16_t)(cursor->humidity + _getValue(b, &cursor->bit));
+			cursor->temperature = (int16_t)(cursor->temperature + _getValue(b, &cursor->bit));
+			break;
+		}
+		if (cursor->seq == db->next - 1U) {
+			/* The head block's pending run lives in the store, not the stream */
+			if (db->run <= cursor->taken)
+				return 0;
+			cursor->run = db->run - cursor->taken;
+			cursor->taken = db->run;
+			continue;
+		}
+		cursor->seq++;
+		cursor->taken = 0;
+		cursor->state = 0;
+	}
+
+	sample->time = cursor->time;
+	sample->humidity = _dequantize(cursor->humidity);
+	sample->temperature = _dequantize(cursor->temperature);
+	sample->humidityStatus = 0;
+	sample->temperatureStatus = 0;
+	return 1;
+}
+
+/*!
+ * @brief Number of samples held
+ */
+uint32_t Tsdb_Count(const Tsdb_TypeDef *db) {
+	return db->count;
+}
+
+/*!
+ * @brief Bytes of block storage in use, headers included
+ */
+uint32_t Tsdb_Bytes(const Tsdb_TypeDef *db) {
+	uint32_t bytes = 0;
+	for (uint32_t seq = db->first; seq != db->next; seq++) {
+		bytes += TSDB_HEADER_BYTES + (db->block[seq % db->capacity].bits + 7U) / 8U;
+	}
+	return bytes;
+}
+
+/*! End of file tsdb.c **/
@@ -0,0 +1,105 @@
+/*!
+ * @file window.c
+ * @author Paul Czeresko <p.czeresko.3@gmail.com>
+ * @date 18 October 2026
+ *
+ * @section Description
+ *
+ * Windowed aggregate for the summary report. See window.h.
+ */
+
+#include "window.h"
+
+/*!
+ * Static function definitions
+ */
+
+static void _clear(Window_StatTypeDef *s) {
+	s->count = 0;
+	s->min = INT16_MAX;
+	s->max = INT16_MIN;
+	s->mean = 0.0f;
+	s->m2 = 0.0f;
+}
+
+static void _add(Window_StatTypeDef *s, int16_t value) {
+	if (value == SAMPLE_INVALID)
+		return;
+	s->count++;
+	if (value < s->min)
+		s->min = value;
+	if (value > s->max)
+		s->max = value;
+
+	float delta = value - s->mean;
+	s->mean += delta / s->count;
+	s->m2 += delta * (value - s->mean);
+}
+
+static void _open(Window_TypeDef *w, uint32_t time) {
+	w->open = 1;
+	w->current.start = time - time % w->current.seconds;
+	_clear(&w->current.humidity);
+	_clear(&w->current.temperature);
+}
+
+/*!
+ * Instance function definitions
+ */
+
+/*!
+ * @brief Sets the window length; the next sample opens a fresh window
+ * @param *w Pointer to the aggregator
+ * @param seconds Window length, 0 to disable
+ */
+void Window_Init(Window_TypeDef *w, uint32_t seconds) {
+	w->open = 0;
+	w->current.seconds = seconds;
+}
+
+/*!
+ * @brief Adds a sample, closing the current window if the sample is past it
+ * @param *w Pointer to the aggregator
+ * @param *sample Pointer to the sample; invalid channels are skipped
+ * @param *closed Receives the closed window's summary
+ * @return True if a window was closed
+ */
+_Bool Window_Add(Window_TypeDef *w, const Sample_TypeDef *sample, Window_SummaryTypeDef *closed) {
+	_Bool done = 0;
+
+	if (!w->current.seconds)
+		return 0;
+	if (w->open && sample->time - w->current.start >= w->current.seconds) {
+		*closed = w->current;
+		done = 1;
+		w->open = 0;
+	}
+	if (!w->open)
+		_open(w, sample->time);
+
+	_add(&w->current.humidity, sample->humidity);
+	_add(&w->current.temperature, sample->temperature);
+	return done;
+}
+
+/*!
+ * @brief Mean of a channel aggregate
+ * @return Mean in %RH or C, NAN if the aggregate is empty
+ */
+float Window_Mean(const Window_StatTypeDef *stat) {
+	if (!stat->count)
+		return NAN;
+	return stat->mean / 100.0f;
+}
+
+/*!
+ * @brief Sample standard deviation of a channel aggregate
+ * @return Standard deviation in %RH or C, NAN if fewer than two samples
+ */
+float Window_StdDev(const Window_StatTypeDef *stat) {
+	if (stat->count < 2U)
+		return NAN;
+	return sqrtf(stat->m2 / (stat->count - 1U)) / 100.0f;
+}
+
+/*! End of file window.c **/